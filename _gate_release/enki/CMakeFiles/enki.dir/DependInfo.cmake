@@ -0,0 +1,41 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/enki/BluetoothBase.cpp" "enki/CMakeFiles/enki.dir/BluetoothBase.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/BluetoothBase.cpp.o.d"
+  "/root/repo/enki/Geometry.cpp" "enki/CMakeFiles/enki.dir/Geometry.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/Geometry.cpp.o.d"
+  "/root/repo/enki/GroundMap.cpp" "enki/CMakeFiles/enki.dir/GroundMap.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/GroundMap.cpp.o.d"
+  "/root/repo/enki/PhysicalEngine.cpp" "enki/CMakeFiles/enki.dir/PhysicalEngine.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/PhysicalEngine.cpp.o.d"
+  "/root/repo/enki/Random.cpp" "enki/CMakeFiles/enki.dir/Random.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/Random.cpp.o.d"
+  "/root/repo/enki/SpatialGrid.cpp" "enki/CMakeFiles/enki.dir/SpatialGrid.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/SpatialGrid.cpp.o.d"
+  "/root/repo/enki/StaticScene.cpp" "enki/CMakeFiles/enki.dir/StaticScene.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/StaticScene.cpp.o.d"
+  "/root/repo/enki/Types.cpp" "enki/CMakeFiles/enki.dir/Types.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/Types.cpp.o.d"
+  "/root/repo/enki/UniformGrid.cpp" "enki/CMakeFiles/enki.dir/UniformGrid.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/UniformGrid.cpp.o.d"
+  "/root/repo/enki/WorldBatch.cpp" "enki/CMakeFiles/enki.dir/WorldBatch.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/WorldBatch.cpp.o.d"
+  "/root/repo/enki/interactions/ActiveSoundSource.cpp" "enki/CMakeFiles/enki.dir/interactions/ActiveSoundSource.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/interactions/ActiveSoundSource.cpp.o.d"
+  "/root/repo/enki/interactions/Bluetooth.cpp" "enki/CMakeFiles/enki.dir/interactions/Bluetooth.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/interactions/Bluetooth.cpp.o.d"
+  "/root/repo/enki/interactions/CircularCam.cpp" "enki/CMakeFiles/enki.dir/interactions/CircularCam.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/interactions/CircularCam.cpp.o.d"
+  "/root/repo/enki/interactions/GroundSensor.cpp" "enki/CMakeFiles/enki.dir/interactions/GroundSensor.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/interactions/GroundSensor.cpp.o.d"
+  "/root/repo/enki/interactions/IRSensor.cpp" "enki/CMakeFiles/enki.dir/interactions/IRSensor.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/interactions/IRSensor.cpp.o.d"
+  "/root/repo/enki/interactions/Microphone.cpp" "enki/CMakeFiles/enki.dir/interactions/Microphone.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/interactions/Microphone.cpp.o.d"
+  "/root/repo/enki/robots/DifferentialWheeled.cpp" "enki/CMakeFiles/enki.dir/robots/DifferentialWheeled.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/robots/DifferentialWheeled.cpp.o.d"
+  "/root/repo/enki/robots/e-puck/EPuck.cpp" "enki/CMakeFiles/enki.dir/robots/e-puck/EPuck.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/robots/e-puck/EPuck.cpp.o.d"
+  "/root/repo/enki/robots/khepera/Khepera.cpp" "enki/CMakeFiles/enki.dir/robots/khepera/Khepera.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/robots/khepera/Khepera.cpp.o.d"
+  "/root/repo/enki/robots/marxbot/Marxbot.cpp" "enki/CMakeFiles/enki.dir/robots/marxbot/Marxbot.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/robots/marxbot/Marxbot.cpp.o.d"
+  "/root/repo/enki/robots/s-bot/Sbot.cpp" "enki/CMakeFiles/enki.dir/robots/s-bot/Sbot.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/robots/s-bot/Sbot.cpp.o.d"
+  "/root/repo/enki/robots/s-bot/SbotObject.cpp" "enki/CMakeFiles/enki.dir/robots/s-bot/SbotObject.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/robots/s-bot/SbotObject.cpp.o.d"
+  "/root/repo/enki/robots/thymio2/Thymio2.cpp" "enki/CMakeFiles/enki.dir/robots/thymio2/Thymio2.cpp.o" "gcc" "enki/CMakeFiles/enki.dir/robots/thymio2/Thymio2.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,55 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/enki.dir/BluetoothBase.cpp.o"
+  "CMakeFiles/enki.dir/BluetoothBase.cpp.o.d"
+  "CMakeFiles/enki.dir/Geometry.cpp.o"
+  "CMakeFiles/enki.dir/Geometry.cpp.o.d"
+  "CMakeFiles/enki.dir/GroundMap.cpp.o"
+  "CMakeFiles/enki.dir/GroundMap.cpp.o.d"
+  "CMakeFiles/enki.dir/PhysicalEngine.cpp.o"
+  "CMakeFiles/enki.dir/PhysicalEngine.cpp.o.d"
+  "CMakeFiles/enki.dir/Random.cpp.o"
+  "CMakeFiles/enki.dir/Random.cpp.o.d"
+  "CMakeFiles/enki.dir/SpatialGrid.cpp.o"
+  "CMakeFiles/enki.dir/SpatialGrid.cpp.o.d"
+  "CMakeFiles/enki.dir/StaticScene.cpp.o"
+  "CMakeFiles/enki.dir/StaticScene.cpp.o.d"
+  "CMakeFiles/enki.dir/Types.cpp.o"
+  "CMakeFiles/enki.dir/Types.cpp.o.d"
+  "CMakeFiles/enki.dir/UniformGrid.cpp.o"
+  "CMakeFiles/enki.dir/UniformGrid.cpp.o.d"
+  "CMakeFiles/enki.dir/WorldBatch.cpp.o"
+  "CMakeFiles/enki.dir/WorldBatch.cpp.o.d"
+  "CMakeFiles/enki.dir/interactions/ActiveSoundSource.cpp.o"
+  "CMakeFiles/enki.dir/interactions/ActiveSoundSource.cpp.o.d"
+  "CMakeFiles/enki.dir/interactions/Bluetooth.cpp.o"
+  "CMakeFiles/enki.dir/interactions/Bluetooth.cpp.o.d"
+  "CMakeFiles/enki.dir/interactions/CircularCam.cpp.o"
+  "CMakeFiles/enki.dir/interactions/CircularCam.cpp.o.d"
+  "CMakeFiles/enki.dir/interactions/GroundSensor.cpp.o"
+  "CMakeFiles/enki.dir/interactions/GroundSensor.cpp.o.d"
+  "CMakeFiles/enki.dir/interactions/IRSensor.cpp.o"
+  "CMakeFiles/enki.dir/interactions/IRSensor.cpp.o.d"
+  "CMakeFiles/enki.dir/interactions/Microphone.cpp.o"
+  "CMakeFiles/enki.dir/interactions/Microphone.cpp.o.d"
+  "CMakeFiles/enki.dir/robots/DifferentialWheeled.cpp.o"
+  "CMakeFiles/enki.dir/robots/DifferentialWheeled.cpp.o.d"
+  "CMakeFiles/enki.dir/robots/e-puck/EPuck.cpp.o"
+  "CMakeFiles/enki.dir/robots/e-puck/EPuck.cpp.o.d"
+  "CMakeFiles/enki.dir/robots/khepera/Khepera.cpp.o"
+  "CMakeFiles/enki.dir/robots/khepera/Khepera.cpp.o.d"
+  "CMakeFiles/enki.dir/robots/marxbot/Marxbot.cpp.o"
+  "CMakeFiles/enki.dir/robots/marxbot/Marxbot.cpp.o.d"
+  "CMakeFiles/enki.dir/robots/s-bot/Sbot.cpp.o"
+  "CMakeFiles/enki.dir/robots/s-bot/Sbot.cpp.o.d"
+  "CMakeFiles/enki.dir/robots/s-bot/SbotObject.cpp.o"
+  "CMakeFiles/enki.dir/robots/s-bot/SbotObject.cpp.o.d"
+  "CMakeFiles/enki.dir/robots/thymio2/Thymio2.cpp.o"
+  "CMakeFiles/enki.dir/robots/thymio2/Thymio2.cpp.o.d"
+  "libenki.a"
+  "libenki.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/enki.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/enkiMinimal.dir/enkiMinimal.cpp.o"
+  "CMakeFiles/enkiMinimal.dir/enkiMinimal.cpp.o.d"
+  "enkiMinimal"
+  "enkiMinimal.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/enkiMinimal.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
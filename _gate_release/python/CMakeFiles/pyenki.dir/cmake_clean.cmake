@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pyenki.dir/enki.cpp.o"
+  "CMakeFiles/pyenki.dir/enki.cpp.o.d"
+  "pyenki.pdb"
+  "pyenki.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pyenki.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/benchIRSensor.dir/benchIRSensor.cpp.o"
+  "CMakeFiles/benchIRSensor.dir/benchIRSensor.cpp.o.d"
+  "benchIRSensor"
+  "benchIRSensor.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/benchIRSensor.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testCircularCam.dir/testCircularCam.cpp.o"
+  "CMakeFiles/testCircularCam.dir/testCircularCam.cpp.o.d"
+  "testCircularCam"
+  "testCircularCam.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testCircularCam.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testGeometry.dir/testGeometry.cpp.o"
+  "CMakeFiles/testGeometry.dir/testGeometry.cpp.o.d"
+  "testGeometry"
+  "testGeometry.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testGeometry.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
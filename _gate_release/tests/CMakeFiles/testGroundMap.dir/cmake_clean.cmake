@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testGroundMap.dir/testGroundMap.cpp.o"
+  "CMakeFiles/testGroundMap.dir/testGroundMap.cpp.o.d"
+  "testGroundMap"
+  "testGroundMap.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testGroundMap.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testIRSensor.dir/testIRSensor.cpp.o"
+  "CMakeFiles/testIRSensor.dir/testIRSensor.cpp.o.d"
+  "testIRSensor"
+  "testIRSensor.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testIRSensor.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
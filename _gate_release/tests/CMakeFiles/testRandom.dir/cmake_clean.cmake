@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testRandom.dir/testRandom.cpp.o"
+  "CMakeFiles/testRandom.dir/testRandom.cpp.o.d"
+  "testRandom"
+  "testRandom.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testRandom.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testResponseTable.dir/testResponseTable.cpp.o"
+  "CMakeFiles/testResponseTable.dir/testResponseTable.cpp.o.d"
+  "testResponseTable"
+  "testResponseTable.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testResponseTable.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testWorld.dir/testWorld.cpp.o"
+  "CMakeFiles/testWorld.dir/testWorld.cpp.o.d"
+  "testWorld"
+  "testWorld.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testWorld.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
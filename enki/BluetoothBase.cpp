@@ -36,6 +36,7 @@
 
 #include <limits.h>
 #include <assert.h>
+#include <iterator>
 
 /*!	\file BluetoothBase.cpp
 	\brief Implementation of the bluetooth base
@@ -303,5 +304,78 @@ namespace Enki
 			transmissions.pop();
 		}
 	}
+	
+	void BluetoothBase::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(clients.size());
+		for (std::list<BtClients>::const_iterator it=clients.begin(); it!=clients.end(); ++it)
+			snapshot.writeValue(*it);
+		snapshot.writeQueue(connectbuffer);
+		snapshot.writeQueue(disconnectbuffer);
+		
+		// the data of a transmission lies in a transmission buffer of its source, so it is written as an offset into this buffer
+		std::queue<Transmissions> remaining(transmissions);
+		snapshot.writeValue(remaining.size());
+		for (; !remaining.empty(); remaining.pop())
+		{
+			const Transmissions& tx(remaining.front());
+			unsigned sourceIndex(0);
+			std::list<BtClients>::const_iterator it;
+			for (it=clients.begin(); it!=clients.end() && (*it).owner!=tx.source; ++it)
+				++sourceIndex;
+			unsigned connection(0);
+			while (connection<tx.source->maxConnections && !(tx.data>=tx.source->txBuffer[connection] && tx.data<tx.source->txBuffer[connection]+tx.source->txBufferSize))
+				++connection;
+			assert(it!=clients.end() && connection<tx.source->maxConnections);
+			snapshot.writeValue(sourceIndex);
+			snapshot.writeValue(tx.address);
+			snapshot.writeValue(connection);
+			snapshot.writeValue(unsigned(tx.data-tx.source->txBuffer[connection]));
+			snapshot.writeValue(tx.size);
+		}
+	}
+	
+	void BluetoothBase::restoreState(Snapshot& snapshot)
+	{
+		size_t clientCount(0);
+		snapshot.readValue(clientCount);
+		if (!snapshot.good())
+			return;
+		clients.resize(clientCount);
+		for (std::list<BtClients>::iterator it=clients.begin(); it!=clients.end(); ++it)
+			snapshot.readValue(*it);
+		snapshot.readQueue(connectbuffer);
+		snapshot.readQueue(disconnectbuffer);
+		
+		// point the data of transmissions into the current buffers of their sources
+		transmissions = std::queue<Transmissions>();
+		size_t transmissionCount(0);
+		snapshot.readValue(transmissionCount);
+		for (size_t i=0; i<transmissionCount && snapshot.good(); ++i)
+		{
+			unsigned sourceIndex(0), connection(0), offset(0);
+			Transmissions tx;
+			snapshot.readValue(sourceIndex);
+			snapshot.readValue(tx.address);
+			snapshot.readValue(connection);
+			snapshot.readValue(offset);
+			snapshot.readValue(tx.size);
+			if (!snapshot.good() || sourceIndex>=clients.size())
+			{
+				snapshot.fail();
+				return;
+			}
+			std::list<BtClients>::const_iterator it(clients.begin());
+			std::advance(it, sourceIndex);
+			tx.source = (*it).owner;
+			if (connection>=tx.source->maxConnections || offset+tx.size>tx.source->txBufferSize)
+			{
+				snapshot.fail();
+				return;
+			}
+			tx.data = tx.source->txBuffer[connection]+offset;
+			transmissions.push(tx);
+		}
+	}
 
 }
@@ -35,6 +35,7 @@
 #define __ENKI_BLUETOOTHBASE_H
 
 #include "PhysicalEngine.h"
+#include "Snapshot.h"
 
 #include <valarray>
 #include <list>
@@ -141,6 +142,11 @@ namespace Enki
 		
 		//! Execute the previously scheduled operations.
 		virtual void step(double dt, World *w);
+		
+		//! Write the registered modules and the scheduled operations, see World::snapshot()
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot);
 	};
 
 }
@@ -0,0 +1,197 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "GroundMap.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+/*!	\file GroundMap.cpp
+	\brief Implementation of the pre-filtered grayscale ground texture
+*/
+
+namespace Enki
+{
+	const double GroundMap::kernelStep = 0.25;
+	
+	//! Compute the texel offsets and weights of a kernel along one axis, for a sensor at shift from the center of a texel of size texelSize; return the largest absolute offset
+	static int getTexelWeights(const double kernel[GroundMap::kernelSize], double texelSize, double shift, std::vector<int>& offsets, std::vector<double>& weights)
+	{
+		// a sensor at shift from a texel center samples the texel at floor(0.5 + (shift + x) / texelSize)
+		const int halfSize = GroundMap::kernelSize / 2;
+		const int minOffset = int(floor(0.5 + (shift - halfSize * GroundMap::kernelStep) / texelSize));
+		const int maxOffset = int(floor(0.5 + (shift + halfSize * GroundMap::kernelStep) / texelSize));
+		weights.assign(maxOffset - minOffset + 1, 0);
+		for (int i = 0; i < GroundMap::kernelSize; ++i)
+		{
+			const double x(shift + double(i - halfSize) * GroundMap::kernelStep);
+			const int offset(int(floor(0.5 + x / texelSize)));
+			weights[offset - minOffset] += kernel[i];
+		}
+		offsets.resize(weights.size());
+		for (size_t i = 0; i < offsets.size(); ++i)
+			offsets[i] = minOffset + int(i);
+		return std::max(-minOffset, maxOffset);
+	}
+	
+	//! Split texels of size texelSize into subdivisions values along one axis, and compute the texel offsets and weights of a kernel for each of them; return the largest absolute offset
+	static int getSubdivisionWeights(const double kernel[GroundMap::kernelSize], double texelSize, int& subdivisions, std::vector<std::vector<int> >& offsets, std::vector<std::vector<double> >& weights)
+	{
+		// values are spaced by at most the step of the kernel, value subdivisions / 2 being at the center of the texel
+		subdivisions = std::max(int(ceil(texelSize / GroundMap::kernelStep)), 1);
+		offsets.resize(subdivisions);
+		weights.resize(subdivisions);
+		int reach(0);
+		for (int i = 0; i < subdivisions; ++i)
+		{
+			const double shift(double(i - subdivisions / 2) * texelSize / double(subdivisions));
+			reach = std::max(reach, getTexelWeights(kernel, texelSize, shift, offsets[i], weights[i]));
+		}
+		return reach;
+	}
+	
+	GroundMap::GroundMap(double outsideIntensity) :
+		stepX(1),
+		stepY(1),
+		width(0),
+		height(0),
+		outsideIntensity(outsideIntensity)
+	{
+	}
+	
+	GroundMap::GroundMap(const Point& textureOrigin, const Vector& textureSize, unsigned textureWidth, unsigned textureHeight, const uint32_t* texture, double outsideIntensity, double spatialSd) :
+		outsideIntensity(outsideIntensity)
+	{
+		const double texelWidth(textureSize.x / textureWidth);
+		const double texelHeight(textureSize.y / textureHeight);
+		double kernel[kernelSize];
+		getKernel(spatialSd, kernel);
+		int subdivisionsX, subdivisionsY;
+		std::vector<std::vector<int> > offsetsX, offsetsY;
+		std::vector<std::vector<double> > weightsX, weightsY;
+		const int reachX(getSubdivisionWeights(kernel, texelWidth, subdivisionsX, offsetsX, weightsX));
+		const int reachY(getSubdivisionWeights(kernel, texelHeight, subdivisionsY, offsetsY, weightsY));
+		
+		// grayscale texture, extended with the outside intensity by twice the reach of the kernel:
+		// values within the reach of the texture are computed, the outermost ones only see the outside
+		const int marginX(2 * reachX + 1);
+		const int marginY(2 * reachY + 1);
+		const int grayWidth(int(textureWidth) + 2 * marginX);
+		const int grayHeight(int(textureHeight) + 2 * marginY);
+		std::vector<double> gray(size_t(grayWidth) * grayHeight, outsideIntensity);
+		for (unsigned y = 0; y < textureHeight; ++y)
+			for (unsigned x = 0; x < textureWidth; ++x)
+				gray[(y + marginY) * grayWidth + x + marginX] = Color::fromARGB(texture[y * textureWidth + x]).toGray();
+		
+		// every texel of the extended texture holds subdivisionsX x subdivisionsY values
+		stepX = texelWidth / subdivisionsX;
+		stepY = texelHeight / subdivisionsY;
+		width = grayWidth * subdivisionsX;
+		height = grayHeight * subdivisionsY;
+		origin = textureOrigin + Vector((0.5 - marginX) * texelWidth - (subdivisionsX / 2) * stepX, (0.5 - marginY) * texelHeight - (subdivisionsY / 2) * stepY);
+		
+		// filter along x, then along y
+		std::vector<double> filtered(size_t(width) * grayHeight, outsideIntensity);
+		for (int y = 0; y < grayHeight; ++y)
+		{
+			for (int x = reachX; x < grayWidth - reachX; ++x)
+			{
+				for (int i = 0; i < subdivisionsX; ++i)
+				{
+					double v(0);
+					for (size_t k = 0; k < offsetsX[i].size(); ++k)
+						v += weightsX[i][k] * gray[y * grayWidth + x + offsetsX[i][k]];
+					filtered[y * width + x * subdivisionsX + i] = v;
+				}
+			}
+		}
+		values.assign(size_t(width) * height, float(outsideIntensity));
+		for (int y = reachY; y < grayHeight - reachY; ++y)
+		{
+			for (int i = 0; i < subdivisionsY; ++i)
+			{
+				for (int x = 0; x < width; ++x)
+				{
+					double v(0);
+					for (size_t k = 0; k < offsetsY[i].size(); ++k)
+						v += weightsY[i][k] * filtered[(y + offsetsY[i][k]) * width + x];
+					values[(y * subdivisionsY + i) * width + x] = float(v);
+				}
+			}
+		}
+	}
+	
+	double GroundMap::getIntensity(const Point& p) const
+	{
+		if (values.empty())
+			return outsideIntensity;
+		
+		const double u((p.x - origin.x) / stepX);
+		const double v((p.y - origin.y) / stepY);
+		const double fu(floor(u));
+		const double fv(floor(v));
+		if (fu < -1 || fu >= width || fv < -1 || fv >= height)
+			return outsideIntensity;
+		
+		const int x(static_cast<int>(fu));
+		const int y(static_cast<int>(fv));
+		const double dx(u - fu);
+		const double dy(v - fv);
+		const double bottom(getValue(x, y) * (1 - dx) + getValue(x + 1, y) * dx);
+		const double top(getValue(x, y + 1) * (1 - dx) + getValue(x + 1, y + 1) * dx);
+		return bottom * (1 - dy) + top * dy;
+	}
+	
+	void GroundMap::getKernel(double spatialSd, double weights[kernelSize])
+	{
+		// the 2-D kernel exp(-(x^2 + y^2) / (2 var)) is the product of two 1-D ones
+		const double var(spatialSd * spatialSd);
+		double sum(0);
+		for (int i = 0; i < kernelSize; ++i)
+		{
+			const double x(double(i - kernelSize / 2) * kernelStep);
+			weights[i] = exp(-(x * x) / (2. * var));
+			sum += weights[i];
+		}
+		for (int i = 0; i < kernelSize; ++i)
+			weights[i] /= sum;
+	}
+	
+	double GroundMap::getValue(int x, int y) const
+	{
+		if (x < 0 || x >= width || y < 0 || y >= height)
+			return outsideIntensity;
+		return values[y * width + x];
+	}
+}
@@ -0,0 +1,105 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef __ENKI_GROUNDMAP_H
+#define __ENKI_GROUNDMAP_H
+
+#include "Geometry.h"
+#include "Types.h"
+#include <vector>
+
+/*!	\file GroundMap.h
+	\brief A grayscale ground texture pre-filtered by the kernel of ground sensors
+*/
+
+namespace Enki
+{
+	//! The ground intensity seen by a ground sensor, pre-computed over the ground texture
+	/*! \ingroup core
+		A ground sensor samples the ground on a 9x9 grid with a 0.25 cm spacing, weighted by
+		a Gaussian of standard deviation spatialSd. As this kernel is separable, it is applied
+		to the grayscale ground texture once per axis, for a sensor centered on values spaced
+		by at most 0.25 cm, every texel being split into the same number of values along each
+		axis, one of them at its center. A reading is then a bilinear interpolation between the
+		four closest values. It is exact, up to float precision, at these values; in between,
+		every sample of the kernel crosses at most one border of texels per axis. Across a
+		straight edge between two colors along an axis, a reading thus differs from point sampling
+		by at most the largest weight of the kernel along one axis times the difference of
+		intensity of the colors, and across a diagonal edge by at most twice this. A map over
+		a texture of texels larger than 0.25 cm takes 16 floats per cm2.
+		Outside the map, the ground has the intensity of the world color, as in World::getGroundColor().
+	*/
+	class GroundMap
+	{
+	public:
+		//! Number of samples of the kernel along each axis
+		static const int kernelSize = 9;
+		//! Distance between samples of the kernel, in cm
+		static const double kernelStep;
+		
+	protected:
+		//! Position of the first value
+		Point origin;
+		//! Distance between values along x
+		double stepX;
+		//! Distance between values along y
+		double stepY;
+		//! Number of values along x
+		int width;
+		//! Number of values along y
+		int height;
+		//! Intensity outside the ground texture
+		double outsideIntensity;
+		//! Filtered intensities, organised as scanlines; empty if the ground is uniform
+		std::vector<float> values;
+		
+	public:
+		//! Build a uniform map of given intensity
+		GroundMap(double outsideIntensity = 0);
+		//! Build a map from an ARGB texture of textureWidth x textureHeight texels covering the rectangle of bottom-left corner textureOrigin and given size
+		GroundMap(const Point& textureOrigin, const Vector& textureSize, unsigned textureWidth, unsigned textureHeight, const uint32_t* texture, double outsideIntensity, double spatialSd);
+		
+		//! Return the filtered intensity at p
+		double getIntensity(const Point& p) const;
+		
+		//! Fill weights with the normalised weights of the kernel along one axis, for a standard deviation spatialSd
+		static void getKernel(double spatialSd, double weights[kernelSize]);
+		
+	protected:
+		//! Return the filtered value at integer coordinates, or outsideIntensity if outside the map
+		double getValue(int x, int y) const;
+	};
+}
+
+#endif
@@ -47,6 +47,8 @@ namespace Enki
 	class PhysicalObject;
 	class Robot;
 	class World;
+	class Snapshot;
+	class StaticScene;
 
 	//! Interacts with another object or wall only up to a certain distance
 	/*! \ingroup core */
@@ -60,12 +62,14 @@ namespace Enki
 		friend class Robot;
 		//! The physical object that owns the interaction.
 		Robot *owner;
+		//! Identifier of the random stream of this interaction within its owner, given by Robot::addLocalInteraction()
+		unsigned randomStreamId;
 
 	public :
 		//! Constructor
-		LocalInteraction():r(0) {}
+		LocalInteraction():r(0), randomStreamId(0) {}
 		//! Constructor
-		LocalInteraction(double range, Robot* owner) : r(range), owner(owner) {}
+		LocalInteraction(double range, Robot* owner) : r(range), owner(owner), randomStreamId(0) {}
 		//! Destructor
 		virtual ~LocalInteraction() { }
 		//! Init at each step
@@ -77,6 +81,15 @@ namespace Enki
 			\param w world where the interaction takes place
 		*/
 		virtual void objectStep(double dt, World* w, PhysicalObject *po) { }
+		//! Whether this interaction finds objects of infinite mass itself in staticSceneStep(), when the world keeps them in a StaticScene, rather than getting them in objectStep(); false by default
+		virtual bool usesStaticScene() const { return false; }
+		//! Interact with the objects of infinite mass of scene, called after objectStep() has been called for all other objects, if usesStaticScene() returns true
+		/*!
+			\param dt time step
+			\param w world where the interaction takes place
+			\param scene static objects of w
+		*/
+		virtual void staticSceneStep(double dt, World* w, const StaticScene& scene) { }
 		//! Interact with walls
 		/*!
 			\param w world to which interact
@@ -84,8 +97,18 @@ namespace Enki
 		virtual void wallsStep(double dt, World* w) { }
 		//! Finalize at each step
 		virtual void finalize(double dt, World* w) { }
+		//! Write the state that this interaction keeps from one step to the next, see World::snapshot()
+		virtual void saveState(Snapshot& snapshot) const { }
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot) { }
+		//! Write the sizes of the state that restoreState() cannot change, see World::snapshot()
+		virtual void saveLayout(Snapshot& snapshot) const { }
+		//! Read the sizes written by saveLayout(), making snapshot fail if they differ from the current ones
+		virtual void checkLayout(Snapshot& snapshot) const { }
 		//! Return the range of the interaction
 		double getRange() const { return r; }
+		//! Return the identifier of the random stream of this interaction within its owner, see PhysicalObject::getRandomStream()
+		unsigned getRandomStreamId() const { return randomStreamId; }
 	};
 
 	//! Interacts with the whole world
@@ -109,6 +132,14 @@ namespace Enki
 		virtual void step(double dt, World *w) { }
 		//! Finalize at each step
 		virtual void finalize(double dt, World *w) { }
+		//! Write the state that this interaction keeps from one step to the next, see World::snapshot()
+		virtual void saveState(Snapshot& snapshot) const { }
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot) { }
+		//! Write the sizes of the state that restoreState() cannot change, see World::snapshot()
+		virtual void saveLayout(Snapshot& snapshot) const { }
+		//! Read the sizes written by saveLayout(), making snapshot fail if they differ from the current ones
+		virtual void checkLayout(Snapshot& snapshot) const { }
 	};
 }
 #endif
@@ -37,6 +37,8 @@
 #include <assert.h>
 #include <algorithm>
 #include <limits>
+#include <set>
+#include <typeinfo>
 
 // _________________________________
 //
@@ -51,20 +53,17 @@ namespace Enki
 	// PhysicalObject::Part
 	
 	PhysicalObject::Part::Part(const Polygone& shape, double height) :
-		height(height),
-		shape(shape)
+		prototype(new Prototype(shape, height))
 	{
-		computeAreaAndCentroid();
+		prototype->computeMassProperties();
 		
 		transformedShape.resize(shape.size());
 	}
 	
 	PhysicalObject::Part::Part(const Polygone& shape, double height, const Textures& textures) :
-		height(height),
-		shape(shape),
-		textures(textures)
+		prototype(new Prototype(shape, height))
 	{
-		computeAreaAndCentroid();
+		prototype->computeMassProperties();
 		
 		transformedShape.resize(shape.size());
 		
@@ -72,7 +71,6 @@ namespace Enki
 		{
 			std::cerr << "Error: PhysicalObject::Part::Part: texture sides count " << textures.size() << " missmatch shape sides count " << shape.size() << std::endl;
 			std::cerr << "\tignoring textures for this object" << std::endl;
-			this->textures.clear();
 			return;
 		}
 		
@@ -82,25 +80,74 @@ namespace Enki
 			{
 				std::cerr << "Error: PhysicalObject::Part::Part: texture for side " << i << " contains no data" << std::endl;
 				std::cerr << "\tignoring textures for this object" << std::endl;
-				this->textures.clear();
 				return;
 			}
 		}
+		
+		prototype->textures = textures;
 	}
 	
 	PhysicalObject::Part::Part(double l1, double l2, double height) :
-		height(height),
-		area(l1*l2),
-		centroid(0, 0)
+		prototype(new Prototype(Polygone(), height))
 	{
 		const double hl1 = l1 / 2;
 		const double hl2 = l2 / 2;
 		
-		shape << Point(-hl1, -hl2) << Point(hl1, -hl2) << Point(hl1, hl2) << Point(-hl1, hl2);
-		transformedShape.resize(shape.size());
+		prototype->shape << Point(-hl1, -hl2) << Point(hl1, -hl2) << Point(hl1, hl2) << Point(-hl1, hl2);
+		prototype->area = l1*l2;
+		prototype->secondMomentOfArea = l1*l2*(l1*l1 + l2*l2) / 12;
+		prototype->centroid = Point(0, 0);
+		transformedShape.resize(prototype->shape.size());
+	}
+	
+	PhysicalObject::Part::Part(const Part& that) :
+		prototype(that.prototype),
+		transformedShape(that.transformedShape),
+		transformedCentroid(that.transformedCentroid)
+	{
+		#pragma omp critical(EnkiPartPrototype)
+		++prototype->refCount;
+	}
+	
+	PhysicalObject::Part& PhysicalObject::Part::operator=(const Part& that)
+	{
+		if (prototype != that.prototype)
+		{
+			#pragma omp critical(EnkiPartPrototype)
+			++that.prototype->refCount;
+			releasePrototype();
+			prototype = that.prototype;
+		}
+		transformedShape = that.transformedShape;
+		transformedCentroid = that.transformedCentroid;
+		return *this;
+	}
+	
+	PhysicalObject::Part::~Part()
+	{
+		releasePrototype();
+	}
+	
+	void PhysicalObject::Part::releasePrototype()
+	{
+		bool last;
+		#pragma omp critical(EnkiPartPrototype)
+		last = (--prototype->refCount == 0);
+		if (last)
+			delete prototype;
+	}
+	
+	void PhysicalObject::Part::detachPrototype()
+	{
+		if (prototype->refCount == 1)
+			return;
+		Prototype* copy(new Prototype(*prototype));
+		copy->refCount = 1;
+		releasePrototype();
+		prototype = copy;
 	}
 	
-	void PhysicalObject::Part::computeAreaAndCentroid()
+	void PhysicalObject::Part::Prototype::computeMassProperties()
 	{
 		// from: http://local.wasp.uwa.edu.au/~pbourke/geometry/polyarea/
 		const size_t size = shape.size();
@@ -122,26 +169,39 @@ namespace Enki
 			centroid.y += (shape[i].y + shape[(i+1) % size].y) * multiplicator;
 		}
 		centroid /= (6 * area);
+		
+		// polar second moment of area around the centroid, from the triangles it forms with the edges
+		secondMomentOfArea = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			const Vector p0 = shape[i] - centroid;
+			const Vector p1 = shape[(i+1) % size] - centroid;
+			secondMomentOfArea += p0.cross(p1) * (p0*p0 + p0*p1 + p1*p1);
+		}
+		secondMomentOfArea /= 12;
 	}
 	
 	void PhysicalObject::Part::computeTransformedShape(const Matrix22& rot, const Point& trans)
 	{
+		const Polygone& shape(prototype->shape);
 		assert(!shape.empty());
 		assert(transformedShape.size() == shape.size());
 		for (size_t i = 0; i < shape.size(); ++i)
-			transformedShape[i] = rot * (shape)[i] + trans;
-		transformedCentroid = rot * centroid + trans;
+			transformedShape[i] = rot * shape[i] + trans;
+		transformedCentroid = rot * prototype->centroid + trans;
 	}
 	
 	void PhysicalObject::Part::applyTransformation(const Matrix22& rot, const Point& trans, double* radius = 0)
 	{
+		detachPrototype();
+		Polygone& shape(prototype->shape);
 		for (size_t i = 0; i < shape.size(); ++i)
 		{
-			(shape)[i] = rot * (shape)[i] + trans;
+			shape[i] = rot * shape[i] + trans;
 			if (radius)
 				*radius = std::max(*radius, shape[i].norm());
 		}
-		centroid = rot * centroid + trans;
+		prototype->centroid = rot * prototype->centroid + trans;
 	}
 	
 	
@@ -234,7 +294,17 @@ namespace Enki
 		viscousMomentFrictionCoefficient(0.01),
 		angle(0),
 		angSpeed(0),
-		interlacedDistance(0)
+		interlacedDistance(0),
+		sleeping(false),
+		restingSteps(0),
+		inContact(false),
+		sleepingAngle(0),
+		worldIndex(std::numeric_limits<size_t>::max()),
+		uid(0),
+		randomKey(0),
+		transformedShapeValid(false),
+		transformedShapeAngle(0),
+		geometryVersion(0)
 	{
 		setCylindric(1, 1, 1);
 	}
@@ -271,13 +341,16 @@ namespace Enki
 		// update the moment of inertia
 		computeMomentOfInertia();
 		
+		transformedShapeValid = false;
+		++geometryVersion;
+		wakeUp();
 		dirtyUserData();
 	}
 	
 	void PhysicalObject::setRectangular(double l1, double l2, double height, double mass)
 	{
 		// assign a new hull
-		hull.resize(1, Part(l1, l2, height));
+		hull.assign(1, Part(l1, l2, height));
 		this->height = height;
 		
 		// compute the center of mass
@@ -289,6 +362,9 @@ namespace Enki
 		// update the moment of inertia
 		computeMomentOfInertia();
 		
+		transformedShapeValid = false;
+		++geometryVersion;
+		wakeUp();
 		dirtyUserData();
 	}
 	
@@ -309,6 +385,9 @@ namespace Enki
 		// update the moment of inertia
 		computeMomentOfInertia();
 		
+		transformedShapeValid = false;
+		++geometryVersion;
+		wakeUp();
 		dirtyUserData();
 	}
 	
@@ -328,27 +407,16 @@ namespace Enki
 		}
 		else
 		{
-			// Numerical method:
-			// arbitrary shaped object, numerically compute moment of inertia
-			momentOfInertia = 0;
-			double numericalArea = 0;
-			const double dr = r / 50.;
-			for (double ix = -r; ix < r; ix += dr)
-				for (double iy = -r; iy < r; iy += dr)
-					for (Hull::const_iterator it = hull.begin(); it != hull.end(); ++it)
-						if (it->shape.isPointInside(Point(ix, iy)))
-						{
-							momentOfInertia += ix * ix + iy * iy;
-							numericalArea++;
-						}
-			
-			momentOfInertia *= mass / numericalArea;
-			
-			// Exact method:
-			/*
-			TODO: check this and implement
-			http://lab.polygonal.de/2006/08/17/calculating-the-moment-of-inertia-of-a-convex-polygon/
-			*/
+			// Exact method: sum the second moments of area of the parts around the origin of the
+			// object, using the parallel axis theorem, and distribute the mass uniformly over the area
+			double secondMoment = 0;
+			double area = 0;
+			for (Hull::const_iterator it = hull.begin(); it != hull.end(); ++it)
+			{
+				secondMoment += it->getSecondMomentOfArea() + it->getArea() * it->getCentroid().norm2();
+				area += it->getArea();
+			}
+			momentOfInertia = mass * secondMoment / area;
 		}
 	}
 	
@@ -402,26 +470,69 @@ namespace Enki
 		// FIXME: this shift is really ugly. We can only do it for non-robots
 		// because otherwise the local interactions are missplaced.
 		Robot* robot(dynamic_cast<Robot*>(this));
-		if (!robot)
+		if (!robot && (cm.x != 0 || cm.y != 0))
 		{
 			pos += Matrix22(angle) * cm;
 			hull.applyTransformation(Matrix22::identity(), -cm, &r);
 		}
 		else
 		{
-			// we need to compute radius
-			hull.applyTransformation(Matrix22::identity(), Vector(), &r);
+			// we need to compute radius, without modifying the parts so that they keep sharing their prototypes
+			r = 0;
+			for (Hull::const_iterator it = hull.begin(); it != hull.end(); ++it)
+				for (Polygone::const_iterator jt = it->getShape().begin(); jt != it->getShape().end(); ++jt)
+					r = std::max(r, jt->norm());
 		}
 	}
 	
 	void PhysicalObject::computeTransformedShape()
 	{
-		if (!hull.empty())
-		{
-			Matrix22 rotMat(angle);
-			for (Hull::iterator it = hull.begin(); it != hull.end(); ++it)
-				it->computeTransformedShape(rotMat, pos);
-		}
+		if (hull.empty())
+			return;
+		// static objects and objects at rest do not need to be transformed again
+		if (transformedShapeValid && pos.x == transformedShapePos.x && pos.y == transformedShapePos.y && angle == transformedShapeAngle)
+			return;
+		
+		Matrix22 rotMat(angle);
+		for (Hull::iterator it = hull.begin(); it != hull.end(); ++it)
+			it->computeTransformedShape(rotMat, pos);
+		transformedShapeValid = true;
+		transformedShapePos = pos;
+		transformedShapeAngle = angle;
+	}
+	
+	void PhysicalObject::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(pos);
+		snapshot.writeValue(angle);
+		snapshot.writeValue(speed);
+		snapshot.writeValue(angSpeed);
+		snapshot.writeValue(posBeforeCollision);
+		snapshot.writeValue(interlacedDistance);
+		snapshot.writeValue(color);
+		snapshot.writeValue(sleeping);
+		snapshot.writeValue(restingSteps);
+		snapshot.writeValue(sleepingPos);
+		snapshot.writeValue(sleepingAngle);
+	}
+	
+	void PhysicalObject::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readValue(pos);
+		snapshot.readValue(angle);
+		snapshot.readValue(speed);
+		snapshot.readValue(angSpeed);
+		snapshot.readValue(posBeforeCollision);
+		snapshot.readValue(interlacedDistance);
+		Color savedColor(color);
+		snapshot.readValue(savedColor);
+		if (savedColor != color)
+			setColor(savedColor);
+		snapshot.readValue(sleeping);
+		snapshot.readValue(restingSteps);
+		snapshot.readValue(sleepingPos);
+		snapshot.readValue(sleepingAngle);
+		computeTransformedShape();
 	}
 	
 	
@@ -518,6 +629,7 @@ namespace Enki
 		
 		// store position after integration
 		posBeforeCollision  = pos;
+		inContact = false;
 	}
 
 	void PhysicalObject::finalizePhysicsInteractions(double dt)
@@ -527,9 +639,38 @@ namespace Enki
 		angle = normalizeAngle(angle);
 	}
 	
+	void PhysicalObject::updateSleeping(double sleepSpeedThreshold, unsigned sleepDelay)
+	{
+		const bool atRest(speed.norm2() <= sleepSpeedThreshold * sleepSpeedThreshold && fabs(angSpeed) <= sleepSpeedThreshold);
+		if (inContact || !atRest || mass < 0)
+			restingSteps = 0;
+		else if (++restingSteps >= sleepDelay)
+		{
+			sleeping = true;
+			speed = Vector(0, 0);
+			angSpeed = 0;
+			sleepingPos = pos;
+			sleepingAngle = angle;
+		}
+	}
+	
+	bool PhysicalObject::isDisturbed() const
+	{
+		return pos.x != sleepingPos.x || pos.y != sleepingPos.y || angle != sleepingAngle ||
+			speed.x != 0 || speed.y != 0 || angSpeed != 0;
+	}
+	
+	void PhysicalObject::wakeUp()
+	{
+		sleeping = false;
+		restingSteps = 0;
+	}
+	
 	
 	void PhysicalObject::collideWithStaticObject(const Vector &n, const Point &cp)
 	{
+		inContact = true;
+		
 		// only perform physics if we are in a physically-realistic collision situation,
 		if (n * speed > 0)
 		{
@@ -552,6 +693,19 @@ namespace Enki
 
 	void PhysicalObject::collideWithObject(PhysicalObject &that, Point cp, const Vector &dist)
 	{
+		// a collision wakes sleeping objects up and prevents them from falling asleep;
+		// objects of infinite mass never sleep and are shared between islands, so they are left untouched
+		if (mass >= 0)
+		{
+			wakeUp();
+			inContact = true;
+		}
+		if (that.mass >= 0)
+		{
+			that.wakeUp();
+			that.inContact = true;
+		}
+		
 		// handle infinite mass case
 		if (mass < 0)
 		{
@@ -635,6 +789,8 @@ namespace Enki
 	void Robot::addLocalInteraction(LocalInteraction *li)
 	{
 		localInteractions.push_back(li);
+		// stream 0 is the one of the robot itself
+		li->randomStreamId = localInteractions.size();
 		sortLocalInteractions();
 	}
 	
@@ -657,16 +813,38 @@ namespace Enki
 
 	void Robot::doLocalInteractions(double dt, World *w, PhysicalObject *po)
 	{
+		// interactions using the static scene find static objects in doStaticSceneInteractions()
+		const bool inStaticScene((po->getMass() < 0) && w->getStaticScene());
 		for (size_t i=0; i<localInteractions.size(); i++)
 		{
 			const Vector vectCenter(this->pos.x - po->pos.x, this->pos.y - po->pos.y );
 			if (vectCenter.norm2() <  (localInteractions[i]->r+po->getRadius())*(localInteractions[i]->r+po->getRadius()))
-				localInteractions[i]->objectStep(dt, w, po);
+			{
+				if (!inStaticScene || !localInteractions[i]->usesStaticScene())
+					localInteractions[i]->objectStep(dt, w, po);
+			}
 			else
 				return;
 		}
 	}
+	
+	void Robot::doStaticSceneInteractions(double dt, World* w, const StaticScene& scene)
+	{
+		for (size_t i=0; i<localInteractions.size(); i++)
+		{
+			if (localInteractions[i]->usesStaticScene())
+				localInteractions[i]->staticSceneStep(dt, w, scene);
+		}
+	}
+
 
+	double Robot::getLocalInteractionsRange() const
+	{
+		// local interactions are sorted from long to short range
+		if (localInteractions.empty())
+			return 0;
+		return localInteractions[0]->r;
+	}
 
 	void Robot::doLocalWallsInteraction(double dt, World* w)
 	{
@@ -695,6 +873,42 @@ namespace Enki
 		}
 	}
 	
+	void Robot::saveState(Snapshot& snapshot) const
+	{
+		PhysicalObject::saveState(snapshot);
+		for (size_t i=0; i<localInteractions.size(); i++)
+			localInteractions[i]->saveState(snapshot);
+		for (size_t i=0; i<globalInteractions.size(); i++)
+			globalInteractions[i]->saveState(snapshot);
+	}
+	
+	void Robot::restoreState(Snapshot& snapshot)
+	{
+		PhysicalObject::restoreState(snapshot);
+		for (size_t i=0; i<localInteractions.size(); i++)
+			localInteractions[i]->restoreState(snapshot);
+		for (size_t i=0; i<globalInteractions.size(); i++)
+			globalInteractions[i]->restoreState(snapshot);
+	}
+	
+	void Robot::saveLayout(Snapshot& snapshot) const
+	{
+		PhysicalObject::saveLayout(snapshot);
+		for (size_t i=0; i<localInteractions.size(); i++)
+			localInteractions[i]->saveLayout(snapshot);
+		for (size_t i=0; i<globalInteractions.size(); i++)
+			globalInteractions[i]->saveLayout(snapshot);
+	}
+	
+	void Robot::checkLayout(Snapshot& snapshot) const
+	{
+		PhysicalObject::checkLayout(snapshot);
+		for (size_t i=0; i<localInteractions.size(); i++)
+			localInteractions[i]->checkLayout(snapshot);
+		for (size_t i=0; i<globalInteractions.size(); i++)
+			globalInteractions[i]->checkLayout(snapshot);
+	}
+	
 	World::GroundTexture::GroundTexture():
 		width(0),
 		height(0)
@@ -706,6 +920,16 @@ namespace Enki
 		data(data, data+width*height)
 	{}
 
+	//! Return a new unique identifier for a world
+	static unsigned long newUid()
+	{
+		static unsigned long lastUid = 0;
+		unsigned long uid;
+		#pragma omp critical(EnkiWorldUid)
+		uid = ++lastUid;
+		return uid;
+	}
+	
 	World::World(double width, double height, const Color& color, const GroundTexture& groundTexture) :
 		wallsType(WALLS_SQUARE),
 		w(width),
@@ -714,7 +938,18 @@ namespace Enki
 		color(color),
 		groundTexture(groundTexture),
 		takeObjectOwnership(true),
-		bluetoothBase(NULL)
+		broadphaseType(BROADPHASE_ALL_PAIRS),
+		useStaticScene(false),
+		threadCount(1),
+		parallelInteractions(false),
+		allowSleeping(false),
+		sleepSpeedThreshold(0),
+		sleepDelay(10),
+		bluetoothBase(NULL),
+		uid(newUid()),
+		randomSeed(0),
+		stepCount(0),
+		nextObjectUid(0)
 	{
 	}
 	
@@ -726,7 +961,18 @@ namespace Enki
 		color(color),
 		groundTexture(groundTexture),
 		takeObjectOwnership(true),
-		bluetoothBase(NULL)
+		broadphaseType(BROADPHASE_ALL_PAIRS),
+		useStaticScene(false),
+		threadCount(1),
+		parallelInteractions(false),
+		allowSleeping(false),
+		sleepSpeedThreshold(0),
+		sleepDelay(10),
+		bluetoothBase(NULL),
+		uid(newUid()),
+		randomSeed(0),
+		stepCount(0),
+		nextObjectUid(0)
 	{
 	}
 	
@@ -737,7 +983,18 @@ namespace Enki
 		r(0),
 		color(Color::gray),
 		takeObjectOwnership(true),
-		bluetoothBase(NULL)
+		broadphaseType(BROADPHASE_ALL_PAIRS),
+		useStaticScene(false),
+		threadCount(1),
+		parallelInteractions(false),
+		allowSleeping(false),
+		sleepSpeedThreshold(0),
+		sleepDelay(10),
+		bluetoothBase(NULL),
+		uid(newUid()),
+		randomSeed(0),
+		stepCount(0),
+		nextObjectUid(0)
 	{
 	}
 
@@ -760,16 +1017,17 @@ namespace Enki
 	{
 		if (groundTexture.data.empty() || wallsType == WALLS_NONE)
 			return color;
+		// round towards minus infinity, so that points just outside the texture are not mapped to its borders
 		int texX, texY;
 		if (wallsType == WALLS_SQUARE)
 		{
-			texX = p.x * groundTexture.width / w;
-			texY = p.y * groundTexture.height / h;
+			texX = int(floor(p.x * groundTexture.width / w));
+			texY = int(floor(p.y * groundTexture.height / h));
 		}
 		else if (wallsType == WALLS_CIRCULAR)
 		{
-			texX = (p.x+r) * groundTexture.width / (2*r);
-			texY = (p.y+r) * groundTexture.height / (2*r);
+			texX = int(floor((p.x+r) * groundTexture.width / (2*r)));
+			texY = int(floor((p.y+r) * groundTexture.height / (2*r)));
 		}
 		else
 			abort();
@@ -780,6 +1038,27 @@ namespace Enki
 		return Color::fromARGB(data);
 	}
 	
+	const GroundMap* World::getGroundMap(double spatialSd) const
+	{
+		const GroundMap* groundMap;
+		#pragma omp critical(EnkiGroundMaps)
+		{
+			std::map<double, GroundMap>::const_iterator it(groundMaps.find(spatialSd));
+			if (it == groundMaps.end())
+			{
+				const double outsideIntensity(color.toGray());
+				if (groundTexture.data.empty() || wallsType == WALLS_NONE)
+					it = groundMaps.insert(std::make_pair(spatialSd, GroundMap(outsideIntensity))).first;
+				else if (wallsType == WALLS_SQUARE)
+					it = groundMaps.insert(std::make_pair(spatialSd, GroundMap(Point(0, 0), Vector(w, h), groundTexture.width, groundTexture.height, &groundTexture.data[0], outsideIntensity, spatialSd))).first;
+				else
+					it = groundMaps.insert(std::make_pair(spatialSd, GroundMap(Point(-r, -r), Vector(2*r, 2*r), groundTexture.width, groundTexture.height, &groundTexture.data[0], outsideIntensity, spatialSd))).first;
+			}
+			groundMap = &it->second;
+		}
+		return groundMap;
+	}
+	
 	/*
 	Texture of world walls is disabled now, re-enable a proper support if required
 	void World::setWallsColor(const Color& color)
@@ -935,6 +1214,10 @@ namespace Enki
 
 	void World::collideObjects(PhysicalObject *object1, PhysicalObject *object2)
 	{
+		// objects that are static or asleep do not move, so they cannot get into contact
+		if ((object1->mass < 0 || object1->sleeping) && (object2->mass < 0 || object2->sleeping))
+			return;
+		
 		// Is there a possible contact ?
 		const Vector distOCtoOC = object1->pos-object2->pos;
 		const double addedRay = object1->r+object2->r;
@@ -1037,54 +1320,212 @@ namespace Enki
 		}
 	}
 
-	void World::step(double dt, unsigned physicsOversampling)
+	void World::collideAllPairsOfObjects()
 	{
-		// oversampling physics
-		const double overSampledDt = dt / (double)physicsOversampling;
-		for (unsigned po = 0; po < physicsOversampling; po++)
+		unsigned iCounter, jCounter;
+		iCounter = 0;
+		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
 		{
-			// init physics interactions
-			for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
-				(*i)->initPhysicsInteractions(overSampledDt);
-			
-			// collide objects together
-			unsigned iCounter, jCounter;
-			iCounter = 0;
-			for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			jCounter = 0;
+			for (ObjectsIterator j = objects.begin(); j != objects.end(); ++j)
 			{
-				jCounter = 0;
-				for (ObjectsIterator j = objects.begin(); j != objects.end(); ++j)
+				if (iCounter < jCounter)
 				{
-					if (iCounter < jCounter)
-					{
-						collideObjects((*i), (*j));
-					}
-					jCounter++;
+					collideObjects((*i), (*j));
 				}
-				iCounter++;
+				jCounter++;
 			}
-			
-			// collide objects with walls and physics step
-			for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			iCounter++;
+		}
+	}
+	
+	void World::buildBroadphase()
+	{
+		// collision candidates are at most at the sum of their radii plus a margin of the largest radius,
+		// so cells of three times the largest radius let the neighbouring cells cover all of them
+		double maxRadius(0);
+		if (!useStaticScene)
+		{
+			for (unsigned i = 0; i < orderedObjects.size(); ++i)
+				maxRadius = std::max(maxRadius, orderedObjects[i]->getRadius());
+			objectsGrid.build(orderedObjects, 3 * maxRadius);
+			return;
+		}
+		
+		// static objects seldom change, so their scene is only rebuilt when needed
+		if (!staticScene.isUpToDate(orderedObjects))
+			staticScene.build(orderedObjects);
+		dynamicObjects.clear();
+		dynamicObjectIndices.clear();
+		gridIndices.resize(orderedObjects.size());
+		for (unsigned i = 0; i < orderedObjects.size(); ++i)
+		{
+			if (orderedObjects[i]->mass < 0)
+				gridIndices[i] = std::numeric_limits<unsigned>::max();
+			else
 			{
-				switch (wallsType)
-				{
-					case WALLS_SQUARE: collideWithSquareWalls(*i); break;
-					case WALLS_CIRCULAR: collideWithCircularWalls(*i); break;
-					default: break;
-				}
-				(*i)->finalizePhysicsInteractions(overSampledDt);
+				gridIndices[i] = dynamicObjects.size();
+				dynamicObjects.push_back(orderedObjects[i]);
+				dynamicObjectIndices.push_back(i);
+				maxRadius = std::max(maxRadius, orderedObjects[i]->getRadius());
 			}
 		}
+		objectsGrid.build(dynamicObjects, 3 * maxRadius);
+	}
+	
+	void World::getCollisionCandidates(unsigned i, SpatialGrid::Indices& candidates, SpatialGrid::Indices& dynamicScratch, SpatialGrid::Indices& staticScratch) const
+	{
+		// objects might be pushed into contact during a pass, hence the margin of the largest radius
+		const double margin(objectsGrid.getMaxRadius());
+		if (!useStaticScene)
+		{
+			objectsGrid.getCollisionCandidates(i, margin, candidates);
+			return;
+		}
 		
-		// init non-physics interactions
-		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+		const PhysicalObject* o(orderedObjects[i]);
+		dynamicScratch.clear();
+		staticScratch.clear();
+		if (o->mass < 0)
 		{
-			(*i)->initLocalInteractions(dt, this);
-			(*i)->initGlobalInteractions(dt, this);
+			// pairs of static objects do nothing, so only dynamic objects are candidates
+			objectsGrid.getNeighbours(o->pos, o->r + margin, dynamicScratch);
+			for (size_t j = 0; j < dynamicScratch.size(); ++j)
+				if (dynamicObjectIndices[dynamicScratch[j]] > i)
+					candidates.push_back(dynamicObjectIndices[dynamicScratch[j]]);
 		}
-
-		// interact objects together
+		else
+		{
+			objectsGrid.getCollisionCandidates(gridIndices[i], margin, dynamicScratch);
+			for (size_t j = 0; j < dynamicScratch.size(); ++j)
+				dynamicScratch[j] = dynamicObjectIndices[dynamicScratch[j]];
+			staticScene.getNeighbours(o->pos, o->r + margin, staticScratch);
+			SpatialGrid::Indices::iterator firstStatic(std::upper_bound(staticScratch.begin(), staticScratch.end(), i));
+			std::merge(dynamicScratch.begin(), dynamicScratch.end(), firstStatic, staticScratch.end(), std::back_inserter(candidates));
+		}
+	}
+	
+	void World::getNeighbours(const Point& center, double range, SpatialGrid::Indices& neighbours, SpatialGrid::Indices& dynamicScratch, SpatialGrid::Indices& staticScratch) const
+	{
+		if (!useStaticScene)
+		{
+			objectsGrid.getNeighbours(center, range, neighbours);
+			return;
+		}
+		
+		dynamicScratch.clear();
+		staticScratch.clear();
+		objectsGrid.getNeighbours(center, range, dynamicScratch);
+		for (size_t j = 0; j < dynamicScratch.size(); ++j)
+			dynamicScratch[j] = dynamicObjectIndices[dynamicScratch[j]];
+		staticScene.getNeighbours(center, range, staticScratch);
+		std::merge(dynamicScratch.begin(), dynamicScratch.end(), staticScratch.begin(), staticScratch.end(), std::back_inserter(neighbours));
+	}
+	
+	void World::collideNeighbouringObjects()
+	{
+		buildBroadphase();
+		
+		// collide pairs in the same order as collideAllPairsOfObjects(), so that results are identical
+		for (unsigned i = 0; i < orderedObjects.size(); ++i)
+		{
+			neighbours.clear();
+			getCollisionCandidates(i, neighbours, dynamicNeighbours, staticNeighbours);
+			for (size_t j = 0; j < neighbours.size(); ++j)
+				collideObjects(orderedObjects[i], orderedObjects[neighbours[j]]);
+		}
+	}
+	
+	void World::collideNeighbouringObjectsInParallel()
+	{
+		buildBroadphase();
+		
+		// find candidate pairs in parallel, as in collideNeighbouringObjects()
+		const int objectCount(orderedObjects.size());
+		collisionCandidates.resize(objectCount);
+		#pragma omp parallel num_threads(threadCount)
+		{
+			SpatialGrid::Indices dynamicScratch, staticScratch;
+			#pragma omp for schedule(dynamic, 64)
+			for (int i = 0; i < objectCount; ++i)
+			{
+				collisionCandidates[i].clear();
+				getCollisionCandidates(i, collisionCandidates[i], dynamicScratch, staticScratch);
+			}
+		}
+		
+		// group objects into islands linked by candidate pairs, static objects are not modified by collisions so they do not link islands
+		islandParents.resize(objectCount);
+		for (int i = 0; i < objectCount; ++i)
+			islandParents[i] = i;
+		for (int i = 0; i < objectCount; ++i)
+		{
+			if (orderedObjects[i]->mass < 0)
+				continue;
+			const SpatialGrid::Indices& candidates(collisionCandidates[i]);
+			for (size_t c = 0; c < candidates.size(); ++c)
+			{
+				if (orderedObjects[candidates[c]]->mass < 0)
+					continue;
+				const unsigned island0(findIsland(i));
+				const unsigned island1(findIsland(candidates[c]));
+				if (island0 != island1)
+					islandParents[std::max(island0, island1)] = std::min(island0, island1);
+			}
+		}
+		
+		// count the pairs of every island, pairs of static objects do nothing and are skipped
+		islandPairsStart.assign(objectCount + 1, 0);
+		for (int i = 0; i < objectCount; ++i)
+		{
+			const SpatialGrid::Indices& candidates(collisionCandidates[i]);
+			for (size_t c = 0; c < candidates.size(); ++c)
+			{
+				if (orderedObjects[i]->mass >= 0)
+					++islandPairsStart[findIsland(i)];
+				else if (orderedObjects[candidates[c]]->mass >= 0)
+					++islandPairsStart[findIsland(candidates[c])];
+			}
+		}
+		for (int island = 0; island < objectCount; ++island)
+			islandPairsStart[island + 1] += islandPairsStart[island];
+		
+		// fill pairs backward from the end of their island, so that each island keeps the order of collideNeighbouringObjects()
+		islandPairs.resize(islandPairsStart[objectCount]);
+		for (int i = objectCount - 1; i >= 0; --i)
+		{
+			const SpatialGrid::Indices& candidates(collisionCandidates[i]);
+			for (size_t c = candidates.size(); c > 0; --c)
+			{
+				const unsigned j(candidates[c - 1]);
+				if (orderedObjects[i]->mass >= 0)
+					islandPairs[--islandPairsStart[findIsland(i)]] = std::make_pair(unsigned(i), j);
+				else if (orderedObjects[j]->mass >= 0)
+					islandPairs[--islandPairsStart[findIsland(j)]] = std::make_pair(unsigned(i), j);
+			}
+		}
+		
+		// islands do not share any dynamic object, so they can collide in parallel and give the same results as collideNeighbouringObjects()
+		#pragma omp parallel for num_threads(threadCount) schedule(dynamic, 16)
+		for (int island = 0; island < objectCount; ++island)
+		{
+			for (unsigned p = islandPairsStart[island]; p < islandPairsStart[island + 1]; ++p)
+				collideObjects(orderedObjects[islandPairs[p].first], orderedObjects[islandPairs[p].second]);
+		}
+	}
+	
+	unsigned World::findIsland(unsigned i)
+	{
+		while (islandParents[i] != i)
+		{
+			islandParents[i] = islandParents[islandParents[i]];
+			i = islandParents[i];
+		}
+		return i;
+	}
+	
+	void World::interactAllPairsOfObjects(double dt)
+	{
 		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
 		{
 			for (ObjectsIterator j = objects.begin(); j != objects.end(); ++j)
@@ -1095,17 +1536,190 @@ namespace Enki
 				}
 			}
 		}
+	}
+	
+	void World::interactNeighbouringObjects(double dt)
+	{
+		// objects do not move during interactions, so the grid is built once per step
+		orderedObjects.assign(objects.begin(), objects.end());
+		buildBroadphase();
+		
+		for (unsigned i = 0; i < orderedObjects.size(); ++i)
+		{
+			PhysicalObject* o(orderedObjects[i]);
+			neighbours.clear();
+			getNeighbours(o->pos, o->getLocalInteractionsRange(), neighbours, dynamicNeighbours, staticNeighbours);
+			for (size_t j = 0; j < neighbours.size(); ++j)
+			{
+				if (neighbours[j] != i)
+					o->doLocalInteractions(dt, this, orderedObjects[neighbours[j]]);
+			}
+			if (useStaticScene)
+				o->doStaticSceneInteractions(dt, this, staticScene);
+		}
+	}
 
-		// interact objects with walls and control step
-		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+	void World::stepInteractionsInParallel(double dt)
+	{
+		// objects do not move during interactions, so the grid is built once per step
+		orderedObjects.assign(objects.begin(), objects.end());
+		const int objectCount(orderedObjects.size());
+		const int threads(std::max(threadCount, 1u));
+		const bool useGrid(broadphaseType == BROADPHASE_GRID);
+		if (useGrid)
+			buildBroadphase();
+		
+		// init non-physics interactions, global ones might share state so they are not run in parallel
+		#pragma omp parallel for num_threads(threads) schedule(dynamic, 16)
+		for (int i = 0; i < objectCount; ++i)
+			orderedObjects[i]->initLocalInteractions(dt, this);
+		for (int i = 0; i < objectCount; ++i)
+			orderedObjects[i]->initGlobalInteractions(dt, this);
+		
+		// interact objects together and with walls, every object only writes to its own interactions
+		#pragma omp parallel num_threads(threads)
+		{
+			SpatialGrid::Indices objectNeighbours, dynamicScratch, staticScratch;
+			#pragma omp for schedule(dynamic, 16)
+			for (int i = 0; i < objectCount; ++i)
+			{
+				PhysicalObject* o(orderedObjects[i]);
+				if (useGrid)
+				{
+					objectNeighbours.clear();
+					getNeighbours(o->pos, o->getLocalInteractionsRange(), objectNeighbours, dynamicScratch, staticScratch);
+					for (size_t j = 0; j < objectNeighbours.size(); ++j)
+					{
+						if (objectNeighbours[j] != unsigned(i))
+							o->doLocalInteractions(dt, this, orderedObjects[objectNeighbours[j]]);
+					}
+					if (useStaticScene)
+						o->doStaticSceneInteractions(dt, this, staticScene);
+				}
+				else
+				{
+					for (int j = 0; j < objectCount; ++j)
+					{
+						if (j != i)
+							o->doLocalInteractions(dt, this, orderedObjects[j]);
+					}
+				}
+				if (wallsType != WALLS_NONE)
+					o->doLocalWallsInteraction(dt, this);
+			}
+		}
+		for (int i = 0; i < objectCount; ++i)
+			orderedObjects[i]->doGlobalInteractions(dt, this);
+		
+		// finalize interactions
+		#pragma omp parallel for num_threads(threads) schedule(dynamic, 16)
+		for (int i = 0; i < objectCount; ++i)
+			orderedObjects[i]->finalizeLocalInteractions(dt, this);
+		for (int i = 0; i < objectCount; ++i)
+			orderedObjects[i]->finalizeGlobalInteractions(dt, this);
+		
+		// control step
+		#pragma omp parallel for num_threads(threads) schedule(dynamic, 16)
+		for (int i = 0; i < objectCount; ++i)
+			orderedObjects[i]->controlStep(dt);
+	}
+	
+	void World::finalizePhysicsInteractions(PhysicalObject* o, double dt)
+	{
+		if (o->sleeping)
+			return;
+		switch (wallsType)
+		{
+			case WALLS_SQUARE: collideWithSquareWalls(o); break;
+			case WALLS_CIRCULAR: collideWithCircularWalls(o); break;
+			default: break;
+		}
+		o->finalizePhysicsInteractions(dt);
+		if (allowSleeping && typeid(*o) == typeid(PhysicalObject))
+			o->updateSleeping(sleepSpeedThreshold, sleepDelay);
+	}
+	
+	void World::step(double dt, unsigned physicsOversampling)
+	{
+		// remove the slots of objects removed since the last step
+		if (objects.slotCount() != objects.size())
+			objects.compact();
+		
+		// objects are only modified in place during physics, so they can be accessed by index
+		orderedObjects.assign(objects.begin(), objects.end());
+		const int objectCount(orderedObjects.size());
+		const int threads(std::max(threadCount, 1u));
+		
+		// random streams of objects for this step
+		const uint64_t stepKey(RandomStream::combine(RandomStream::combine(0, randomSeed), stepCount));
+		for (int i = 0; i < objectCount; ++i)
+			orderedObjects[i]->randomKey = RandomStream::combine(stepKey, orderedObjects[i]->uid);
+		
+		// wake up the sleeping objects that were moved or pushed since the last step
+		for (int i = 0; i < objectCount; ++i)
+		{
+			PhysicalObject* o(orderedObjects[i]);
+			if (o->sleeping && (!allowSleeping || o->isDisturbed()))
+				o->wakeUp();
+		}
+		
+		// oversampling physics
+		const double overSampledDt = dt / (double)physicsOversampling;
+		for (unsigned po = 0; po < physicsOversampling; po++)
+		{
+			// init physics interactions
+			#pragma omp parallel for num_threads(threads) if(threads > 1)
+			for (int i = 0; i < objectCount; ++i)
+				if (!orderedObjects[i]->sleeping)
+					orderedObjects[i]->initPhysicsInteractions(overSampledDt);
+			
+			// collide objects together
+			if (broadphaseType == BROADPHASE_GRID)
+			{
+				if (threads > 1)
+					collideNeighbouringObjectsInParallel();
+				else
+					collideNeighbouringObjects();
+			}
+			else
+				collideAllPairsOfObjects();
+			
+			// collide objects with walls and physics step
+			#pragma omp parallel for num_threads(threads) if(threads > 1)
+			for (int i = 0; i < objectCount; ++i)
+				finalizePhysicsInteractions(orderedObjects[i], overSampledDt);
+		}
+		
+		if (parallelInteractions)
 		{
-			PhysicalObject* o = *i;
-			if (wallsType != WALLS_NONE)
-				o->doLocalWallsInteraction(dt, this);
-			o->doGlobalInteractions(dt, this);
-			o->finalizeLocalInteractions(dt, this);
-			o->finalizeGlobalInteractions(dt, this);
-			o->controlStep(dt);
+			stepInteractionsInParallel(dt);
+		}
+		else
+		{
+			// init non-physics interactions
+			for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			{
+				(*i)->initLocalInteractions(dt, this);
+				(*i)->initGlobalInteractions(dt, this);
+			}
+			
+			// interact objects together
+			if (broadphaseType == BROADPHASE_GRID)
+				interactNeighbouringObjects(dt);
+			else
+				interactAllPairsOfObjects(dt);
+			
+			// interact objects with walls and control step
+			for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			{
+				PhysicalObject* o = *i;
+				if (wallsType != WALLS_NONE)
+					o->doLocalWallsInteraction(dt, this);
+				o->doGlobalInteractions(dt, this);
+				o->finalizeLocalInteractions(dt, this);
+				o->finalizeGlobalInteractions(dt, this);
+				o->controlStep(dt);
+			}
 		}
 		
 		// do a control step for the world
@@ -1113,11 +1727,49 @@ namespace Enki
 		// TODO: cleanup this
 		if (bluetoothBase)
 			bluetoothBase->step(dt, this);
+		
+		++stepCount;
+	}
+	
+	bool World::Objects::insert(PhysicalObject* o)
+	{
+		if (contains(o))
+			return false;
+		o->worldIndex = slots.size();
+		slots.push_back(o);
+		++count;
+		return true;
+	}
+	
+	bool World::Objects::erase(PhysicalObject* o)
+	{
+		if (!contains(o))
+			return false;
+		slots[o->worldIndex] = 0;
+		o->worldIndex = std::numeric_limits<size_t>::max();
+		--count;
+		return true;
+	}
+	
+	void World::Objects::compact()
+	{
+		size_t j = 0;
+		for (size_t i = 0; i < slots.size(); ++i)
+		{
+			if (slots[i])
+			{
+				slots[j] = slots[i];
+				slots[j]->worldIndex = j;
+				++j;
+			}
+		}
+		slots.resize(j);
 	}
 	
 	void World::addObject(PhysicalObject *o)
 	{
-		objects.insert(o);
+		if (objects.insert(o))
+			o->uid = nextObjectUid++;
 	}
 
 	void World::removeObject(PhysicalObject *o)
@@ -1135,6 +1787,69 @@ namespace Enki
 	void World::setRandomSeed(unsigned long seed)
 	{
 		random.setSeed(seed);
+		randomSeed = seed;
+	}
+	
+	void World::snapshot(Snapshot& snapshot) const
+	{
+		snapshot.clear();
+		// identify the objects and the sizes of their buffers, to check them upon restore
+		snapshot.writeValue(objects.size());
+		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			snapshot.writeValue((*i)->uid);
+		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			(*i)->saveLayout(snapshot);
+		
+		snapshot.writeValue(randomSeed);
+		snapshot.writeValue(stepCount);
+		snapshot.writeValue(random.getSeed());
+		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			(*i)->saveState(snapshot);
+		
+		snapshot.writeValue(bluetoothBase != NULL);
+		if (bluetoothBase)
+			bluetoothBase->saveState(snapshot);
+	}
+	
+	bool World::restore(Snapshot& snapshot)
+	{
+		// check that the objects are the same as the ones of the snapshot before changing anything
+		snapshot.rewind();
+		size_t objectCount(0);
+		snapshot.readValue(objectCount);
+		if (!snapshot.good() || objectCount != objects.size())
+			return false;
+		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+		{
+			unsigned long objectUid(0);
+			snapshot.readValue(objectUid);
+			if (!snapshot.good() || objectUid != (*i)->uid)
+				return false;
+		}
+		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			(*i)->checkLayout(snapshot);
+		if (!snapshot.good())
+			return false;
+		
+		snapshot.readValue(randomSeed);
+		snapshot.readValue(stepCount);
+		unsigned long randomState(random.getSeed());
+		snapshot.readValue(randomState);
+		random.setSeed(randomState);
+		for (ObjectsIterator i = objects.begin(); i != objects.end(); ++i)
+			(*i)->restoreState(snapshot);
+		
+		bool hasBluetoothBase(false);
+		snapshot.readValue(hasBluetoothBase);
+		if (hasBluetoothBase)
+			getBluetoothBase()->restoreState(snapshot);
+		else if (bluetoothBase)
+		{
+			delete bluetoothBase;
+			bluetoothBase = NULL;
+		}
+		
+		return snapshot.good();
 	}
 	
 	void World::initBluetoothBase()
@@ -1149,5 +1864,12 @@ namespace Enki
 	
 		return bluetoothBase;
 	}
+	
+	const StaticScene* World::getStaticScene() const
+	{
+		if (broadphaseType == BROADPHASE_GRID && useStaticScene)
+			return &staticScene;
+		return 0;
+	}
 }
 
@@ -39,8 +39,14 @@
 #include "Random.h"
 #include "Interaction.h"
 #include "BluetoothBase.h"
+#include "SpatialGrid.h"
+#include "StaticScene.h"
+#include "GroundMap.h"
+#include "Snapshot.h"
 #include <iostream>
-#include <set>
+#include <cstddef>
+#include <iterator>
+#include <map>
 #include <vector>
 #include <valarray>
 
@@ -87,13 +93,40 @@
 	In objects, local interactions are sorted from long to short range so that once one is out
 	of range, the following will be too. This is the main optimization in Enki that permits large
 	colonies of robots. The complexity is still O(n2) so if very large colonies are required, a larger
-	scale, grid based optimization should be used. It is currently not implemented in Enki.
+	scale, grid based optimization should be used. Such an optimization is available for collisions and
+	local interactions by setting World::broadphaseType to World::BROADPHASE_GRID. Local interactions
+	of infinite range, such as cameras by default, still see all objects; limiting their range (for
+	instance using CircularCam::setRange()) lets them benefit from the grid as well. Mazes and other
+	large sets of fixed obstacles can be kept out of this grid, in a static scene that is only rebuilt
+	when they change, by setting World::useStaticScene.
+	When Enki is built with OpenMP, the physics can be simulated using several threads by setting
+	World::threadCount. Results are identical to a single-threaded simulation.
 	Physical dynamics between objects are the shortest ranged local interactions.
 	Local interactions can also interact with walls. Physical dynamics between objects and walls are
 	similar to local interactions with other objects, but use a different method of calculation.
 	
 	Global interactions are object <-> world.
 	
+	Setting World::parallelInteractions runs the local interactions and the control steps of different
+	objects concurrently, using World::threadCount threads. In that case, objects must respect the
+	following contract: LocalInteraction::init(), LocalInteraction::objectStep(),
+	LocalInteraction::wallsStep(), LocalInteraction::finalize() and PhysicalObject::controlStep() may
+	read the position, orientation, speed, shape and color of any object, but may only write to their
+	own interaction and to their owner. Global interactions might access shared state, such as the
+	Bluetooth base, so they are still run one object at a time.
+	
+	Noise should be drawn from the random streams of objects, given by PhysicalObject::getRandomStream().
+	These counter-based streams only depend on the seed of the world (World::setRandomSeed()), on the
+	identifier of the object, on the step number and on the identifier of the stream, so results are
+	reproducible whatever the number of threads and the order in which objects are processed.
+	A local interaction uses the stream LocalInteraction::getRandomStreamId() of its owner.
+	
+	The dynamic state of a world can be saved with World::snapshot() and brought back with
+	World::restore(), which is much faster than building the world again. Each object writes its
+	state in PhysicalObject::saveState() and robots forward to their interactions, so subclasses
+	keeping state from one step to the next must override these methods and their restoreState()
+	counterparts.
+	
 	\section state Development state
 	
 	The core, the IRSensor, and the basic Khepera, EPuck, Alice and Sbot features reflect real hardware and thus won't change much.
@@ -187,6 +220,11 @@ namespace Enki
 		// Geometry
 		
 		//! A part is one of the convex geometrical element that composes the physical object
+		/*!
+			The geometry and the textures of a part, which do not change once the object is set up, are
+			held by a prototype shared between the copies of the part, so that many objects built from
+			the same hull only store them once. A part copies its prototype before modifying it.
+		*/
 		class Part
 		{
 		public:
@@ -196,45 +234,75 @@ namespace Enki
 			Part(const Polygone& shape, double height, const Textures& textures);
 			//! Constructor, builds a rectangular part of size l1xl2, with a given height and color, and update radius
 			Part(double l1, double l2, double height);
+			//! Copy constructor, shares the prototype of that
+			Part(const Part& that);
+			//! Assignment operator, shares the prototype of that
+			Part& operator=(const Part& that);
+			//! Destructor, releases the prototype
+			~Part();
 			
 			//! Compute the shape of this part wrt a particular rotation and translation
 			void applyTransformation(const Matrix22& rot, const Point& trans, double* radius);
 			
 			// getters
-			inline double getHeight() const { return height; }
-			inline double getArea() const { return area; }
-			inline const Polygone& getShape() const { return shape; }
+			inline double getHeight() const { return prototype->height; }
+			inline double getArea() const { return prototype->area; }
+			inline double getSecondMomentOfArea() const { return prototype->secondMomentOfArea; }
+			inline const Polygone& getShape() const { return prototype->shape; }
 			inline const Polygone& getTransformedShape() const { return transformedShape; }
-			inline const Point& getCentroid() const { return centroid; }
+			inline const Point& getCentroid() const { return prototype->centroid; }
 			inline const Point& getTransformedCentroid() const { return transformedCentroid; }
-			inline const Textures& getTextures() const { return textures; }
-			inline bool isTextured() const { return !textures.empty(); }
+			inline const Textures& getTextures() const { return prototype->textures; }
+			inline bool isTextured() const { return !prototype->textures.empty(); }
+			//! Return whether this part shares its prototype with another part
+			inline bool isShared() const { return prototype->refCount > 1; }
 			
 		private:
 			friend class PhysicalObject;
-			// geometrical properties
 			
-			//! The height of the part, used for interaction with the sensors of other robots.
-			double height;
-			//! The area of this part
-			double area;
-			//! The shape of the part in object coordinates.
-			Polygone shape;
+			//! The immutable properties of a part, shared between its copies
+			struct Prototype
+			{
+				//! Number of parts using this prototype
+				unsigned refCount;
+				
+				// geometrical properties
+				
+				//! The height of the part, used for interaction with the sensors of other robots.
+				double height;
+				//! The area of this part
+				double area;
+				//! The polar second moment of area of this part around its centroid; multiplied by the density, it gives the moment of inertia
+				double secondMomentOfArea;
+				//! The shape of the part in object coordinates.
+				Polygone shape;
+				//! The centroid (barycenter) of the part in object coordinates.
+				Point centroid;
+				
+				// visual properties
+				
+				//! Texture for several faces of this object.
+				Textures textures;
+				
+				//! Constructor, builds a prototype used by a single part
+				Prototype(const Polygone& shape, double height) : refCount(1), height(height), shape(shape) {}
+				
+				//! Compute the area, the centroid (barycenter) and the second moment of area of this shape in object coordinates.
+				void computeMassProperties();
+			};
+			
+			//! The prototype of this part, never null
+			Prototype* prototype;
 			//! The shape of the part in world coordinates, updated on initPhysicsInteractions().
 			Polygone transformedShape;
-			//! The centroid (barycenter) of the part in object coordinates.
-			Point centroid;
 			//! The centroid (barycenter) of the part in world coordinates, updated on initPhysicsInteractions().
 			Point transformedCentroid;
-			
-			// visual properties
-			
-			//! Texture for several faces of this object.
-			Textures textures;
 		
 		private:
-			//! Compute the area and the centroid (barycenter) of this shape in object coordinates.
-			void computeAreaAndCentroid();
+			//! Release the prototype, deleting it if this part was its last user
+			void releasePrototype();
+			//! Make the prototype only used by this part, copying it if required, before modifying it
+			void detachPrototype();
 			//! Compute the shape of this part in world coordinates with respect to object
 			void computeTransformedShape(const Matrix22& rot, const Point& trans);
 		};
@@ -266,6 +334,28 @@ namespace Enki
 		//! How much this object did penetrate other objects in the course of physics steps since last control step
 		double interlacedDistance;
 		
+		// Sleeping
+		
+		//! Whether this object is asleep, in which case it is not simulated until it is woken up, see World::allowSleeping
+		bool sleeping;
+		//! Number of consecutive physics steps during which this object was at rest and without contact
+		unsigned restingSteps;
+		//! Whether this object collided since its last integration in initPhysicsInteractions()
+		bool inContact;
+		//! Position at which this object fell asleep, to detect that it was moved
+		Point sleepingPos;
+		//! Orientation at which this object fell asleep, to detect that it was turned
+		double sleepingAngle;
+		
+		// World
+		
+		//! Index of the slot of this object in World::objects, if it is in a world
+		size_t worldIndex;
+		//! Identifier of this object in its world, given in insertion order by World::addObject()
+		unsigned long uid;
+		//! Key of the random streams of this object for the current step, set by World::step() from the seed of the world, uid and the step number
+		uint64_t randomKey;
+		
 		// mass and inertia tensor
 		
 		//! The mass of the object. If below zero, the object can't move (infinite mass).
@@ -283,6 +373,14 @@ namespace Enki
 		double height;
 		//! The overall color of this object, if hull is empty or if it does not contain any texture
 		Color color;
+		//! Whether the transformed shapes of the parts of hull correspond to transformedShapePos and transformedShapeAngle
+		bool transformedShapeValid;
+		//! Position for which the transformed shapes of the parts of hull were last computed
+		Point transformedShapePos;
+		//! Orientation for which the transformed shapes of the parts of hull were last computed
+		double transformedShapeAngle;
+		//! Incremented whenever the hull or the radius changes, see getGeometryVersion()
+		unsigned geometryVersion;
 		
 	public:			// methods
 		
@@ -301,6 +399,13 @@ namespace Enki
 		inline double getMass() const { return mass; }
 		inline double getMomentOfInertia() const { return momentOfInertia; }
 		inline double getInterlacedDistance() const { return interlacedDistance; }
+		//! Return a number that changes whenever setCylindric(), setRectangular() or setCustomHull() is called, so that caches of the geometry can tell whether they are stale
+		inline unsigned getGeometryVersion() const { return geometryVersion; }
+		//! Return whether this object is asleep, see World::allowSleeping
+		inline bool isSleeping() const { return sleeping; }
+		inline unsigned long getUid() const { return uid; }
+		//! Return the random stream streamId of this object for the current step. Stream 0 is for the object itself, robots give the following ones to their local interactions
+		inline RandomStream getRandomStream(uint64_t streamId) const { return RandomStream(randomKey, streamId); }
 		
 		// setters
 		
@@ -312,6 +417,8 @@ namespace Enki
 		void setCustomHull(const Hull& hull, double mass);
 		//! Set the overall color of this object, if hull is empty or if it does not contain any texture
 		void setColor(const Color &color);
+		//! Wake this object up if it is asleep. Not required after changing its pose or its speeds, which wakes it up at the next step
+		void wakeUp();
 
 		enum ButtonCode
 		{
@@ -322,15 +429,26 @@ namespace Enki
 		//! called for robot if a click is performed on it
 		virtual void clickedInteraction(bool pressed, unsigned int buttonCode, double pointX, double pointY, double pointZ){};
 		
+		// state
+		
+		//! Write the dynamic state of this object, that is its pose, its speeds, its interlaced distance, its color and whether it is asleep. Subclasses keeping state from one step to the next must override this and call the parent method
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState() and update the transformed shape
+		virtual void restoreState(Snapshot& snapshot);
+		//! Write the sizes of the state that restoreState() cannot change, such as the ones of buffers, so that World::restore() can check them before changing anything
+		virtual void saveLayout(Snapshot& snapshot) const { }
+		//! Read the sizes written by saveLayout(), making snapshot fail if they differ from the current ones
+		virtual void checkLayout(Snapshot& snapshot) const { }
+		
 	private:		// setup methods
 		
 		//! When a physical parameter (color, shape, ...) has been changed, the user data must be updated.
 		void dirtyUserData();
-		//! Compute the moment of inertia tensor depending on radius, mass, height, and hull, assuming that the hull is centered around the center of mass, which is done by setupCentorOfMass()
+		//! Compute the moment of inertia tensor around the origin of the object depending on radius, mass, and hull, assuming that the hull is centered around the center of mass, which is done by setupCentorOfMass(); mass is uniformly distributed over the parts of the hull
 		void computeMomentOfInertia();
 		//! Compute the center of mass and move bounding surfaces accordingly. Does not update the moment of inertia tensor.
 		void setupCenterOfMass();
-		//! Compute the hull of this object in world coordinates.
+		//! Compute the hull of this object in world coordinates, if pos or angle changed since last time or if the hull changed.
 		void computeTransformedShape();
 	
 	protected:		// physical actions
@@ -349,6 +467,10 @@ namespace Enki
 		virtual void initLocalInteractions(double dt, World* w) { }
 		//! Do the interactions with the other PhysicalObject, do nothing for PhysicalObject.
 		virtual void doLocalInteractions(double dt, World *w, PhysicalObject *o) { }
+		//! Return the range of the longest local interaction, 0 for PhysicalObject. When using BROADPHASE_GRID, doLocalInteractions() is only called for objects whose bounding circle (or bounding box for static objects with World::useStaticScene) is within this range, so subclasses overriding doLocalInteractions() must override this as well.
+		virtual double getLocalInteractionsRange() const { return 0; }
+		//! Do the interactions with the objects of infinite mass of scene that local interactions query themselves, do nothing for PhysicalObject.
+		virtual void doStaticSceneInteractions(double dt, World* w, const StaticScene& scene) { }
 		//! Do the interactions with the walls of world w, do nothing for PhysicalObject.
 		virtual void doLocalWallsInteraction(double dt, World* w) { }
 		//! All interactions are finished, do nothing for PhysicalObject.
@@ -367,6 +489,10 @@ namespace Enki
 		void initPhysicsInteractions(double dt);
 		//! All collisions are finished, deinterlace the object.
 		void finalizePhysicsInteractions(double dt);
+		//! Put the object to sleep if it stayed at rest and without contact for sleepDelay physics steps, its speeds being below sleepSpeedThreshold
+		void updateSleeping(double sleepSpeedThreshold, unsigned sleepDelay);
+		//! Return whether the pose or the speeds of this sleeping object were changed since it fell asleep
+		bool isDisturbed() const;
 		
 		//! Dynamics for collision with a static object at points cp with normal vector n
 		void collideWithStaticObject(const Vector &n, const Point &cp);
@@ -393,6 +519,10 @@ namespace Enki
 		virtual void initLocalInteractions(double dt, World* w);
 		//! Do the local interactions with other objects, call objectStep on each one.
 		virtual void doLocalInteractions(double dt, World *w, PhysicalObject *po);
+		//! Return the range of the longest local interaction.
+		virtual double getLocalInteractionsRange() const;
+		//! Do the local interactions with the static objects of scene, call staticSceneStep on each one that uses the static scene.
+		virtual void doStaticSceneInteractions(double dt, World* w, const StaticScene& scene);
 		//! Do the local interactions with walls, call wallsStep on each one.
 		virtual void doLocalWallsInteraction(double dt, World* w);
 		//! All the local interactions are finished, call finalize on each one.
@@ -400,6 +530,14 @@ namespace Enki
 		
 		//! Do the global interactions, call step on each one.
 		virtual void doGlobalInteractions(double dt, World* w);
+		//! Write the state of the object and of its local and global interactions
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state of the object and of its local and global interactions
+		virtual void restoreState(Snapshot& snapshot);
+		//! Write the layout of the object and of its local and global interactions
+		virtual void saveLayout(Snapshot& snapshot) const;
+		//! Check the layout of the object and of its local and global interactions
+		virtual void checkLayout(Snapshot& snapshot) const;
 		//! Sort local interactions. Called by addLocalInteraction ; can be called by subclasses in case of interaction radius change.
 		void sortLocalInteractions(void);
 	};
@@ -419,6 +557,13 @@ namespace Enki
 			WALLS_NONE			//!< no walls
 		};
 		
+		//! Method used to find the pairs of objects that might collide
+		enum BroadphaseType
+		{
+			BROADPHASE_ALL_PAIRS = 0,	//!< test all pairs of objects, O(n2)
+			BROADPHASE_GRID				//!< only test pairs of objects in neighbouring cells of a uniform grid, O(n) for evenly spread objects
+		};
+		
 		//! type of walls this world is using
 		const WallsType wallsType;
 		//! The width of the world, if wallsType is WALLS_SQUARE
@@ -452,24 +597,195 @@ namespace Enki
 		//! Current ground texture
 		const GroundTexture groundTexture;
 		
-		typedef std::set<PhysicalObject *> Objects;
+		//! Container of the objects of the world, in insertion order
+		/*!
+			Objects are stored contiguously in a vector of slots. Removing an object empties its slot,
+			which is skipped when iterating, so that the indices of the other objects do not change
+			until compact() is called. An object can only be in one world at a time.
+		*/
+		class Objects
+		{
+		public:
+			//! Iterator over the objects, skipping empty slots
+			class iterator
+			{
+			public:
+				typedef std::forward_iterator_tag iterator_category;
+				typedef PhysicalObject* value_type;
+				typedef std::ptrdiff_t difference_type;
+				typedef PhysicalObject* const* pointer;
+				typedef PhysicalObject* const& reference;
+				
+				//! Construct an invalid iterator
+				iterator() : slot(0), lastSlot(0) {}
+				//! Construct an iterator on slot, skipping empty slots until lastSlot
+				iterator(pointer slot, pointer lastSlot) : slot(slot), lastSlot(lastSlot) { skipEmptySlots(); }
+				
+				//! Return the object
+				reference operator*() const { return *slot; }
+				//! Go to the next object
+				iterator& operator++() { ++slot; skipEmptySlots(); return *this; }
+				//! Go to the next object, return the iterator on the current one
+				iterator operator++(int) { iterator it(*this); ++(*this); return it; }
+				//! Return whether two iterators are on the same slot
+				bool operator==(const iterator& that) const { return slot == that.slot; }
+				//! Return whether two iterators are on different slots
+				bool operator!=(const iterator& that) const { return slot != that.slot; }
+				
+			protected:
+				//! Skip empty slots
+				void skipEmptySlots() { while (slot != lastSlot && *slot == 0) ++slot; }
+				
+				//! Current slot
+				pointer slot;
+				//! Slot past the last one
+				pointer lastSlot;
+			};
+			typedef iterator const_iterator;
+			
+		public:
+			//! Construct an empty container
+			Objects() : count(0) {}
+			
+			//! Return an iterator on the first object
+			iterator begin() const { return slots.empty() ? iterator() : iterator(&slots[0], &slots[0] + slots.size()); }
+			//! Return an iterator past the last object
+			iterator end() const { return slots.empty() ? iterator() : iterator(&slots[0] + slots.size(), &slots[0] + slots.size()); }
+			//! Return the number of objects
+			size_t size() const { return count; }
+			//! Return whether there is no object
+			bool empty() const { return count == 0; }
+			//! Return the number of slots, including the empty ones
+			size_t slotCount() const { return slots.size(); }
+			//! Return the object in slot, or 0 if the slot is empty
+			PhysicalObject* operator[](size_t slot) const { return slots[slot]; }
+			//! Return whether o is in this container, in O(1)
+			bool contains(const PhysicalObject* o) const { return o->worldIndex < slots.size() && slots[o->worldIndex] == o; }
+			//! Add o after all other objects and return true, or return false if o is already in this container
+			bool insert(PhysicalObject* o);
+			//! Remove o in O(1) and return true, or return false if o is not in this container
+			bool erase(PhysicalObject* o);
+			//! Remove the empty slots, keeping the order of objects
+			void compact();
+			
+		protected:
+			//! Objects in insertion order, 0 for empty slots
+			std::vector<PhysicalObject *> slots;
+			//! Number of non-empty slots
+			size_t count;
+		};
 		typedef Objects::iterator ObjectsIterator;
 		
 		//! Whether the world should delete the objects upon destruction, true by default
 		bool takeObjectOwnership;
+		//! Broadphase used to find colliding and interacting objects, BROADPHASE_ALL_PAIRS by default. Both give the same results unless collisions push objects by more than the largest object radius within a physics step, BROADPHASE_GRID is faster for large worlds
+		BroadphaseType broadphaseType;
+		//! Whether objects of infinite mass are kept in a StaticScene, separate from the grid of the other objects, when using BROADPHASE_GRID, false by default
+		/*!
+			The static scene indexes the bounding boxes of static objects and is only rebuilt when
+			static objects are added, removed, moved, or when their bounding radius changes. Many
+			walls and fixed obstacles, even long ones, therefore neither enlarge the cells of the grid
+			nor get tested against distant objects for collisions and local interactions. Results do
+			not depend on it, as long as local interactions ignore objects beyond their range: static
+			objects are passed to PhysicalObject::doLocalInteractions() when their bounding box, rather
+			than their bounding circle, is within range. Local interactions whose
+			LocalInteraction::usesStaticScene() returns true, such as IRSensor, do not get static objects
+			there but query the scene themselves, for instance with rays. Cameras keep getting all static
+			objects within their range, as they project whole objects rather than casting rays.
+		*/
+		bool useStaticScene;
+		//! Number of threads used to simulate physics, 1 by default. Results do not depend on it. Requires OpenMP, collisions are only multithreaded with BROADPHASE_GRID. When larger than 1, PhysicalObject::applyForces() and PhysicalObject::collisionEvent() might be called concurrently on different objects
+		unsigned threadCount;
+		//! Whether local interactions and control steps of different objects run in parallel using threadCount threads, false by default. See the contract in the main page. Results do not depend on it, as long as noise is drawn from the random streams of objects (see PhysicalObject::getRandomStream())
+		bool parallelInteractions;
+		//! Whether objects whose type is exactly PhysicalObject fall asleep when at rest, false by default
+		/*!
+			An object whose speeds stay below sleepSpeedThreshold without any contact during sleepDelay
+			physics steps falls asleep: its speeds are set to zero and it is neither integrated nor
+			collided with walls, static objects or other sleeping objects, but it remains visible to
+			sensors. It is woken up by a collision with an awake object, by PhysicalObject::wakeUp(),
+			or at the next step if its pose or its speeds are changed. With a sleepSpeedThreshold of 0,
+			only objects brought to a standstill by dry friction fall asleep and results are identical
+			to a simulation without sleeping.
+		*/
+		bool allowSleeping;
+		//! Speed and angular speed below which an object is considered at rest, 0 by default
+		double sleepSpeedThreshold;
+		//! Number of physics steps an object must stay at rest without contact before falling asleep, 10 by default
+		unsigned sleepDelay;
 		
 		//! All the objects in the world
 		Objects objects;
 		//! Base for the Bluetooth connections between robots
 		BluetoothBase* bluetoothBase;
+		
+	protected:
+		//! Objects in the order of iteration of objects, updated at the beginning of every step and before local interactions when using the grid broadphase
+		std::vector<PhysicalObject *> orderedObjects;
+		//! Grid of objects used by the grid broadphase, rebuilt before collisions and before local interactions
+		SpatialGrid objectsGrid;
+		//! Temporary storage of the candidates for collisions or local interactions with a given object
+		SpatialGrid::Indices neighbours;
+		//! Temporary storage of the candidates that are dynamic objects, when using the static scene
+		SpatialGrid::Indices dynamicNeighbours;
+		//! Temporary storage of the candidates that are static objects, when using the static scene
+		SpatialGrid::Indices staticNeighbours;
+		//! Objects of infinite mass, when using the static scene
+		StaticScene staticScene;
+		//! Objects of orderedObjects that are not static, in the same order, from which objectsGrid is built when using the static scene
+		std::vector<PhysicalObject *> dynamicObjects;
+		//! For every object of dynamicObjects, its index in orderedObjects
+		std::vector<unsigned> dynamicObjectIndices;
+		//! For every object of orderedObjects, its index in dynamicObjects, or the largest unsigned if it is static
+		std::vector<unsigned> gridIndices;
+		//! For every object of orderedObjects, the candidates for collisions, when multithreaded
+		std::vector<SpatialGrid::Indices> collisionCandidates;
+		//! Disjoint set forest of objects in contact through dynamic objects, indices of parents in orderedObjects, when multithreaded
+		std::vector<unsigned> islandParents;
+		//! For every island, the index of its first pair in islandPairs, and the end of the last island
+		std::vector<unsigned> islandPairsStart;
+		//! Candidate pairs of objects for collisions, grouped by island, in the order of collideNeighbouringObjects() within an island
+		std::vector<std::pair<unsigned, unsigned> > islandPairs;
+		//! Unique identifier of this world, never reused by another world
+		const unsigned long uid;
+		//! Seed of the random streams of objects
+		unsigned long randomSeed;
+		//! Number of steps done so far
+		unsigned long stepCount;
+		//! Identifier of the next object added to this world
+		unsigned long nextObjectUid;
+		//! Ground maps built so far, by standard deviation of the kernel of ground sensors
+		mutable std::map<double, GroundMap> groundMaps;
 
 	protected:
+		//! Collide all pairs of objects
+		void collideAllPairsOfObjects();
+		//! Build objectsGrid from orderedObjects and, when using the static scene, rebuild staticScene if it is out of date
+		void buildBroadphase();
+		//! Append to candidates the indices j > i of objects of orderedObjects that might collide with object i, in increasing order, using the scratch vectors as temporary storage
+		void getCollisionCandidates(unsigned i, SpatialGrid::Indices& candidates, SpatialGrid::Indices& dynamicScratch, SpatialGrid::Indices& staticScratch) const;
+		//! Append to neighbours the indices of objects of orderedObjects within range of center, in increasing order, using the scratch vectors as temporary storage
+		void getNeighbours(const Point& center, double range, SpatialGrid::Indices& neighbours, SpatialGrid::Indices& dynamicScratch, SpatialGrid::Indices& staticScratch) const;
+		//! Collide the pairs of objects that are close to each other, as found by objectsGrid
+		void collideNeighbouringObjects();
+		//! Collide the pairs of objects that are close to each other using threadCount threads, by colliding independent islands of objects in parallel
+		void collideNeighbouringObjectsInParallel();
+		//! Return the root of the island of object i, compressing the path to it
+		unsigned findIsland(unsigned i);
+		//! Do the local interactions of all objects with all other objects
+		void interactAllPairsOfObjects(double dt);
+		//! Do the local interactions of all objects with the objects within their range, as found by objectsGrid
+		void interactNeighbouringObjects(double dt);
+		//! Do the interactions and the control step of all objects, running the local parts in parallel
+		void stepInteractionsInParallel(double dt);
 		//! Collide two objects. Correct functions will be called depending on type of object (circular or other shape).
 		void collideObjects(PhysicalObject *object1, PhysicalObject *object2);
 		//! Collide the object with square walls.
 		void collideWithSquareWalls(PhysicalObject *object);
 		//! Collide the object with circular walls.
 		void collideWithCircularWalls(PhysicalObject *object);
+		//! Collide object with the walls, finalize its physics step and update its sleeping state, if it is awake
+		void finalizePhysicsInteractions(PhysicalObject* o, double dt);
 
 	public:
 		//! Construct a world with square walls, takes width and height of the world arena in cm.
@@ -485,6 +801,10 @@ namespace Enki
 		bool hasGroundTexture() const;
 		//! Return the color of the ground at a given point, or white.
 		Color getGroundColor(const Point& p) const;
+		//! Return the ground intensity filtered for ground sensors of standard deviation spatialSd, built on first call and valid as long as the world exists. Thread-safe
+		const GroundMap* getGroundMap(double spatialSd) const;
+		//! Return the unique identifier of this world, which allows to detect that a cached pointer to a world now refers to another one
+		unsigned long getUid() const { return uid; }
 		
 		//! Simulate a timestep of dt. dt should be below 1 (typically .02-.1); physicsOversampling is the amount of time the physics is run per step, as usual collisions require a more precise simulation than the sensor-motor loop frequency.
 		virtual void step(double dt, unsigned physicsOversampling = 1);
@@ -496,12 +816,35 @@ namespace Enki
 		//! Set to 0 the userData member of all object whose value userData->deletedWithObject are false; call this before the creator of user data is destroyed, this method is typically called from a viewer just before its destruction.
 		void disconnectExternalObjectsUserData();
 		
-		//! Set the seed of the random generator.
+		//! Set the seed of the random generators, both the global one and the random streams of objects.
 		void setRandomSeed(unsigned long seed);
+		//! Return the seed of the random streams of objects
+		unsigned long getRandomSeed() const { return randomSeed; }
+		//! Return the number of steps done so far
+		unsigned long getStepCount() const { return stepCount; }
+		
+		//! Write the dynamic state of the world into snapshot, replacing its content
+		/*!
+			The state comprises the step number, the seeds of the random generators, the dynamic state
+			of every object (see PhysicalObject::saveState()) and the Bluetooth base. Writing again into
+			the same snapshot does not allocate memory, as long as the world did not grow. The state of
+			the random generator of the C library, used by uniformRand(), cannot be saved.
+		*/
+		void snapshot(Snapshot& snapshot) const;
+		//! Bring the world back to the state written by snapshot()
+		/*!
+			The world must contain the same objects, added in the same order, with the same sizes of
+			buffers (see PhysicalObject::saveLayout()), as when the snapshot was taken; otherwise,
+			nothing is changed and false is returned. Also return false if the content
+			of the snapshot is inconsistent, in which case the state of the world is undefined.
+		*/
+		bool restore(Snapshot& snapshot);
 		//! Initialise and activate the Bluetooth base
 		void initBluetoothBase();
 		//! Return the address of the Bluetooth base
 		BluetoothBase* getBluetoothBase();
+		//! Return the scene of objects of infinite mass if they are kept in one during this step (see useStaticScene), 0 otherwise
+		const StaticScene* getStaticScene() const;
 	
 	protected:
 		//! Can implement world specific control. By default do nothing
@@ -0,0 +1,87 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "Random.h"
+
+/*!	\file Random.cpp
+	\brief The random generators shared between threads
+*/
+
+// these generators use OpenMP critical sections, so they are not inline: only enki is compiled with OpenMP
+
+namespace Enki
+{
+	unsigned long FastRandom::get(void)
+	{
+		unsigned long value;
+		#pragma omp critical(EnkiFastRandom)
+		value = (randx = randx*1103515245 + 12345) & 0x7fffffff;
+		return value;
+	}
+	
+	double uniformRand(void)
+	{
+		int value;
+		#pragma omp critical(EnkiRand)
+		value = rand();
+		return double(value)/RAND_MAX;
+	}
+	
+	unsigned intRand(unsigned max)
+	{
+		if (max)
+		{
+			int value;
+			#pragma omp critical(EnkiRand)
+			value = rand();
+			return value % max;
+		}
+		else
+			return 0;
+	}
+	
+	double gaussianRand(double mean, double sigm)
+	{
+		// Box-Muller transform, without rejection so that it has no loop;
+		// the first uniform number is in ]0;1] so that its logarithm is finite
+		int value0, value1;
+		#pragma omp critical(EnkiRand)
+		{
+			value0 = rand();
+			value1 = rand();
+		}
+		const double u0((double(value0) + 1) / (double(RAND_MAX) + 1));
+		const double u1(double(value1) / (double(RAND_MAX) + 1));
+		return sigm * sqrt(-2.0 * log(u0)) * cos(2 * M_PI * u1) + mean;
+	}
+}
@@ -36,6 +36,7 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <stdint.h>
 
 /*!	\file Random.h
 	\brief The mathematic classes for random work
@@ -55,18 +56,17 @@ namespace Enki
 		FastRandom(void) { randx = 0; }
 		//! Set the seed
 		void setSeed(unsigned long seed) { randx = seed; }
-		//! Get a random number between 0 and 2^31
-		unsigned long get(void) { return (randx = randx*1103515245 + 12345) & 0x7fffffff; }
+		//! Return the current state, from which setSeed() continues the same sequence
+		unsigned long getSeed() const { return randx; }
+		//! Get a random number between 0 and 2^31, safe to call from several threads
+		unsigned long get(void);
 		//! Get a random double between 0 and range, use get() internally
 		double getRange(double range) { return (static_cast<double>(get()) * range) / 2147483648.0; }
 	};
 	
-	//! Return a number in [0;1[ in a uniform distribution
+	//! Return a number in [0;1[ in a uniform distribution, safe to call from several threads
 	/*! \ingroup an */
-	inline double uniformRand(void)
-	{
-		return double(rand())/RAND_MAX;
-	}
+	double uniformRand(void);
 	
 	//! Functor to be used with \<algorithm\>
 	struct UniformRand
@@ -83,13 +83,7 @@ namespace Enki
 	
 	//! Return a number between [0;max[ in integer in a uniform distribution
 	/*! \ingroup an */
-	inline unsigned intRand(unsigned max)
-	{
-		if (max)
-			return rand() % max;
-		else
-			return 0;
-	}
+	unsigned intRand(unsigned max);
 	
 	//! Return true with a probability prob. If no argument is given, prob = 0.5
 	/*! \ingroup an */
@@ -100,27 +94,63 @@ namespace Enki
 	
 	//! Return a random number with a gaussian distribution of a certain mean and standard deviation.
 	/*! \ingroup an */
-	inline double gaussianRand(double mean, double sigm)
+	double gaussianRand(double mean, double sigm);
+	
+	//! A counter-based random generator, giving reproducible streams of random numbers
+	/*! \ingroup an
+		A stream is identified by a key, typically made from the seed of the world, the identifier of
+		an object, the step number and the identifier of the stream within the object. The n-th number
+		of a stream only depends on its key and on n, using the mixing function of SplitMix64, so
+		streams can be used concurrently and in any order without changing the numbers they give.
+	*/
+	class RandomStream
 	{
-		// Generation using the Polar (Box-Mueller) method.
-		// Code inspired by GSL, which is a really great math lib.
-		// http://sources.redhat.com/gsl/
-		// C++ wrapper available.
-		// http://gslwrap.sourceforge.net/
-		double r, x, y;
+	protected:
+		//! Key of the stream
+		uint64_t key;
+		//! Number of values drawn so far
+		uint64_t counter;
+		
+	public:
+		//! Increment of SplitMix64, the golden ratio in fixed point
+		static const uint64_t increment = 0x9e3779b97f4a7c15ULL;
 		
-		// Generate random number in unity circle.
-		do
+		//! Construct the stream of a given key
+		RandomStream(uint64_t key = 0) : key(key), counter(0) {}
+		//! Construct the stream of a given key, derived from the key of a parent stream and an identifier
+		RandomStream(uint64_t parentKey, uint64_t id) : key(combine(parentKey, id)), counter(0) {}
+		
+		//! Return the SplitMix64 mixing of z
+		static uint64_t mix(uint64_t z)
 		{
-			x = uniformRand()*2 - 1;
-			y = uniformRand()*2 - 1;
-			r = x*x + y*y;
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+			return z ^ (z >> 31);
 		}
-		while (r > 1.0 || r == 0);
+		//! Return a key derived from key and id
+		static uint64_t combine(uint64_t key, uint64_t id) { return mix(key + increment + mix(id + increment)); }
 		
-		// Box-Muller transform.
-		return sigm * y * sqrt (-2.0 * log(r) / r) + mean;
-	}
+		//! Return the key of this stream
+		uint64_t getKey() const { return key; }
+		//! Return the index of the next value
+		uint64_t tell() const { return counter; }
+		//! Set the index of the next value
+		void seek(uint64_t index) { counter = index; }
+		
+		//! Return the next 64 bits random number
+		uint64_t get() { return mix(key + (++counter) * increment); }
+		//! Return the next random double in [0;1[
+		double uniform() { return double(get() >> 11) * (1.0 / 9007199254740992.0); }
+		//! Return the next random double in [0;range[
+		double getRange(double range) { return uniform() * range; }
+		//! Return the next random number with a gaussian distribution of mean and standard deviation sd; it uses two values of the stream
+		double gaussian(double mean, double sd)
+		{
+			const double u0(1 - uniform());
+			const double u1(uniform());
+			return sd * sqrt(-2.0 * log(u0)) * cos(2 * M_PI * u1) + mean;
+		}
+	};
 }
 
 #endif
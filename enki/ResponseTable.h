@@ -0,0 +1,89 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef __ENKI_RESPONSETABLE_H
+#define __ENKI_RESPONSETABLE_H
+
+/*!	\file ResponseTable.h
+	\brief A tabulated response function of a sensor
+*/
+
+namespace Enki
+{
+	//! A function tabulated on Size regularly spaced samples over [xMin; xMax] and linearly interpolated
+	/*! \ingroup core
+		It replaces costly analytical sensor responses; it is meant to be built once per sensor model,
+		for instance as a static object, with Size chosen such that the interpolation error is below
+		the noise of the sensor. Outside [xMin; xMax], the value at the closest bound is returned.
+	*/
+	template<unsigned Size>
+	class ResponseTable
+	{
+	protected:
+		//! Lower bound of the tabulated interval
+		double xMin;
+		//! Inverse of the distance between samples
+		double invStep;
+		//! Values of the function at the samples
+		double values[Size];
+		
+	public:
+		//! Tabulate function, which must be callable as double function(double), over [xMin; xMax]
+		template<typename Function>
+		ResponseTable(Function function, double xMin, double xMax) :
+			xMin(xMin),
+			invStep((Size - 1) / (xMax - xMin))
+		{
+			// fails to compile if the table cannot be interpolated
+			(void)sizeof(char[Size >= 2 ? 1 : -1]);
+			for (unsigned i = 0; i < Size; ++i)
+				values[i] = function(xMin + (xMax - xMin) * double(i) / double(Size - 1));
+		}
+		
+		//! Return the interpolated value of the function at x
+		double operator()(double x) const
+		{
+			const double u((x - xMin) * invStep);
+			if (!(u > 0))
+				return values[0];
+			if (u >= Size - 1)
+				return values[Size - 1];
+			const unsigned i(static_cast<unsigned>(u));
+			const double t(u - i);
+			return values[i] + t * (values[i + 1] - values[i]);
+		}
+	};
+}
+
+#endif
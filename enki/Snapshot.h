@@ -0,0 +1,197 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef __ENKI_SNAPSHOT_H
+#define __ENKI_SNAPSHOT_H
+
+#include <vector>
+#include <valarray>
+#include <queue>
+#include <cstring>
+
+/*!	\file Snapshot.h
+	\brief A memory buffer holding the dynamic state of a world
+*/
+
+namespace Enki
+{
+	//! A flat buffer into which objects write their dynamic state and from which they read it back
+	/*! \ingroup core
+		Values are copied bytewise, so only plain data such as numbers, Point or Color must be
+		written with writeValue() and writeArray(). Values must be read back in the order in
+		which they were written. clear() keeps the memory of the buffer, so that writing the
+		same state again into a snapshot does not allocate memory. Reading past the end of the
+		snapshot or reading an array of a different size than the one written makes good()
+		return false, and leaves the destination unchanged.
+	*/
+	class Snapshot
+	{
+	protected:
+		//! The content of the snapshot
+		std::vector<char> data;
+		//! Position of the next read in data
+		size_t readPos;
+		//! Whether a read failed since the last rewind()
+		bool readFailed;
+		
+	public:
+		//! Construct an empty snapshot
+		Snapshot() : readPos(0), readFailed(false) {}
+		
+		//! Empty the snapshot, keeping its memory for the next writes
+		void clear() { data.clear(); rewind(); }
+		//! Read again from the beginning of the snapshot
+		void rewind() { readPos = 0; readFailed = false; }
+		//! Return the size of the content of the snapshot in bytes
+		size_t size() const { return data.size(); }
+		//! Return whether the snapshot is empty
+		bool empty() const { return data.empty(); }
+		//! Return whether all reads since the last rewind() succeeded
+		bool good() const { return !readFailed; }
+		//! Make good() return false, for readers finding values that are inconsistent with the current state
+		void fail() { readFailed = true; }
+		
+		//! Append size bytes from source
+		void writeBytes(const void* source, size_t size)
+		{
+			if (size == 0)
+				return;
+			const size_t pos(data.size());
+			data.resize(pos + size);
+			memcpy(&data[pos], source, size);
+		}
+		//! Read size bytes into dest
+		void readBytes(void* dest, size_t size)
+		{
+			if (readFailed || readPos + size > data.size())
+			{
+				readFailed = true;
+				return;
+			}
+			if (size == 0)
+				return;
+			memcpy(dest, &data[readPos], size);
+			readPos += size;
+		}
+		
+		//! Append a plain value
+		template<typename T>
+		void writeValue(const T& value) { writeBytes(&value, sizeof(T)); }
+		//! Read a plain value
+		template<typename T>
+		void readValue(T& value) { readBytes(&value, sizeof(T)); }
+		//! Read a plain value, fail if it differs from expected
+		template<typename T>
+		void readExpectedValue(const T& expected)
+		{
+			T value(expected);
+			readValue(value);
+			if (value != expected)
+				readFailed = true;
+		}
+		
+		//! Append count plain values and their number
+		template<typename T>
+		void writeArray(const T* values, size_t count)
+		{
+			writeValue(count);
+			writeBytes(values, count * sizeof(T));
+		}
+		//! Read count plain values, fail if a different number of values was written
+		template<typename T>
+		void readArray(T* values, size_t count)
+		{
+			size_t writtenCount(0);
+			readValue(writtenCount);
+			if (writtenCount != count)
+				readFailed = true;
+			readBytes(values, count * sizeof(T));
+		}
+		
+		//! Append the content of a vector of plain values
+		template<typename T>
+		void writeArray(const std::vector<T>& values) { writeArray(values.empty() ? 0 : &values[0], values.size()); }
+		//! Read the content of a vector of plain values, resizing it if its size changed since it was written
+		template<typename T>
+		void readArray(std::vector<T>& values) { values.resize(peekCount()); readArray(values.empty() ? 0 : &values[0], values.size()); }
+		//! Append the content of a valarray of plain values
+		template<typename T>
+		void writeArray(const std::valarray<T>& values) { writeArray(values.size() ? &const_cast<std::valarray<T>&>(values)[0] : 0, values.size()); }
+		//! Read the content of a valarray of plain values, resizing it if its size changed since it was written
+		template<typename T>
+		void readArray(std::valarray<T>& values)
+		{
+			const size_t count(peekCount());
+			if (count != values.size())
+				values.resize(count);
+			readArray(values.size() ? &values[0] : 0, values.size());
+		}
+		
+		//! Append the content of a queue of plain values
+		template<typename T>
+		void writeQueue(const std::queue<T>& values)
+		{
+			std::queue<T> remaining(values);
+			writeValue(remaining.size());
+			for (; !remaining.empty(); remaining.pop())
+				writeValue(remaining.front());
+		}
+		//! Replace the content of a queue of plain values by the one read
+		template<typename T>
+		void readQueue(std::queue<T>& values)
+		{
+			values = std::queue<T>();
+			size_t count(0);
+			readValue(count);
+			for (size_t i = 0; i < count && !readFailed; ++i)
+			{
+				T value;
+				readValue(value);
+				values.push(value);
+			}
+		}
+		
+	protected:
+		//! Return the number of values of the array at the read position, or 0 if there is none
+		size_t peekCount() const
+		{
+			size_t count(0);
+			if (!readFailed && readPos + sizeof(count) <= data.size())
+				memcpy(&count, &data[readPos], sizeof(count));
+			return count;
+		}
+	};
+}
+
+#endif
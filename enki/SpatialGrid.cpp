@@ -0,0 +1,172 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "SpatialGrid.h"
+#include "PhysicalEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+/*!	\file SpatialGrid.cpp
+	\brief Implementation of the uniform grid to find the objects that are close to each others
+*/
+
+namespace Enki
+{
+	SpatialGrid::SpatialGrid() :
+		maxRadius(0)
+	{
+	}
+	
+	void SpatialGrid::build(const std::vector<PhysicalObject *>& objects, double minCellSize)
+	{
+		const size_t objectCount(objects.size());
+		positions.resize(objectCount);
+		radii.resize(objectCount);
+		objectCells.resize(objectCount);
+		entries.resize(objectCount);
+		maxRadius = 0;
+		
+		if (objectCount == 0)
+		{
+			clear();
+			return;
+		}
+		
+		// collect the bounding circles and their extent
+		Point bottomLeft(objects[0]->pos);
+		Point topRight(objects[0]->pos);
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			const PhysicalObject* o(objects[i]);
+			positions[i] = o->pos;
+			radii[i] = o->getRadius();
+			maxRadius = std::max(maxRadius, radii[i]);
+			bottomLeft.x = std::min(bottomLeft.x, o->pos.x);
+			bottomLeft.y = std::min(bottomLeft.y, o->pos.y);
+			topRight.x = std::max(topRight.x, o->pos.x);
+			topRight.y = std::max(topRight.y, o->pos.y);
+		}
+		
+		// the side of cells is at least the diameter of the largest object
+		fitCells(bottomLeft, topRight, std::max(minCellSize, 2 * maxRadius), objectCount);
+		
+		// bucket objects using a counting sort, which keeps them by increasing index within a cell
+		const size_t cellCount(width * height);
+		cellStart.assign(cellCount + 1, 0);
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			const int x(cellCoordinate(positions[i].x, origin.x, width));
+			const int y(cellCoordinate(positions[i].y, origin.y, height));
+			objectCells[i] = y * width + x;
+			++cellStart[objectCells[i] + 1];
+		}
+		for (size_t c = 0; c < cellCount; ++c)
+			cellStart[c + 1] += cellStart[c];
+		std::vector<unsigned> cursors(cellStart.begin(), cellStart.end() - 1);
+		for (size_t i = 0; i < objectCount; ++i)
+			entries[cursors[objectCells[i]]++] = i;
+	}
+	
+	void SpatialGrid::clear()
+	{
+		clearCells();
+		maxRadius = 0;
+		objectCells.clear();
+		positions.clear();
+		radii.clear();
+	}
+	
+	void SpatialGrid::getCollisionCandidates(unsigned i, double margin, Indices& candidates) const
+	{
+		assert(i < objectCells.size());
+		const size_t firstCandidate(candidates.size());
+		const int cx(objectCells[i] % width);
+		const int cy(objectCells[i] / width);
+		// neighbouring cells are enough if they are larger than the farthest candidate, otherwise look further
+		const double reach(radii[i] + maxRadius + margin);
+		const int rings(reach <= cellSize ? 1 : int(ceil(reach / cellSize)));
+		for (int y = std::max(cy - rings, 0); y <= std::min(cy + rings, height - 1); ++y)
+		{
+			for (int x = std::max(cx - rings, 0); x <= std::min(cx + rings, width - 1); ++x)
+			{
+				const unsigned cell(y * width + x);
+				for (unsigned e = cellStart[cell]; e < cellStart[cell + 1]; ++e)
+				{
+					const unsigned j(entries[e]);
+					const double limit(radii[i] + radii[j] + margin);
+					if (j > i && (positions[j] - positions[i]).norm2() <= limit * limit)
+						candidates.push_back(j);
+				}
+			}
+		}
+		std::sort(candidates.begin() + firstCandidate, candidates.end());
+	}
+	
+	void SpatialGrid::getNeighbours(const Point& center, double range, Indices& neighbours) const
+	{
+		if (positions.empty())
+			return;
+		
+		// if the range covers the whole grid, just scan all objects
+		int x0, y0, x1, y1;
+		if (getCoveredCells(center, range + maxRadius, x0, y0, x1, y1))
+		{
+			for (unsigned j = 0; j < positions.size(); ++j)
+			{
+				const double limit(range + radii[j]);
+				if ((positions[j] - center).norm2() <= limit * limit)
+					neighbours.push_back(j);
+			}
+			return;
+		}
+		
+		// otherwise only look into the cells covered by the range
+		const size_t firstNeighbour(neighbours.size());
+		for (int y = y0; y <= y1; ++y)
+		{
+			for (int x = x0; x <= x1; ++x)
+			{
+				const unsigned cell(y * width + x);
+				for (unsigned e = cellStart[cell]; e < cellStart[cell + 1]; ++e)
+				{
+					const unsigned j(entries[e]);
+					const double limit(range + radii[j]);
+					if ((positions[j] - center).norm2() <= limit * limit)
+						neighbours.push_back(j);
+				}
+			}
+		}
+		std::sort(neighbours.begin() + firstNeighbour, neighbours.end());
+	}
+}
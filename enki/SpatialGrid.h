@@ -0,0 +1,92 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef __ENKI_SPATIALGRID_H
+#define __ENKI_SPATIALGRID_H
+
+#include "UniformGrid.h"
+
+/*!	\file SpatialGrid.h
+	\brief A uniform grid to find the objects that are close to each others
+*/
+
+namespace Enki
+{
+	class PhysicalObject;
+	
+	//! A uniform grid over the bounding circles of a set of objects
+	/*! \ingroup core
+		Each object is stored in the cell containing its center. The side of the cells is at least
+		the diameter of the largest object, so two objects whose bounding circles overlap are either
+		in the same cell or in neighbouring ones. Within a cell, objects are stored in increasing
+		index order, so that queries return objects in the same order as a scan of the whole vector.
+		The grid is a snapshot: if objects move after build(), it must be rebuilt.
+	*/
+	class SpatialGrid: public UniformGrid
+	{
+	public:
+		//! A vector of indices of objects
+		typedef std::vector<unsigned> Indices;
+		
+	protected:
+		//! The radius of the largest object
+		double maxRadius;
+		//! For every object, the cell it belongs to
+		std::vector<unsigned> objectCells;
+		//! For every object, the position of its center when the grid was built
+		std::vector<Point> positions;
+		//! For every object, its bounding radius
+		std::vector<double> radii;
+		
+	public:
+		//! Constructor, build an empty grid
+		SpatialGrid();
+		
+		//! Build the grid from objects; the cell side is the largest of minCellSize and of the diameter of the largest object
+		void build(const std::vector<PhysicalObject *>& objects, double minCellSize = 0);
+		//! Remove all objects from the grid
+		void clear();
+		
+		//! Append to candidates the indices j > i of objects whose bounding circle is at most at margin of the one of object i, in increasing order; only the neighbouring cells are scanned if the cell side is at least twice the largest radius plus margin
+		void getCollisionCandidates(unsigned i, double margin, Indices& candidates) const;
+		//! Append to neighbours the indices of objects whose bounding circle is at most at range of center, in increasing order
+		void getNeighbours(const Point& center, double range, Indices& neighbours) const;
+		
+		//! Return the number of objects in the grid
+		size_t size() const { return positions.size(); }
+		//! Return the radius of the largest object
+		double getMaxRadius() const { return maxRadius; }
+	};
+}
+
+#endif
@@ -0,0 +1,291 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "StaticScene.h"
+#include "PhysicalEngine.h"
+#include <algorithm>
+#include <cmath>
+
+/*!	\file StaticScene.cpp
+	\brief Implementation of the uniform grid over the bounding boxes of the objects of infinite mass
+*/
+
+namespace Enki
+{
+	StaticScene::StaticScene()
+	{
+	}
+	
+	void StaticScene::build(const std::vector<PhysicalObject *>& objects)
+	{
+		indices.clear();
+		this->objects.clear();
+		positions.clear();
+		angles.clear();
+		geometryVersions.clear();
+		boxMins.clear();
+		boxMaxs.clear();
+		
+		// collect the static objects and their bounding boxes, which include their center
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			PhysicalObject* o(objects[i]);
+			if (o->getMass() >= 0)
+				continue;
+			indices.push_back(i);
+			this->objects.push_back(o);
+			positions.push_back(o->pos);
+			angles.push_back(o->angle);
+			geometryVersions.push_back(o->getGeometryVersion());
+			Point boxMin(o->pos);
+			Point boxMax(o->pos);
+			const PhysicalObject::Hull& hull(o->getHull());
+			if (hull.empty())
+			{
+				boxMin -= Vector(o->getRadius(), o->getRadius());
+				boxMax += Vector(o->getRadius(), o->getRadius());
+			}
+			for (PhysicalObject::Hull::const_iterator it = hull.begin(); it != hull.end(); ++it)
+			{
+				const Polygone& shape(it->getTransformedShape());
+				for (size_t j = 0; j < shape.size(); ++j)
+				{
+					boxMin.x = std::min(boxMin.x, shape[j].x);
+					boxMin.y = std::min(boxMin.y, shape[j].y);
+					boxMax.x = std::max(boxMax.x, shape[j].x);
+					boxMax.y = std::max(boxMax.y, shape[j].y);
+				}
+			}
+			boxMins.push_back(boxMin);
+			boxMaxs.push_back(boxMax);
+		}
+		
+		const size_t objectCount(indices.size());
+		if (objectCount == 0)
+		{
+			clearCells();
+			return;
+		}
+		
+		// the size of cells is the average size of objects, as long as it does not lead to a huge number of empty cells
+		Point bottomLeft(boxMins[0]);
+		Point topRight(boxMaxs[0]);
+		double sizeSum(0);
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			bottomLeft.x = std::min(bottomLeft.x, boxMins[i].x);
+			bottomLeft.y = std::min(bottomLeft.y, boxMins[i].y);
+			topRight.x = std::max(topRight.x, boxMaxs[i].x);
+			topRight.y = std::max(topRight.y, boxMaxs[i].y);
+			sizeSum += std::max(boxMaxs[i].x - boxMins[i].x, boxMaxs[i].y - boxMins[i].y);
+		}
+		fitCells(bottomLeft, topRight, sizeSum / objectCount, objectCount);
+		
+		// bucket objects into all the cells covered by their bounding box using a counting sort, which keeps them by increasing number within a cell
+		const size_t cellCount(width * height);
+		cellStart.assign(cellCount + 1, 0);
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			const int x0(cellCoordinate(boxMins[i].x, origin.x, width));
+			const int x1(cellCoordinate(boxMaxs[i].x, origin.x, width));
+			const int y0(cellCoordinate(boxMins[i].y, origin.y, height));
+			const int y1(cellCoordinate(boxMaxs[i].y, origin.y, height));
+			for (int y = y0; y <= y1; ++y)
+				for (int x = x0; x <= x1; ++x)
+					++cellStart[y * width + x + 1];
+		}
+		for (size_t c = 0; c < cellCount; ++c)
+			cellStart[c + 1] += cellStart[c];
+		entries.resize(cellStart[cellCount]);
+		std::vector<unsigned> cursors(cellStart.begin(), cellStart.end() - 1);
+		for (size_t i = 0; i < objectCount; ++i)
+		{
+			const int x0(cellCoordinate(boxMins[i].x, origin.x, width));
+			const int x1(cellCoordinate(boxMaxs[i].x, origin.x, width));
+			const int y0(cellCoordinate(boxMins[i].y, origin.y, height));
+			const int y1(cellCoordinate(boxMaxs[i].y, origin.y, height));
+			for (int y = y0; y <= y1; ++y)
+				for (int x = x0; x <= x1; ++x)
+					entries[cursors[y * width + x]++] = i;
+		}
+	}
+	
+	void StaticScene::clear()
+	{
+		clearCells();
+		indices.clear();
+		objects.clear();
+		positions.clear();
+		angles.clear();
+		geometryVersions.clear();
+		boxMins.clear();
+		boxMaxs.clear();
+	}
+	
+	bool StaticScene::isUpToDate(const std::vector<PhysicalObject *>& objects) const
+	{
+		size_t s(0);
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			const PhysicalObject* o(objects[i]);
+			if (o->getMass() >= 0)
+				continue;
+			if (s == indices.size() || indices[s] != i || this->objects[s] != o)
+				return false;
+			if (positions[s].x != o->pos.x || positions[s].y != o->pos.y || angles[s] != o->angle || geometryVersions[s] != o->getGeometryVersion())
+				return false;
+			++s;
+		}
+		return s == indices.size();
+	}
+	
+	void StaticScene::getNeighbours(const Point& center, double range, Indices& neighbours) const
+	{
+		if (indices.empty())
+			return;
+		
+		const double range2(range * range);
+		
+		// if the range covers the whole grid, just scan all objects
+		int x0, y0, x1, y1;
+		if (getCoveredCells(center, range, x0, y0, x1, y1))
+		{
+			for (unsigned i = 0; i < indices.size(); ++i)
+				if (boxDistance2(i, center) <= range2)
+					neighbours.push_back(indices[i]);
+			return;
+		}
+		
+		// otherwise only look into the cells covered by the range, objects covering several cells are found several times
+		const size_t firstNeighbour(neighbours.size());
+		for (int y = y0; y <= y1; ++y)
+		{
+			for (int x = x0; x <= x1; ++x)
+			{
+				const unsigned cell(y * width + x);
+				for (unsigned e = cellStart[cell]; e < cellStart[cell + 1]; ++e)
+				{
+					const unsigned i(entries[e]);
+					if (boxDistance2(i, center) <= range2)
+						neighbours.push_back(indices[i]);
+				}
+			}
+		}
+		std::sort(neighbours.begin() + firstNeighbour, neighbours.end());
+		neighbours.erase(std::unique(neighbours.begin() + firstNeighbour, neighbours.end()), neighbours.end());
+	}
+	
+	void StaticScene::getRayNeighbours(const Point& start, const Vector& segment, Indices& neighbours) const
+	{
+		if (indices.empty())
+			return;
+		
+		// the segment and the boxes are enlarged by a small tolerance, so that rounding never misses a box it touches
+		const double tolerance(cellSize * 1e-6);
+		const Point end(start + segment);
+		const size_t firstNeighbour(neighbours.size());
+		
+		// scan the rows of cells crossed by the segment and, within a row, the cells between the ends of the part of the segment in this row
+		const int y0(cellCoordinate(std::min(start.y, end.y) - tolerance, origin.y, height));
+		const int y1(cellCoordinate(std::max(start.y, end.y) + tolerance, origin.y, height));
+		for (int y = y0; y <= y1; ++y)
+		{
+			double xMin(std::min(start.x, end.x));
+			double xMax(std::max(start.x, end.x));
+			if (segment.y != 0)
+			{
+				// the first and last rows extend to infinity, as coordinates are clamped to the grid
+				const double rowBottom(y == 0 ? -HUGE_VAL : origin.y + y * cellSize - tolerance);
+				const double rowTop(y == height - 1 ? HUGE_VAL : origin.y + (y + 1) * cellSize + tolerance);
+				const double tBottom((rowBottom - start.y) / segment.y);
+				const double tTop((rowTop - start.y) / segment.y);
+				const double t0(std::max(std::min(tBottom, tTop), 0.));
+				const double t1(std::min(std::max(tBottom, tTop), 1.));
+				if (t0 > t1)
+					continue;
+				xMin = std::min(start.x + t0 * segment.x, start.x + t1 * segment.x);
+				xMax = std::max(start.x + t0 * segment.x, start.x + t1 * segment.x);
+			}
+			const int x0(cellCoordinate(xMin - tolerance, origin.x, width));
+			const int x1(cellCoordinate(xMax + tolerance, origin.x, width));
+			for (int x = x0; x <= x1; ++x)
+			{
+				const unsigned cell(y * width + x);
+				for (unsigned e = cellStart[cell]; e < cellStart[cell + 1]; ++e)
+				{
+					const unsigned i(entries[e]);
+					if (segmentCrossesBox(i, start, segment, tolerance))
+						neighbours.push_back(i);
+				}
+			}
+		}
+		
+		// objects covering several cells are found several times
+		std::sort(neighbours.begin() + firstNeighbour, neighbours.end());
+		neighbours.erase(std::unique(neighbours.begin() + firstNeighbour, neighbours.end()), neighbours.end());
+	}
+	
+	double StaticScene::boxDistance2(unsigned i, const Point& center) const
+	{
+		const double dx(std::max(std::max(boxMins[i].x - center.x, center.x - boxMaxs[i].x), 0.));
+		const double dy(std::max(std::max(boxMins[i].y - center.y, center.y - boxMaxs[i].y), 0.));
+		return dx * dx + dy * dy;
+	}
+	
+	bool StaticScene::segmentCrossesBox(unsigned i, const Point& start, const Vector& segment, double tolerance) const
+	{
+		// clip the parameter of the segment by the slabs of the box along x and y
+		double t0(0), t1(1);
+		const double starts[2] = { start.x, start.y };
+		const double directions[2] = { segment.x, segment.y };
+		const double mins[2] = { boxMins[i].x - tolerance, boxMins[i].y - tolerance };
+		const double maxs[2] = { boxMaxs[i].x + tolerance, boxMaxs[i].y + tolerance };
+		for (unsigned axis = 0; axis < 2; ++axis)
+		{
+			if (directions[axis] == 0)
+			{
+				if (starts[axis] < mins[axis] || starts[axis] > maxs[axis])
+					return false;
+				continue;
+			}
+			const double tMin((mins[axis] - starts[axis]) / directions[axis]);
+			const double tMax((maxs[axis] - starts[axis]) / directions[axis]);
+			t0 = std::max(t0, std::min(tMin, tMax));
+			t1 = std::min(t1, std::max(tMin, tMax));
+			if (t0 > t1)
+				return false;
+		}
+		return true;
+	}
+}
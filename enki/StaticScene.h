@@ -0,0 +1,108 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef __ENKI_STATICSCENE_H
+#define __ENKI_STATICSCENE_H
+
+#include "UniformGrid.h"
+
+/*!	\file StaticScene.h
+	\brief A uniform grid over the bounding boxes of the objects of infinite mass
+*/
+
+namespace Enki
+{
+	class PhysicalObject;
+	
+	//! A uniform grid over the bounding boxes of the objects of infinite mass of a world
+	/*! \ingroup core
+		Objects of infinite mass never move by themselves, so unlike SpatialGrid this grid is built
+		once and only rebuilt when static objects are added, removed, moved or reshaped. Every object is stored
+		in all the cells covered by the bounding box of its hull and of its center, so that long walls
+		do not increase the size of cells. Range queries return the indices of static objects in the
+		vector of objects the scene was built from, in increasing order; ray queries return the numbers
+		of static objects within the scene, which getObject() maps to the objects.
+	*/
+	class StaticScene: public UniformGrid
+	{
+	public:
+		//! A vector of indices of objects
+		typedef std::vector<unsigned> Indices;
+		
+	protected:
+		//! For every static object, its index in the vector of objects
+		Indices indices;
+		//! For every static object, its address, also used to check whether the scene is up to date
+		std::vector<PhysicalObject *> objects;
+		//! For every static object, its position when the scene was built
+		std::vector<Point> positions;
+		//! For every static object, its angle when the scene was built
+		std::vector<double> angles;
+		//! For every static object, the version of its geometry when the scene was built
+		std::vector<unsigned> geometryVersions;
+		//! For every static object, the bottom-left corner of its bounding box
+		std::vector<Point> boxMins;
+		//! For every static object, the top-right corner of its bounding box
+		std::vector<Point> boxMaxs;
+		
+	public:
+		//! Constructor, build an empty scene
+		StaticScene();
+		
+		//! Build the scene from the objects of infinite mass in objects, whose transformed shapes must be up to date
+		void build(const std::vector<PhysicalObject *>& objects);
+		//! Remove all objects from the scene
+		void clear();
+		//! Return whether the objects of infinite mass in objects are the same, at the same indices and with the same pose and geometry, as when the scene was built
+		bool isUpToDate(const std::vector<PhysicalObject *>& objects) const;
+		
+		//! Append to neighbours the indices of static objects whose bounding box is at most at range of center, in increasing order
+		void getNeighbours(const Point& center, double range, Indices& neighbours) const;
+		//! Append to neighbours the numbers of static objects whose bounding box is crossed by the segment from start to start + segment, in increasing order
+		void getRayNeighbours(const Point& start, const Vector& segment, Indices& neighbours) const;
+		
+		//! Return the number of objects in the scene
+		size_t size() const { return indices.size(); }
+		//! Return static object number n
+		PhysicalObject* getObject(unsigned n) const { return objects[n]; }
+		
+	protected:
+		//! Return the square of the distance between center and the bounding box of static object i
+		double boxDistance2(unsigned i, const Point& center) const;
+		//! Return whether the segment from start to start + segment crosses the bounding box of static object i, enlarged by tolerance
+		bool segmentCrossesBox(unsigned i, const Point& start, const Vector& segment, double tolerance) const;
+	};
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "UniformGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/*!	\file UniformGrid.cpp
+	\brief Implementation of the layout of a uniform grid of square cells
+*/
+
+namespace Enki
+{
+	UniformGrid::UniformGrid() :
+		cellSize(1),
+		width(0),
+		height(0),
+		cellStart(1, 0)
+	{
+	}
+	
+	void UniformGrid::fitCells(const Point& bottomLeft, const Point& topRight, double cellSize, size_t objectCount)
+	{
+		// make sure that sparse worlds do not lead to a huge number of empty cells
+		this->cellSize = cellSize;
+		if (!(this->cellSize > 0))
+			this->cellSize = 1;
+		const double maxCellCount(4. * objectCount + 16.);
+		double cellsX(floor((topRight.x - bottomLeft.x) / this->cellSize) + 1);
+		double cellsY(floor((topRight.y - bottomLeft.y) / this->cellSize) + 1);
+		while (!(cellsX * cellsY <= maxCellCount))
+		{
+			if (!(cellsX * cellsY < std::numeric_limits<double>::max()))
+				this->cellSize = std::numeric_limits<double>::max();
+			else
+				this->cellSize *= std::max(sqrt((cellsX * cellsY) / maxCellCount), 1.01);
+			cellsX = floor((topRight.x - bottomLeft.x) / this->cellSize) + 1;
+			cellsY = floor((topRight.y - bottomLeft.y) / this->cellSize) + 1;
+		}
+		origin = bottomLeft;
+		width = static_cast<int>(cellsX);
+		height = static_cast<int>(cellsY);
+	}
+	
+	void UniformGrid::clearCells()
+	{
+		width = 0;
+		height = 0;
+		cellStart.assign(1, 0);
+		entries.clear();
+	}
+	
+	int UniformGrid::cellCoordinate(double x, double o, int count) const
+	{
+		// clamp in floating point before converting, as x might be very far or even infinite
+		const double c(floor((x - o) / cellSize));
+		if (!(c > 0))
+			return 0;
+		if (c >= count - 1)
+			return count - 1;
+		return static_cast<int>(c);
+	}
+	
+	bool UniformGrid::getCoveredCells(const Point& center, double reach, int& x0, int& y0, int& x1, int& y1) const
+	{
+		x0 = cellCoordinate(center.x - reach, origin.x, width);
+		x1 = cellCoordinate(center.x + reach, origin.x, width);
+		y0 = cellCoordinate(center.y - reach, origin.y, height);
+		y1 = cellCoordinate(center.y + reach, origin.y, height);
+		return x0 == 0 && y0 == 0 && x1 == width - 1 && y1 == height - 1;
+	}
+}
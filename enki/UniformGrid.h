@@ -0,0 +1,87 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef __ENKI_UNIFORMGRID_H
+#define __ENKI_UNIFORMGRID_H
+
+#include "Geometry.h"
+#include <vector>
+
+/*!	\file UniformGrid.h
+	\brief The layout of a uniform grid of square cells
+*/
+
+namespace Enki
+{
+	//! The layout of a uniform grid of square cells, shared by SpatialGrid and StaticScene
+	/*! \ingroup core
+		Cells are numbered row by row from the bottom-left corner. Coordinates outside of the grid
+		are clamped to its border cells, so that queries far away or even at infinity stay valid.
+		Derived classes choose the size of cells and what they store in them.
+	*/
+	class UniformGrid
+	{
+	protected:
+		//! Side of a cell
+		double cellSize;
+		//! Position of the bottom-left corner of the grid
+		Point origin;
+		//! Number of cells along x
+		int width;
+		//! Number of cells along y
+		int height;
+		//! For every cell, index in entries of its first object; has one more element than there are cells
+		std::vector<unsigned> cellStart;
+		//! Objects, sorted by cell and within a cell by increasing number
+		std::vector<unsigned> entries;
+		
+	public:
+		//! Constructor, build an empty grid
+		UniformGrid();
+		
+		//! Return the side of a cell
+		double getCellSize() const { return cellSize; }
+		
+	protected:
+		//! Cover the rectangle from bottomLeft to topRight with cells of side at least cellSize, enlarged so that there are no more than 4 cells per object plus 16, and set origin, width and height
+		void fitCells(const Point& bottomLeft, const Point& topRight, double cellSize, size_t objectCount);
+		//! Remove all cells
+		void clearCells();
+		//! Return the coordinate of the cell containing x, along an axis starting at o and having count cells
+		int cellCoordinate(double x, double o, int count) const;
+		//! Set x0, y0, x1 and y1 to the cells covered by the square of half side reach around center, return whether these are all the cells of the grid, in which case scanning all objects is faster
+		bool getCoveredCells(const Point& center, double reach, int& x0, int& y0, int& x1, int& y1) const;
+	};
+}
+
+#endif
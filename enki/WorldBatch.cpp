@@ -0,0 +1,99 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "WorldBatch.h"
+#include <algorithm>
+
+/*!	\file WorldBatch.cpp
+	\brief Implementation of the set of independent worlds stepped together
+*/
+
+namespace Enki
+{
+	WorldBatch::WorldBatch(unsigned threadCount) :
+		threadCount(threadCount),
+		takeWorldOwnership(true)
+	{
+	}
+	
+	WorldBatch::~WorldBatch()
+	{
+		if (takeWorldOwnership)
+			for (size_t i = 0; i < worlds.size(); ++i)
+				delete worlds[i];
+	}
+	
+	void WorldBatch::addWorld(World* world)
+	{
+		if (std::find(worlds.begin(), worlds.end(), world) == worlds.end())
+			worlds.push_back(world);
+	}
+	
+	void WorldBatch::removeWorld(World* world)
+	{
+		const std::vector<World*>::iterator it(std::find(worlds.begin(), worlds.end(), world));
+		if (it != worlds.end())
+			worlds.erase(it);
+	}
+	
+	void WorldBatch::run(unsigned steps, double dt, unsigned physicsOversampling, WorldBatchCallback* callback)
+	{
+		const int worldCount(worlds.size());
+		const int threads(std::max(threadCount, 1u));
+		
+		if (callback)
+		{
+			// lock-step, the threads are kept between steps
+			#pragma omp parallel num_threads(threads)
+			for (unsigned step = 0; step < steps; ++step)
+			{
+				#pragma omp for schedule(dynamic, 1)
+				for (int i = 0; i < worldCount; ++i)
+					worlds[i]->step(dt, physicsOversampling);
+				// the implicit barrier of the loop guarantees that all worlds did their step
+				#pragma omp master
+				(*callback)(*this, step);
+				#pragma omp barrier
+			}
+		}
+		else
+		{
+			// every world runs all its steps at once
+			#pragma omp parallel for num_threads(threads) schedule(dynamic, 1)
+			for (int i = 0; i < worldCount; ++i)
+				for (unsigned step = 0; step < steps; ++step)
+					worlds[i]->step(dt, physicsOversampling);
+		}
+	}
+}
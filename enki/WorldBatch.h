@@ -0,0 +1,106 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef __ENKI_WORLDBATCH_H
+#define __ENKI_WORLDBATCH_H
+
+#include "PhysicalEngine.h"
+#include <vector>
+
+/*!	\file WorldBatch.h
+	\brief A set of independent worlds stepped together
+*/
+
+namespace Enki
+{
+	class WorldBatch;
+	
+	//! Functor called between steps of a WorldBatch, for instance to read sensors and set motor commands
+	/*! \ingroup core */
+	struct WorldBatchCallback
+	{
+		//! Virtual destructor, do nothing
+		virtual ~WorldBatchCallback() { }
+		//! Called once all worlds of batch have done step, counted from 0 since the beginning of WorldBatch::run()
+		virtual void operator()(WorldBatch& batch, unsigned step) = 0;
+	};
+	
+	//! A set of independent worlds, stepped in parallel
+	/*! \ingroup core
+		This is meant for workloads made of many small worlds, such as fitness evaluations.
+		Worlds are distributed dynamically to threadCount threads, every world being stepped
+		by a single thread at a time. Results are the same as stepping worlds one by one, as long
+		as worlds share no state. This is not the case of s-bots, whose SbotGlobalSound shares
+		the frequencies of all worlds, nor of Bluetooth modules with random addresses, which are
+		drawn from a global generator; worlds containing them are not supported.
+		The worlds' own threadCount should be left to 1, to avoid nested parallelism.
+	*/
+	class WorldBatch
+	{
+	public:
+		//! Number of threads used to step the worlds, 1 by default. Requires OpenMP
+		unsigned threadCount;
+		//! If true, worlds will be destroyed with the batch, true by default
+		bool takeWorldOwnership;
+		
+	protected:
+		//! The worlds
+		std::vector<World*> worlds;
+		
+	public:
+		//! Constructor, build an empty batch
+		WorldBatch(unsigned threadCount = 1);
+		//! Destructor, destroy the worlds if takeWorldOwnership is true
+		virtual ~WorldBatch();
+		
+		//! Add a world to the batch; if the world is already in the batch, do nothing
+		void addWorld(World* world);
+		//! Remove a world from the batch without destroying it; if the world is not in the batch, do nothing
+		void removeWorld(World* world);
+		//! Return the number of worlds
+		size_t size() const { return worlds.size(); }
+		//! Return world i
+		World* operator[](size_t i) const { return worlds[i]; }
+		
+		//! Do steps steps of dt in all worlds, see World::step()
+		/*!
+			Without callback, every world runs all its steps on one thread, without synchronisation.
+			With a callback, worlds run in lock-step: after every step of all worlds, the callback
+			is called from the calling thread, so it can read and modify all worlds.
+		*/
+		void run(unsigned steps, double dt, unsigned physicsOversampling = 1, WorldBatchCallback* callback = 0);
+	};
+}
+
+#endif
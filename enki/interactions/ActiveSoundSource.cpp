@@ -94,7 +94,8 @@ namespace Enki
 				if (channel+i < noOfChannels) pitch[channel+i] = gaussian*signal;
 			}
 			*/
-			int c = (int)channel + round(gaussianRand(0, variance));
+			RandomStream randomStream(owner->getRandomStream(randomStreamId));
+			int c = (int)channel + round(randomStream.gaussian(0, variance));
 			if (c < 0)
 				c = 0;
 			if (c >= noOfChannels)
@@ -104,6 +105,20 @@ namespace Enki
 		}
 	}
 
+	void ActiveSoundSource::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeArray(pitch, noOfChannels);
+		snapshot.writeValue(enableFlag);
+		snapshot.writeValue(elapsedTime);
+	}
+	
+	void ActiveSoundSource::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readArray(pitch, noOfChannels);
+		snapshot.readValue(enableFlag);
+		snapshot.readValue(elapsedTime);
+	}
+
 	double ActiveSoundSource::getSound(unsigned channel)
 	{
 		if (channel < noOfChannels)
@@ -68,6 +68,10 @@ namespace Enki
 		// Local interaction functions
 		virtual void init() {}
 		virtual void objectStep(double dt, PhysicalObject *po, World *w) {}
+		//! Write the pitch of the channels and the activity
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot);
 		
 		//! Set the range of this sound interraction
 		void setSoundRange(double range);
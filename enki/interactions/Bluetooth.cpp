@@ -321,7 +321,11 @@ namespace Enki
 				while (bb->registerClient(this,address) == false)
 					address=random.get()%UINT_MAX;
 			else
-				assert(bb->registerClient(this,address));
+			{
+				const bool registered(bb->registerClient(this,address));
+				assert(registered);
+				(void)registered;
+			}
 			updateAddress=false;
 		}
 		
@@ -353,6 +357,64 @@ namespace Enki
 		}
 	}
 	
+	void Bluetooth::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(address);
+		snapshot.writeValue(nbConnections);
+		snapshot.writeValue(updateAddress);
+		snapshot.writeValue(randomAddress);
+		snapshot.writeValue(connectionError);
+		snapshot.writeValue(disconnectionError);
+		for (unsigned i=0;i<maxConnections;++i)
+		{
+			snapshot.writeArray(rxBuffer[i], rxBufferSize);
+			snapshot.writeArray(txBuffer[i], txBufferSize);
+		}
+		snapshot.writeArray(receptionFlags, maxConnections);
+		snapshot.writeArray(destAddress, maxConnections);
+		snapshot.writeArray(sizeToSend, maxConnections);
+		snapshot.writeArray(sizeReceived, maxConnections);
+		snapshot.writeArray(transmissionError, maxConnections);
+		snapshot.writeQueue(connectToRobot);
+		snapshot.writeQueue(closeConnectionToRobot);
+	}
+	
+	void Bluetooth::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readValue(address);
+		snapshot.readValue(nbConnections);
+		snapshot.readValue(updateAddress);
+		snapshot.readValue(randomAddress);
+		snapshot.readValue(connectionError);
+		snapshot.readValue(disconnectionError);
+		for (unsigned i=0;i<maxConnections;++i)
+		{
+			snapshot.readArray(rxBuffer[i], rxBufferSize);
+			snapshot.readArray(txBuffer[i], txBufferSize);
+		}
+		snapshot.readArray(receptionFlags, maxConnections);
+		snapshot.readArray(destAddress, maxConnections);
+		snapshot.readArray(sizeToSend, maxConnections);
+		snapshot.readArray(sizeReceived, maxConnections);
+		snapshot.readArray(transmissionError, maxConnections);
+		snapshot.readQueue(connectToRobot);
+		snapshot.readQueue(closeConnectionToRobot);
+	}
+	
+	void Bluetooth::saveLayout(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(maxConnections);
+		snapshot.writeValue(rxBufferSize);
+		snapshot.writeValue(txBufferSize);
+	}
+	
+	void Bluetooth::checkLayout(Snapshot& snapshot) const
+	{
+		snapshot.readExpectedValue(maxConnections);
+		snapshot.readExpectedValue(rxBufferSize);
+		snapshot.readExpectedValue(txBufferSize);
+	}
+	
 	unsigned Bluetooth::getConnectionError()
 	{
 		return (unsigned)connectionError;
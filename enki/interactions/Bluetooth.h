@@ -131,6 +131,14 @@ public:
 		
 		//! On every timestep, send the commands recorded to the bluetooth Base to be executed
 		virtual void step(double dt, World *w);
+		//! Write the address, the connections, the buffers and the scheduled requests
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState() into the current buffers
+		virtual void restoreState(Snapshot& snapshot);
+		//! Write the number of connections and the sizes of the buffers, which restoreState() does not change
+		virtual void saveLayout(Snapshot& snapshot) const;
+		//! Check that the number of connections and the sizes of the buffers are the ones written by saveLayout()
+		virtual void checkLayout(Snapshot& snapshot) const;
 		
 		//! Change the address of the module
 		void setAddress(unsigned address);
@@ -46,7 +46,7 @@ namespace Enki
 	struct DepthTest : public PixelOperationFunctor
 	{
 		//! If objectDist2 < zBuffer2, then pixelBuffer = objectColor and zBuffer2 = objectDist2
-		virtual void operator()(double &zBuffer2, Color &pixelBuffer, const double &objectDist2, const Color &objectColor)
+		static inline void apply(double &zBuffer2, Color &pixelBuffer, const double &objectDist2, const Color &objectColor)
 		{
 			if (objectDist2 < zBuffer2)
 			{
@@ -54,8 +54,188 @@ namespace Enki
 				pixelBuffer = objectColor;
 			}
 		}
+		
+		//! Call apply()
+		virtual void operator()(double &zBuffer2, Color &pixelBuffer, const double &objectDist2, const Color &objectColor)
+		{
+			apply(zBuffer2, pixelBuffer, objectDist2, objectColor);
+		}
 	} depthTest; //!< Standard depth test instance
 	
+	//! Standard depth test without the virtual call, used by the rasteriser when no custom pixel operation is set
+	struct InlineDepthTest
+	{
+		//! Call DepthTest::apply()
+		inline void operator()(double &zBuffer2, Color &pixelBuffer, const double &objectDist2, const Color &objectColor) const
+		{
+			DepthTest::apply(zBuffer2, pixelBuffer, objectDist2, objectColor);
+		}
+	};
+	
+	//! Custom pixel operation, called through its virtual operator
+	struct CustomPixelOperation
+	{
+		//! The custom pixel operation
+		PixelOperationFunctor *functor;
+		
+		//! Constructor
+		CustomPixelOperation(PixelOperationFunctor *functor) : functor(functor) {}
+		//! Call functor
+		inline void operator()(double &zBuffer2, Color &pixelBuffer, const double &objectDist2, const Color &objectColor) const
+		{
+			(*functor)(zBuffer2, pixelBuffer, objectDist2, objectColor);
+		}
+	};
+	
+	//! Fill pixels [begin; end] with color at distance² dist2, using pixel operation op
+	template<typename PixelOperation>
+	static void fillSpan(size_t begin, size_t end, double *zbuffer, Color *image, double dist2, const Color &color, const PixelOperation &op)
+	{
+		for (size_t i = begin; i <= end; i++)
+			op(zbuffer[i], image[i], dist2, color);
+	}
+	
+	//! Fill pixels [begin; end] with the textured line from p0c to p0c + p10c, in camera coordinates, using pixel operation op
+	/*!
+		For every pixel, the line is intersected with the ray of direction directions[i], so no trigonometry is involved.
+	*/
+	template<typename PixelOperation>
+	static void fillTexturedSpan(size_t begin, size_t end, const Vector *directions, double *zbuffer, Color *image, const Vector &p0c, const Vector &p10c, const Texture &texture, bool invertTextureIndex, const PixelOperation &op)
+	{
+		const size_t textureSize = texture.size();
+		const Vector p1c = p0c + p10c;
+		for (size_t i = begin; i <= end; i++)
+		{
+			// solve cross(direction, p0c + lambda * p10c) = 0
+			const Vector &direction = directions[i];
+			const double denominator = direction.cross(p10c);
+			const double lambda = (denominator != 0) ? -direction.cross(p0c) / denominator : 0;
+			
+			// Compute zbuffer and texture index.
+			size_t texIndex;
+			Vector p;
+			if (lambda < 0)
+			{
+				p = p0c;
+				texIndex = 0;
+			}
+			else if (lambda >= 1)
+			{
+				p = p1c;
+				texIndex = textureSize - 1;
+			}
+			else
+			{
+				p = p0c + p10c * lambda;
+				texIndex = static_cast<size_t>(floor(lambda * textureSize));
+			}
+			assert(texIndex < textureSize);
+			if (invertTextureIndex)
+				texIndex = textureSize - texIndex - 1;
+			
+			op(zbuffer[i], image[i], p.norm2(), texture[texIndex]);
+		}
+	}
+	
+	//! Draw the parts of the hull of po higher than height, seen from absPos, by calling drawProjectedLine of camera for every face
+	/*!
+		Every vertex is projected once into camera coordinates, using worldToCamera, in the scratch buffers projectedVertices and projectedAngles, as it is shared by two faces.
+	*/
+	template<typename Camera>
+	static void drawHull(Camera *camera, void (Camera::*drawProjectedLine)(Vector, double, Vector, double, const Texture &), const PhysicalObject *po, double height, const Vector &absPos, const Matrix22 &worldToCamera, std::vector<Vector> &projectedVertices, std::vector<double> &projectedAngles)
+	{
+		for (PhysicalObject::Hull::const_iterator it = po->getHull().begin(); it != po->getHull().end(); ++it)
+		{
+			if (height > it->getHeight())
+				continue;
+			
+			const Polygone& shape = it->getTransformedShape();
+			const size_t faceCount = shape.size();
+			projectedVertices.resize(faceCount);
+			projectedAngles.resize(faceCount);
+			for (size_t i = 0; i<faceCount; i++)
+			{
+				projectedVertices[i] = worldToCamera * (shape[i] - absPos);
+				projectedAngles[i] = projectedVertices[i].angle();
+			}
+			
+			if (it->isTextured())
+			{
+				for (size_t i = 0; i<faceCount; i++)
+				{
+					const size_t j = (i+1) % faceCount;
+					(camera->*drawProjectedLine)(projectedVertices[i], projectedAngles[i], projectedVertices[j], projectedAngles[j], it->getTextures()[i]);
+				}
+			}
+			else
+			{
+				const Texture texture(1, po->getColor());
+				for (size_t i = 0; i<faceCount; i++)
+				{
+					const size_t j = (i+1) % faceCount;
+					(camera->*drawProjectedLine)(projectedVertices[i], projectedAngles[i], projectedVertices[j], projectedAngles[j], texture);
+				}
+			}
+		}
+	}
+	
+	//! Compute the angle relative to absOrientation, the half aperture and the distance² at which the cylindric object po is seen from absPos; return false if it cannot be seen
+	static bool projectCylinder(const PhysicalObject *po, const Vector &absPos, double absOrientation, double &angle, double &aperture, double &dist2)
+	{
+		const double radius = po->getRadius();
+		if (radius == 0)
+			return false;
+		const Vector poCenter = po->pos - absPos;
+		const double poDist = poCenter.norm();
+		if (poDist == 0)
+			return false;
+		angle = normalizeAngle(poCenter.angle() - absOrientation);
+		aperture = atan(radius / poDist);
+		assert(aperture > 0);
+		dist2 = poDist * poDist;
+		return true;
+	}
+	
+	//! Draw the walls of w with their color, by calling drawTexturedLine of camera for every segment
+	template<typename Camera>
+	static void drawWalls(Camera *camera, void (Camera::*drawTexturedLine)(const Point &, const Point &, const Texture &), const World *w)
+	{
+		Texture texture(1, w->color);
+		
+		switch (w->wallsType)
+		{
+			// TODO: use world texture if any
+			case World::WALLS_SQUARE:
+			{
+				(camera->*drawTexturedLine)(Point(0, 0), Point(w->w, 0), texture);
+				(camera->*drawTexturedLine)(Point(w->w, 0), Point(w->w, w->h), texture);
+				(camera->*drawTexturedLine)(Point(w->w, w->h), Point(0, w->h), texture);
+				(camera->*drawTexturedLine)(Point(0, w->h), Point(0, 0), texture);
+			}
+			break;
+			
+			case World::WALLS_CIRCULAR:
+			{
+				const double r(w->r);
+				const int segmentCount((r*2.*M_PI) / 10.);
+				for (int i = 0; i < segmentCount; ++i)
+				{
+					const double angStart(((double)i * 2. * M_PI) / (double)segmentCount);
+					const double angEnd(((double)(i+1) * 2. * M_PI) / (double)segmentCount);
+					(camera->*drawTexturedLine)(
+						Point(cos(angStart)*r, sin(angStart)*r),
+						Point(cos(angEnd)*r, sin(angEnd)*r),
+						texture
+					);
+				}
+			}
+			break;
+			
+			default:
+			break;
+		}
+	}
+	
 	
 	CircularCam::CircularCam(Robot *owner, Vector pos, double height, double orientation, double halfFieldOfView, unsigned pixelCount) :
 		zbuffer(pixelCount),
@@ -73,6 +253,8 @@ namespace Enki
 		lightThreshold = Color::black;
 		
 		pixelOperation = &depthTest;
+		
+		pixelDirectionsHalfFieldOfView = 0;
 	}
 
 	void CircularCam::objectStep(double dt, World *w, PhysicalObject *po)
@@ -84,42 +266,15 @@ namespace Enki
 		if (!po->isCylindric())
 		{
 			// object has a hull
-			for (PhysicalObject::Hull::const_iterator it = po->getHull().begin(); it != po->getHull().end(); ++it)
-			{
-				if (height > it->getHeight())
-					continue;
-				
-				const Polygone& shape = it->getTransformedShape();
-				const size_t faceCount = shape.size();
-				if (it->isTextured())
-				{
-					for (size_t i = 0; i<faceCount; i++)
-						drawTexturedLine(shape[i], shape[(i+1) % faceCount], it->getTextures()[i]);
-				}
-				else
-				{
-					Texture texture(1, po->getColor());
-					for (size_t i = 0; i<faceCount; i++)
-						drawTexturedLine(shape[i], shape[(i+1) % faceCount], texture);
-				}
-			}
+			drawHull(this, &CircularCam::drawProjectedLine, po, height, absPos, worldToCamera, projectedVertices, projectedAngles);
 		}
 		else
 		{
 			// object has no bounding surface, monocolor
-			const double radius = po->getRadius();
-			const Color& color = po->getColor();
-			
-			// compute basic parameter
-			if (radius == 0)
+			double poAngle, poAperture, poDist2;
+			if (!projectCylinder(po, absPos, absOrientation, poAngle, poAperture, poDist2))
 				return;
-			const Vector poCenter = po->pos - absPos;
-			const double poDist = poCenter.norm();
-			if (poDist == 0)
-				return;
-			const double poAngle = normalizeAngle(poCenter.angle() - absOrientation);
-			const double poAperture = atan(radius / poDist);
-			assert(poAperture > 0);
+			const Color& color = po->getColor();
 			
 			// clip object
 			const double poBegin = poAngle - poAperture;
@@ -137,12 +292,11 @@ namespace Enki
 			const size_t firstPixelUsed = static_cast<size_t>(floor((zbuffer.size() - 1) * 0.5 * (beginAngle / halfFieldOfView + 1)));
 			const size_t lastPixelUsed = static_cast<size_t>(ceil((zbuffer.size() - 1) * 0.5 * (endAngle / halfFieldOfView + 1)));
 			
-			const double poDist2 = poDist * poDist;
-			for (size_t i = firstPixelUsed; i <= lastPixelUsed; i++)
-			{
-				// apply pixel operation to framebuffer
-				(*pixelOperation)(zbuffer[i], image[i], poDist2, color);
-			}
+			// apply pixel operation to framebuffer
+			if (pixelOperation == &depthTest)
+				fillSpan(firstPixelUsed, lastPixelUsed, &zbuffer[0], &image[0], poDist2, color, InlineDepthTest());
+			else
+				fillSpan(firstPixelUsed, lastPixelUsed, &zbuffer[0], &image[0], poDist2, color, CustomPixelOperation(pixelOperation));
 		}
 	};
 	
@@ -153,19 +307,19 @@ namespace Enki
 	
 	void CircularCam::drawTexturedLine(const Point &p0, const Point &p1, const Texture &texture)
 	{
-		bool invertTextureIndex = false;
-		
 		// Express p0 and p1 in the camera coordinate system.
 		// In cam coord sys, x axis is the optical axis.
-		const Matrix22 rot(-absOrientation);
-		Vector p0c = rot * (p0 - absPos);
-		Vector p1c = rot * (p1 - absPos);
+		const Vector p0c = worldToCamera * (p0 - absPos);
+		const Vector p1c = worldToCamera * (p1 - absPos);
+		drawProjectedLine(p0c, p0c.angle(), p1c, p1c.angle(), texture);
+	}
+	
+	void CircularCam::drawProjectedLine(Vector p0c, double p0dir, Vector p1c, double p1dir, const Texture &texture)
+	{
+		bool invertTextureIndex = false;
 		
-		// Find angle of interest. Here we order p0 and p1 so that
-		// p0 is the point with the smallest angle (in the [-pi;pi]
-		// range).
-		double p0dir = p0c.angle(); 			// [-pi;pi]
-		double p1dir = p1c.angle(); 			// [-pi;pi]
+		// Here we order p0 and p1 so that p0 is the point with
+		// the smallest angle (in the [-pi;pi] range).
 		if (p0dir > p1dir)
 		{
 			std::swap(p0dir, p1dir);
@@ -200,90 +354,39 @@ namespace Enki
 		if ((p1dir < beginAperture) || (p0dir > endAperture))
 			return;
 		
+		// project the line into pixel space, pixels at the borders of the field of view
+		// are set explicitly so that rounding errors cannot drop them
 		const size_t pixelCount = zbuffer.size();
-		const double beginAngle = std::max(p0dir, beginAperture);
-		const double endAngle = std::min(p1dir, endAperture);
 		const double dAngle = 2*halfFieldOfView / (pixelCount - 1);
+		const double beginIndex = (p0dir <= beginAperture) ? 0 : ceil((p0dir-beginAperture) / dAngle);
+		const double endIndex = (p1dir >= endAperture) ? pixelCount - 1 : floor((p1dir-beginAperture) / dAngle);
+		if (endIndex < beginIndex)
+			return;
+		const size_t beginPixelIndex = static_cast<size_t>(beginIndex);
+		const size_t endPixelIndex = static_cast<size_t>(endIndex);
+		assert(endPixelIndex < image.size());
 		
-		// align begin and end angle to our sampled angles
- 		const double beginIndex = ceil((beginAngle-beginAperture) / dAngle);
- 		const double endIndex = floor((endAngle-beginAperture) / dAngle);
-		const double alignedBeginAngle = beginAperture + beginIndex * dAngle;
-		const double alignedEndAngle = beginAperture + endIndex * dAngle;
-
-		const double beginPixel = round(interpolateLinear(beginAperture, endAperture, alignedBeginAngle, 0, pixelCount-1));
-		const double endPixel = round(interpolateLinear(beginAperture, endAperture, alignedEndAngle, 0, pixelCount-1));
-		
-		// Optimization stuff
-		const double x10 = p1c.x - p0c.x;
-		const double y01 = p0c.y - p1c.y;
 		const Vector p10c = p1c - p0c;
-		double tanAngle;
-		bool tanDirty = true;
-		const double tanDelta = tan(dAngle);
+		if (pixelOperation == &depthTest)
+			fillTexturedSpan(beginPixelIndex, endPixelIndex, &pixelDirections[0], &zbuffer[0], &image[0], p0c, p10c, texture, invertTextureIndex, InlineDepthTest());
+		else
+			fillTexturedSpan(beginPixelIndex, endPixelIndex, &pixelDirections[0], &zbuffer[0], &image[0], p0c, p10c, texture, invertTextureIndex, CustomPixelOperation(pixelOperation));
+	}
+	
+	void CircularCam::updatePixelDirections()
+	{
+		const size_t pixelCount = zbuffer.size();
+		if (pixelDirections.size() == pixelCount && pixelDirectionsHalfFieldOfView == halfFieldOfView)
+			return;
 		
-		const size_t beginPixelIndex = static_cast<size_t>(beginPixel);
-		const size_t endPixelIndex = static_cast<size_t>(endPixel);
-		double angle = alignedBeginAngle;
-		for (size_t i = beginPixelIndex; i <= endPixelIndex; i++)
+		pixelDirections.resize(pixelCount);
+		const double dAngle = 2*halfFieldOfView / (pixelCount - 1);
+		for (size_t i = 0; i < pixelCount; i++)
 		{
-			double lambda = 0;
-			
-			if (fabs(angle) == M_PI/2)
-			{
-				lambda  = - p0c.x / x10;
-				tanDirty = true;
-			}
-			else
-			{
-				// OPTIMIZATION: we compute tan(angle+n*dAngle) recursively, using
-				// the formula tan(a+b) = (tan(a) + tan(b))/(1 - tan(a)*tan(b)
-				if(tanDirty)
-				{
-					tanAngle = tan(angle);
-					tanDirty = false;
-				}
-				else
-					tanAngle = (tanAngle + tanDelta) / (1 - tanAngle * tanDelta);
-
-				lambda = (p0c.y - p0c.x * tanAngle) / (tanAngle * x10 + y01);
-			}
-			
-			assert(i < image.size());
-			
-			// Compute zbuffer and texture index.
-			size_t texIndex;
-			Vector p;
-			if (lambda < 0)
-			{
-				p = p0c;
-				texIndex = 0;
-			}
-			else if (lambda >= 1)
-			{
-				p = p1c;
-				texIndex = texture.size() - 1;
-			}
-			else
-			{
-				p = p0c + p10c * lambda;
-				texIndex = static_cast<size_t>(floor(lambda * texture.size()));
-			}
-			
-			assert(texIndex < texture.size());
-			
-			// apply pixel only if distance is inferior to the current one
-			const double z = p.norm2();
-			if (zbuffer[i] > z)
-			{
-				if (invertTextureIndex)
-					texIndex = texture.size() - texIndex - 1;
-				image[i] = texture[texIndex];
-				zbuffer[i] = z;
-			}
-			
-			angle += dAngle;
+			const double angle = -halfFieldOfView + i * dAngle;
+			pixelDirections[i] = Vector(cos(angle), sin(angle));
 		}
+		pixelDirectionsHalfFieldOfView = halfFieldOfView;
 	}
 
 	void CircularCam::init(double dt, World* w)
@@ -292,6 +395,8 @@ namespace Enki
 		const Matrix22 rot(owner->angle);
 		absPos = owner->pos + rot * positionOffset;
 		absOrientation = owner->angle + angleOffset;
+		worldToCamera = Matrix22(-absOrientation);
+		updatePixelDirections();
 		
 		// fill zbuffer with infinite
 		std::fill( &zbuffer[0], &zbuffer[zbuffer.size()], std::numeric_limits<double>::max() );
@@ -300,40 +405,7 @@ namespace Enki
 	
 	void CircularCam::wallsStep(double dt, World* w)
 	{
-		Texture texture(1, w->color);
-		
-		switch (w->wallsType)
-		{
-			// TODO: use world texture if any
-			case World::WALLS_SQUARE:
-			{
-				drawTexturedLine(Point(0, 0), Point(w->w, 0), texture);
-				drawTexturedLine(Point(w->w, 0), Point(w->w, w->h), texture);
-				drawTexturedLine(Point(w->w, w->h), Point(0, w->h), texture);
-				drawTexturedLine(Point(0, w->h), Point(0, 0), texture);
-			}
-			break;
-			
-			case World::WALLS_CIRCULAR:
-			{
-				const double r(w->r);
-				const int segmentCount((r*2.*M_PI) / 10.);
-				for (int i = 0; i < segmentCount; ++i)
-				{
-					const double angStart(((double)i * 2. * M_PI) / (double)segmentCount);
-					const double angEnd(((double)(i+1) * 2. * M_PI) / (double)segmentCount);
-					drawTexturedLine(
-						Point(cos(angStart)*r, sin(angStart)*r),
-						Point(cos(angEnd)*r, sin(angEnd)*r),
-						texture
-					);
-				}
-			}
-			break;
-			
-			default:
-			break;
-		}
+		drawWalls(this, &CircularCam::drawTexturedLine, w);
 		
 		// disable world texture for now
 		/*if (w->wallTextures[0].size() > 0)
@@ -358,6 +430,22 @@ namespace Enki
 		}
 	}
 	
+	void CircularCam::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(absPos);
+		snapshot.writeValue(absOrientation);
+		snapshot.writeArray(zbuffer);
+		snapshot.writeArray(image);
+	}
+	
+	void CircularCam::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readValue(absPos);
+		snapshot.readValue(absOrientation);
+		snapshot.readArray(zbuffer);
+		snapshot.readArray(image);
+	}
+	
 	void CircularCam::setRange(double range)
 	{
 		this->r = range;
@@ -366,43 +454,216 @@ namespace Enki
 	
 	
 	
+	//! Angles of the first samples of the halves of an OmniCam, the last one is the first half shifted by 2PI to handle angles wrapping around PI
+	static const double omniCamHalfStarts[3] = { -M_PI, 0, M_PI };
+	
+	//! Compute the pixels [first; last] of an OmniCam half whose samples cover [start; start + PI] that are within [beginAngle; endAngle], return false if there is none
+	/*!
+		If conservative is true, the pixels just outside the interval are taken as well, as CircularCam does for cylinders.
+		Pixels at the borders of the half are set explicitly so that rounding errors cannot drop them.
+	*/
+	static bool omniCamHalfPixelRange(double beginAngle, double endAngle, double start, size_t halfPixelCount, bool conservative, size_t &first, size_t &last)
+	{
+		const double end = start + M_PI;
+		if (beginAngle > end || endAngle < start)
+			return false;
+		
+		const double dAngle = M_PI / (halfPixelCount - 1);
+		const double lastPixel = halfPixelCount - 1;
+		double firstIndex, lastIndex;
+		if (conservative)
+		{
+			firstIndex = (beginAngle <= start) ? 0 : std::min(floor((beginAngle - start) / dAngle), lastPixel);
+			lastIndex = (endAngle >= end) ? lastPixel : std::min(ceil((endAngle - start) / dAngle), lastPixel);
+		}
+		else
+		{
+			firstIndex = (beginAngle <= start) ? 0 : ceil((beginAngle - start) / dAngle);
+			lastIndex = (endAngle >= end) ? lastPixel : floor((endAngle - start) / dAngle);
+		}
+		if (lastIndex < firstIndex)
+			return false;
+		
+		first = static_cast<size_t>(firstIndex);
+		last = static_cast<size_t>(lastIndex);
+		return true;
+	}
+	
 	OmniCam::OmniCam(Robot *owner, double height, unsigned halfPixelCount) :
 		zbuffer(halfPixelCount * 2),
 		image(halfPixelCount * 2),
-		cam0(owner, Point(0, 0), height, -M_PI/2, M_PI/2, halfPixelCount),
-		cam1(owner, Point(0, 0), height, M_PI/2, M_PI/2, halfPixelCount)
+		pixelDirections(halfPixelCount * 2)
 	{
 		this->r = std::numeric_limits<double>::max();
 		this->owner = owner;
+		this->height = height;
+		
+		useFog = false;
+		fogDensity = 0.0;
+		lightThreshold = Color::black;
+		
+		pixelOperation = &depthTest;
+		
+		// first half covers [-PI; 0], second half [0; PI]
+		const double dAngle = M_PI / (halfPixelCount - 1);
+		for (size_t i = 0; i < halfPixelCount; i++)
+		{
+			const double angle = i * dAngle;
+			pixelDirections[i] = Vector(cos(angle - M_PI), sin(angle - M_PI));
+			pixelDirections[i + halfPixelCount] = Vector(cos(angle), sin(angle));
+		}
 	}
 
 	void OmniCam::objectStep(double dt, World *w, PhysicalObject *po) 
 	{
-		cam0.objectStep(dt, w, po);
-		cam1.objectStep(dt, w, po);
-	};
+		// if we see over the object
+		if (height > po->getHeight())
+			return;
+		
+		if (!po->isCylindric())
+		{
+			// object has a hull
+			drawHull(this, &OmniCam::drawProjectedLine, po, height, absPos, worldToCamera, projectedVertices, projectedAngles);
+		}
+		else
+		{
+			// object has no bounding surface, monocolor
+			double poAngle, poAperture, poDist2;
+			if (!projectCylinder(po, absPos, absOrientation, poAngle, poAperture, poDist2))
+				return;
+			const Color& color = po->getColor();
+			
+			// begin in [-PI; PI], so that end is at most 2PI
+			double beginAngle = poAngle - poAperture;
+			double endAngle = poAngle + poAperture;
+			if (beginAngle < -M_PI)
+			{
+				beginAngle += 2*M_PI;
+				endAngle += 2*M_PI;
+			}
+			
+			const size_t halfPixelCount = zbuffer.size() / 2;
+			for (size_t half = 0; half < 3; half++)
+			{
+				size_t first, last;
+				if (omniCamHalfPixelRange(beginAngle, endAngle, omniCamHalfStarts[half], halfPixelCount, true, first, last))
+				{
+					const size_t offset = (half == 1) ? halfPixelCount : 0;
+					drawSpan(offset + first, offset + last, poDist2, color);
+				}
+			}
+		}
+	}
+	
+	void OmniCam::drawTexturedLine(const Point &p0, const Point &p1, const Texture &texture)
+	{
+		const Vector p0c = worldToCamera * (p0 - absPos);
+		const Vector p1c = worldToCamera * (p1 - absPos);
+		drawProjectedLine(p0c, p0c.angle(), p1c, p1c.angle(), texture);
+	}
+	
+	void OmniCam::drawProjectedLine(Vector p0c, double p0dir, Vector p1c, double p1dir, const Texture &texture)
+	{
+		bool invertTextureIndex = false;
+		
+		// the line covers the shortest arc between its end points
+		double extent = p1dir - p0dir;
+		if (extent > M_PI)
+			extent -= 2*M_PI;
+		else if (extent < -M_PI)
+			extent += 2*M_PI;
+		
+		// order p0 and p1 so that the line goes in mathematical orientation from p0
+		if (extent < 0)
+		{
+			std::swap(p0dir, p1dir);
+			std::swap(p0c, p1c);
+			extent = -extent;
+			invertTextureIndex = !invertTextureIndex;
+		}
+		
+		// dismiss lines seen edge-on
+		if (!(extent > 0))
+			return;
+		
+		// begin is in [-PI; PI], so end is at most 2PI
+		const double beginAngle = p0dir;
+		const double endAngle = p0dir + extent;
+		
+		const size_t halfPixelCount = zbuffer.size() / 2;
+		const Vector p10c = p1c - p0c;
+		for (size_t half = 0; half < 3; half++)
+		{
+			size_t first, last;
+			if (omniCamHalfPixelRange(beginAngle, endAngle, omniCamHalfStarts[half], halfPixelCount, false, first, last))
+			{
+				const size_t offset = (half == 1) ? halfPixelCount : 0;
+				drawTexturedSpan(offset + first, offset + last, p0c, p10c, texture, invertTextureIndex);
+			}
+		}
+	}
+	
+	void OmniCam::drawSpan(size_t begin, size_t end, double dist2, const Color &color)
+	{
+		assert(end < zbuffer.size());
+		if (pixelOperation == &depthTest)
+			fillSpan(begin, end, &zbuffer[0], &image[0], dist2, color, InlineDepthTest());
+		else
+			fillSpan(begin, end, &zbuffer[0], &image[0], dist2, color, CustomPixelOperation(pixelOperation));
+	}
+	
+	void OmniCam::drawTexturedSpan(size_t begin, size_t end, const Vector &p0c, const Vector &p10c, const Texture &texture, bool invertTextureIndex)
+	{
+		assert(end < zbuffer.size());
+		if (pixelOperation == &depthTest)
+			fillTexturedSpan(begin, end, &pixelDirections[0], &zbuffer[0], &image[0], p0c, p10c, texture, invertTextureIndex, InlineDepthTest());
+		else
+			fillTexturedSpan(begin, end, &pixelDirections[0], &zbuffer[0], &image[0], p0c, p10c, texture, invertTextureIndex, CustomPixelOperation(pixelOperation));
+	}
 
 	void OmniCam::init(double dt, World* w)
 	{
-		cam0.init(dt, w);
-		cam1.init(dt, w);
+		// compute absolute position and orientation
+		absPos = owner->pos;
+		absOrientation = owner->angle;
+		worldToCamera = Matrix22(-absOrientation);
+		
+		// fill zbuffer with infinite
+		std::fill( &zbuffer[0], &zbuffer[zbuffer.size()], std::numeric_limits<double>::max() );
+		std::fill( &image[0], &image[image.size()], w->color);
 	}
 	
 	void OmniCam::wallsStep(double dt, World* w)
 	{
-		cam0.wallsStep(dt, w);
-		cam1.wallsStep(dt, w);
+		drawWalls(this, &OmniCam::drawTexturedLine, w);
 	}
 	
 	void OmniCam::finalize(double dt, World* w)
 	{
-		cam0.finalize(dt, w);
-		cam1.finalize(dt, w);
-		size_t camPixelCount = cam0.zbuffer.size();
-		std::copy(&cam0.zbuffer[0], &cam0.zbuffer[camPixelCount], &zbuffer[0]);
-		std::copy(&cam1.zbuffer[0], &cam1.zbuffer[camPixelCount], &zbuffer[camPixelCount]);
-		std::copy(&cam0.image[0], &cam0.image[camPixelCount], &image[0]);
-		std::copy(&cam1.image[0], &cam1.image[camPixelCount], &image[camPixelCount]);
+		if (useFog)
+		{
+			for (size_t i = 0; i < image.size(); i++)
+			{
+				image[i] *= 1 / (1 + fogDensity * sqrt(zbuffer[i]));
+				image[i].threshold(lightThreshold);
+			}
+		}
+	}
+	
+	void OmniCam::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(absPos);
+		snapshot.writeValue(absOrientation);
+		snapshot.writeArray(zbuffer);
+		snapshot.writeArray(image);
+	}
+	
+	void OmniCam::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readValue(absPos);
+		snapshot.readValue(absOrientation);
+		snapshot.readArray(zbuffer);
+		snapshot.readArray(image);
 	}
 	
 	void OmniCam::setRange(double range)
@@ -413,18 +674,14 @@ namespace Enki
 	
 	void OmniCam::setFogConditions(bool useFog, double density, Color threshold)
 	{
-		cam0.useFog = useFog;
-		cam0.fogDensity = density;
-		cam0.lightThreshold = threshold;
-		cam1.useFog = useFog;
-		cam1.fogDensity = density;
-		cam1.lightThreshold = threshold;
+		this->useFog = useFog;
+		this->fogDensity = density;
+		this->lightThreshold = threshold;
 	}
 	
 	void OmniCam::setPixelOperationFunctor(PixelOperationFunctor *pixelOperationFunctor)
 	{
-		cam0.pixelOperation = pixelOperationFunctor;
-		cam1.pixelOperation = pixelOperationFunctor;
+		this->pixelOperation = pixelOperationFunctor;
 	}
 }
 
@@ -38,6 +38,7 @@
 #include "../PhysicalEngine.h"
 
 #include <valarray>
+#include <vector>
 
 /*!	\file CircularCam.h
 	\brief Header of the 1D circular camera
@@ -75,6 +76,16 @@ namespace Enki
 		Vector absPos;
 		//! Absolute angle in the world, updated on init()
 		double absOrientation;
+		//! Rotation from world to camera coordinates, updated on init()
+		Matrix22 worldToCamera;
+		//! Direction of every pixel in camera coordinates, updated on init() when the field of view changes
+		std::vector<Vector> pixelDirections;
+		//! Value of halfFieldOfView for which pixelDirections were computed
+		double pixelDirectionsHalfFieldOfView;
+		//! Vertices of the hull part being drawn in camera coordinates, scratch buffer of objectStep()
+		std::vector<Vector> projectedVertices;
+		//! Angles of projectedVertices, scratch buffer of objectStep()
+		std::vector<double> projectedAngles;
 
 	public:
 		//! zbuffer: distances at square (array of size pixelCount of double)
@@ -93,7 +104,7 @@ namespace Enki
 		//! Minimum incoming light, otherwise 0. Only used if useFog is true
 		Color lightThreshold;
 		
-		//! Pointer to active pixel operation
+		//! Pointer to active pixel operation; the default depth test is inlined by the rasteriser, custom ones are called for each pixel
 		PixelOperationFunctor *pixelOperation;
 
 	public :
@@ -113,6 +124,8 @@ namespace Enki
 		virtual void objectStep(double dt, World *w, PhysicalObject *po);
 		virtual void wallsStep(double dt, World* w);
 		virtual void finalize(double dt, World* w);
+		virtual void saveState(Snapshot& snapshot) const;
+		virtual void restoreState(Snapshot& snapshot);
 		
 		//! Change the sight range of the camera
 		void setRange(double range);
@@ -124,14 +137,23 @@ namespace Enki
 	protected:
 		//! Return linear interpolated value between d0 and d1, given a sensorvalue sv between s0 and s1
 		double interpolateLinear(double s0, double s1, double sv, double d0, double d1);
-		//! Draw a textured line from point p0 to p1 using texture - WTF are p0 and p1??
+		//! Draw a textured line from point p0 to p1 using texture, p0 and p1 being in world coordinates
 		void drawTexturedLine(const Point &p0, const Point &p1, const Texture &texture);
+		//! Draw a textured line from point p0c to p1c using texture, p0c and p1c being in camera coordinates and p0dir and p1dir being their angles
+		void drawProjectedLine(Vector p0c, double p0dir, Vector p1c, double p1dir, const Texture &texture);
+		//! Recompute pixelDirections if the field of view or the number of pixels changed
+		void updatePixelDirections();
 	};
 	
 	
-	//! 1D omnidirectional circular camera, based on 2 CircularCam
-	//! Pixels start at -PI and then follow mathematical orientation to PI
-	/*! \ingroup interaction */
+	//! 1D omnidirectional circular camera
+	/*!
+		Pixels start at -PI and then follow mathematical orientation to PI.
+		The image is made of two halves of halfPixelCount pixels, covering [-PI; 0] and [0; PI],
+		so pixels at angle 0 and PI are present twice. Every object is projected once and
+		angles wrapping around PI are handled by the rasteriser.
+		\ingroup interaction
+	*/
 	class OmniCam : public LocalInteraction
 	{
 	public:
@@ -141,10 +163,29 @@ namespace Enki
 		std::valarray<Color> image;
 		
 	protected:
-		//! Cameras doing the real job, first part
-		CircularCam cam0;
-		//! Cameras doing the real job, second part
-		CircularCam cam1;
+		//! Height above ground, the camera will not see any object of smaller height
+		double height;
+		//! Absolute position in the world, updated on init()
+		Vector absPos;
+		//! Absolute angle in the world, updated on init()
+		double absOrientation;
+		//! Rotation from world to camera coordinates, updated on init()
+		Matrix22 worldToCamera;
+		//! Direction of every pixel in camera coordinates
+		std::vector<Vector> pixelDirections;
+		//! Vertices of the hull part being drawn in camera coordinates, scratch buffer of objectStep()
+		std::vector<Vector> projectedVertices;
+		//! Angles of projectedVertices, scratch buffer of objectStep()
+		std::vector<double> projectedAngles;
+		
+		//! Fog switch, exponential decay of light with distance
+		bool useFog;
+		//! Density of fog, used to compute light attenuation with the function: light = light0 * exp(-fogDensity * distance)
+		double fogDensity;
+		//! Minimum incoming light, otherwise 0. Only used if useFog is true
+		Color lightThreshold;
+		//! Pointer to active pixel operation; the default depth test is inlined by the rasteriser, custom ones are called for each pixel
+		PixelOperationFunctor *pixelOperation;
 
 	public :
 		//! Constructor
@@ -160,12 +201,24 @@ namespace Enki
 		virtual void objectStep(double dt, World *w, PhysicalObject *po);
 		virtual void wallsStep(double dt, World* w);
 		virtual void finalize(double dt, World* w);
+		virtual void saveState(Snapshot& snapshot) const;
+		virtual void restoreState(Snapshot& snapshot);
 		//! Change the sight range of the camera
 		void setRange(double range);
 		//! Change the fog condition for this camera. If useFog is true, an exponential fog with density will be used. Additionally, a threshold can be applied on the resulting color
 		void setFogConditions(bool useFog, double density = 0.0, Color threshold = Color::black);
 		//! Change the pixel operation functor
 		void setPixelOperationFunctor(PixelOperationFunctor *pixelOperationFunctor);
+		
+	protected:
+		//! Draw a textured line from point p0 to p1 using texture, p0 and p1 being in world coordinates
+		void drawTexturedLine(const Point &p0, const Point &p1, const Texture &texture);
+		//! Draw a textured line from point p0c to p1c using texture, p0c and p1c being in camera coordinates and p0dir and p1dir being their angles
+		void drawProjectedLine(Vector p0c, double p0dir, Vector p1c, double p1dir, const Texture &texture);
+		//! Apply the pixel operation to pixels [begin; end] with color at distance² dist2
+		void drawSpan(size_t begin, size_t end, double dist2, const Color &color);
+		//! Draw pixels [begin; end] of the textured line from p0c to p0c + p10c, in camera coordinates
+		void drawTexturedSpan(size_t begin, size_t end, const Vector &p0c, const Vector &p10c, const Texture &texture, bool invertTextureIndex);
 	};
 }
 #endif
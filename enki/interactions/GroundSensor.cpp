@@ -47,31 +47,13 @@ namespace Enki
 		sFactor(sFactor),
 		mFactor(mFactor),
 		aFactor(aFactor),
-		noiseSd(noiseSd)
+		noiseSd(noiseSd),
+		spatialSd(spatialSd),
+		groundMap(0),
+		groundMapWorldUid(0)
 	{
 		assert(owner);
 		this->owner = owner;
-		// compute kernel up to a constant factor
-		const double var(spatialSd * spatialSd);
-		double sum(0);
-		for (int i = 0; i < 9; ++i)
-		{
-			for (int j = 0; j < 9; ++j)
-			{
-				const double x(double(i-4) / 4.);
-				const double y(double(j-4) / 4.);
-				filter[i][j] = exp(-(x * x + y * y) / (2. * var));
-				sum += filter[i][j];
-			}
-		}
-		// renormalize function
-		for (int i = 0; i < 9; ++i)
-		{
-			for (int j = 0; j < 9; ++j)
-			{
-				filter[i][j] /= sum; 
-			}
-		}
 	}
 	
 	static double _sigm(double x, double s)
@@ -86,19 +68,27 @@ namespace Enki
 		absPos = owner->pos + rot * pos;
 		
 		// compute sensor value on a gaussian filtered ground
-		double v(0);
-		for (int i = 0; i < 9; ++i)
+		if (!groundMap || groundMapWorldUid != w->getUid())
 		{
-			for (int j = 0; j < 9; ++j)
-			{
-				const double x(double(i-4) / 4.);
-				const double y(double(j-4) / 4.);
-				const double groundIntensity(w->getGroundColor(Point(absPos.x+x, absPos.y+y)).toGray());
-				v += filter[i][j] * groundIntensity;
-			}
+			groundMap = w->getGroundMap(spatialSd);
+			groundMapWorldUid = w->getUid();
 		}
+		const double v(groundMap->getIntensity(absPos));
 		
 		// changing value to response space and adding Gaussian noise before returning value
-		finalValue = gaussianRand(_sigm(v - cFactor, sFactor) * mFactor + aFactor, noiseSd);
+		RandomStream randomStream(owner->getRandomStream(randomStreamId));
+		finalValue = randomStream.gaussian(_sigm(v - cFactor, sFactor) * mFactor + aFactor, noiseSd);
+	}
+	
+	void GroundSensor::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(absPos);
+		snapshot.writeValue(finalValue);
+	}
+	
+	void GroundSensor::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readValue(absPos);
+		snapshot.readValue(finalValue);
 	}
 }
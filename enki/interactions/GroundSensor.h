@@ -48,7 +48,8 @@ namespace Enki
 	
 	This sensor scans the intensity of a 2x2 cm square on the ground.
 	It does 9x9 measurements, using a Gaussian model with a given spatialSd standard deviation,
-	and a noiseSd Gaussian measurement error.
+	and a noiseSd Gaussian measurement error. These measurements are pre-computed over the whole
+	ground by World::getGroundMap(), so a reading costs a bilinear interpolation.
 	
 	The resulted value v is transformed into a noiseless value finalNoiseless:
 	
@@ -78,8 +79,12 @@ namespace Enki
 		//! Standard deviation of Gaussian noise in the response space
 		const double noiseSd;
 		
-		//! Pre-computed coefficient to filter ground image on a 2x2 cm square, with a 0.25 cm resolution
-		double filter[9][9];
+		//! Standard deviation of the reading beam on the ground
+		const double spatialSd;
+		//! Ground of the world of the last step, filtered with the Gaussian kernel of this sensor
+		const GroundMap* groundMap;
+		//! Unique identifier of the world groundMap belongs to
+		unsigned long groundMapWorldUid;
 		
 		//! Final sensor value
 		double finalValue;
@@ -99,6 +104,10 @@ namespace Enki
 		GroundSensor(Robot *owner, Vector pos, double cFactor, double sFactor, double mFactor, double aFactor, double spatialSd = 0.4, double noiseSd = 0.);
 		//! Compute absolute position
 		void init(double dt, World* w);
+		//! Write the final sensor value
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot);
 		
 		//! Reset intensity value
 		//! Return the final sensor value
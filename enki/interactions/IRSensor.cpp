@@ -37,6 +37,9 @@
 #include <sstream>
 #include <limits>
 #include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 /*!	\file IRSensor.cpp
 	\brief Implementation of the generic infrared sensor
@@ -69,10 +72,18 @@ namespace Enki
 		rayDists.resize(rayCount);
 		rayValues.resize(rayCount);
 		rayAngles.resize(rayCount);
+		rayDirs.resize(rayCount);
 		absRayAngles.resize(rayCount);
+		absRayDirsX.resize(rayCount);
+		absRayDirsY.resize(rayCount);
+		objectRayDists.resize(rayCount);
+		objectRayHits.resize(rayCount);
 		// compute ray orientation
 		for (size_t i = 0; i<rayCount; i++)
+		{
 			rayAngles[i] = - aperture + (i*2.0*aperture)/(rayCount-1.0);
+			rayDirs[i] = Vector(cos(orientation + rayAngles[i]), sin(orientation + rayAngles[i]));
+		}
 		// calculate interaction radius, which is measured from center of robot
 		this->r = sqrt(pos.norm2()+range*range-2*pos.norm()*range*cos(M_PI-orientation+pos.angle()));
 		// calculate the smartRadius
@@ -94,9 +105,14 @@ namespace Enki
 		const Matrix22 rot(owner->angle);
 		absPos = owner->pos + rot * pos;
 		absOrientation = owner->angle + orientation;
-		// compute correct absolute angles
+		// compute correct absolute angles, and directions by rotating the relative ones
 		for (size_t i = 0; i<rayCount; i++)
+		{
 			absRayAngles[i] = absOrientation + rayAngles[i];
+			const Vector absRayDir(rot * rayDirs[i]);
+			absRayDirsX[i] = absRayDir.x;
+			absRayDirsY[i] = absRayDir.y;
+		}
 		// calculate current position of center of central ray
 		absSmartPos = rot * smartPos + absPos;
 	}
@@ -123,60 +139,65 @@ namespace Enki
 		const Vector v1 = po->pos-absPos;
 		// Radius squared of object
 		const double r2 = radius * radius;
-		// The number of rays
 		
 		if (po->isCylindric())
 		{
-			// Calculate distance for each ray...
+			// Calculate distance for all rays at once
+			castRaysOnCircle(rayCount, &absRayDirsX[0], &absRayDirsY[0], v1, r2, &objectRayDists[0]);
 			for (size_t i = 0; i<rayCount; i++)
-			{
-				double dist = HUGE_VAL;
-				// angle between sensor ray and v1
-				const double myAngle = absRayAngles[i] - v1.angle();
-				const double sine = sin(myAngle);
-				// normal distance of bounding circle center to sensor ray
-				const double distsc2 = v1.norm2() * (sine * sine);
-				
-				// if there is an intersection with the object's bounding circle
-				if (distsc2 <= r2)
-				{
-					// compute distance of intersection with bounding circle
-					dist = (sqrt(v1.norm2()-distsc2) - sqrt(r2-distsc2));
-					dist = std::max(dist, 0.);
-					updateRay(i, dist);
-				}
-			}
+				updateRay(i, objectRayDists[i]);
 		}
 		else
 		{
-			// Calculate distance for each ray...
+			// Find the rays that intersect the object's bounding circle
+			bool anyRayHit = false;
 			for (size_t i = 0; i<rayCount; i++)
 			{
-				double dist = HUGE_VAL;
-				// angle between sensor ray and v1
-				const double myAngle = absRayAngles[i] - v1.angle();
-				const double sine = sin(myAngle);
 				// normal distance of bounding circle center to sensor ray
-				const double distsc2 = v1.norm2() * (sine * sine);
+				const double cross = absRayDirsX[i] * v1.y - absRayDirsY[i] * v1.x;
+				objectRayHits[i] = cross * cross < r2;
+				anyRayHit = anyRayHit || objectRayHits[i];
+			}
+			if (!anyRayHit)
+				return;
+			
+			// iterate over all shapes
+			for (PhysicalObject::Hull::const_iterator it = po->getHull().begin(); it != po->getHull().end(); ++it)
+			{
+				if (height > it->getHeight())
+					continue;
 				
-				// if there is an intersection with the object's bounding circle
-				if (distsc2 < r2)
-				{
-					// iterate over all shapes
-					for (PhysicalObject::Hull::const_iterator it = po->getHull().begin(); it != po->getHull().end(); ++it)
-					{
-						if (height > it->getHeight())
-							continue;
-						
-						// check intersection with polygon
-						dist = distanceToPolygon(absRayAngles[i], it->getTransformedShape());
-						updateRay(i, dist);
-					}
-				}
+				// check intersection of all rays with polygon
+				castRaysOnPolygon(rayCount, &absRayDirsX[0], &absRayDirsY[0], range, absPos, it->getTransformedShape(), &objectRayDists[0]);
+				for (size_t i = 0; i<rayCount; i++)
+					if (objectRayHits[i])
+						updateRay(i, objectRayDists[i]);
 			}
 		}
 	}
 
+	void IRSensor::staticSceneStep(double dt, World* w, const StaticScene& scene)
+	{
+		// castRaysOnCircle() also gives hits behind the sensor, so the rays are cast both ways
+		staticObjects.clear();
+		for (size_t i = 0; i<rayCount; i++)
+		{
+			const Vector ray(Vector(absRayDirsX[i], absRayDirsY[i]) * range);
+			scene.getRayNeighbours(absPos - ray, ray * 2, staticObjects);
+		}
+		std::sort(staticObjects.begin(), staticObjects.end());
+		staticObjects.erase(std::unique(staticObjects.begin(), staticObjects.end()), staticObjects.end());
+		
+		// only these objects can be hit, the other ones are filtered as in Robot::doLocalInteractions()
+		for (size_t i = 0; i < staticObjects.size(); i++)
+		{
+			PhysicalObject* po(scene.getObject(staticObjects[i]));
+			const Vector vectCenter(owner->pos - po->pos);
+			if ((po != owner) && (vectCenter.norm2() < (r + po->getRadius()) * (r + po->getRadius())))
+				objectStep(dt, w, po);
+		}
+	}
+	
 	void IRSensor::wallsStep (double dt, World* w)
 	{
 		switch (w->wallsType)
@@ -197,7 +218,7 @@ namespace Enki
 		
 				for (size_t i = 0; i < rayCount; i++)
 				{
-					const Vector rayDir(cos(absRayAngles[i]), sin(absRayAngles[i]));
+					const Vector rayDir(absRayDirsX[i], absRayDirsY[i]);
 					
 					// the absolute position of the sensor ray's end point
 					const Point absRayEndPoint = absPos+rayDir*range;
@@ -236,17 +257,13 @@ namespace Enki
 				
 				for (size_t i = 0; i < rayCount; i++)
 				{
-					// inside the world
-					const double c2(absPos.norm2());
-					const double c(sqrt(c2));
-					const double alpha(absRayAngles[i] - absPos.angle());
-					const double bp(-c*cos(alpha) + sqrt(r2-c2*sin(alpha)*sin(alpha)));
-					const double bm(-c*cos(alpha) - sqrt(r2-c2*sin(alpha)*sin(alpha)));
-					double dist;
-					if (cos(alpha) < 0)
-						dist = std::min(bp, bm);
-					else
-						dist = std::max(bp, bm);
+					// inside the world, the ray absPos + t*rayDir hits the wall for t solving
+					// t^2 + 2*t*projection + |absPos|^2 - r^2 = 0, whose roots have opposite signs;
+					// as |absPos|^2 - projection^2 = cross^2, the positive root is:
+					const Vector rayDir(absRayDirsX[i], absRayDirsY[i]);
+					const double projection(rayDir * absPos);
+					const double cross(rayDir.cross(absPos));
+					const double dist(-projection + sqrt(r2 - cross*cross));
 					updateRay(i, dist);
 				}
 			}
@@ -261,10 +278,31 @@ namespace Enki
 	void IRSensor::finalize(double dt, World* w)
 	{
 		finalValue = rayValues[0] + rayValues[1] + rayValues[2];
-		finalValue = std::max(0., std::min(m, gaussianRand(finalValue, noiseSd)));
+		RandomStream randomStream(owner->getRandomStream(randomStreamId));
+		finalValue = std::max(0., std::min(m, randomStream.gaussian(finalValue, noiseSd)));
 		finalDist = inverseResponseFunction(finalValue);
 	}
 	
+	void IRSensor::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(absPos);
+		snapshot.writeValue(absOrientation);
+		snapshot.writeArray(rayDists);
+		snapshot.writeArray(rayValues);
+		snapshot.writeValue(finalValue);
+		snapshot.writeValue(finalDist);
+	}
+	
+	void IRSensor::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readValue(absPos);
+		snapshot.readValue(absOrientation);
+		snapshot.readArray(rayDists);
+		snapshot.readArray(rayValues);
+		snapshot.readValue(finalValue);
+		snapshot.readValue(finalDist);
+	}
+	
 	void IRSensor::updateRay(size_t i, double dist)
 	{
 		// if we have a smaller distance than the initial one, replace it
@@ -310,32 +348,126 @@ namespace Enki
 		return std::min(dist, range);
 	}
 	
+	void IRSensor::castRaysOnCircle(unsigned count, const double* dirsX, const double* dirsY, const Vector& v, double r2, double* dists, bool vectorised)
+	{
+		// for every ray, the distance is the projection of v on the ray minus half the chord,
+		// if the distance of the center of the circle to the ray, given by the cross product, is below the radius
+		unsigned i = 0;
+		#ifdef __SSE2__
+		if (vectorised)
+		{
+			const __m128d vx(_mm_set1_pd(v.x));
+			const __m128d vy(_mm_set1_pd(v.y));
+			const __m128d radius2(_mm_set1_pd(r2));
+			const __m128d zero(_mm_setzero_pd());
+			const __m128d huge(_mm_set1_pd(HUGE_VAL));
+			const __m128d absMask(_mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffffLL)));
+			for (; i + 2 <= count; i += 2)
+			{
+				const __m128d dx(_mm_loadu_pd(dirsX + i));
+				const __m128d dy(_mm_loadu_pd(dirsY + i));
+				const __m128d cross(_mm_sub_pd(_mm_mul_pd(dx, vy), _mm_mul_pd(dy, vx)));
+				const __m128d distsc2(_mm_mul_pd(cross, cross));
+				const __m128d projection(_mm_and_pd(_mm_add_pd(_mm_mul_pd(dx, vx), _mm_mul_pd(dy, vy)), absMask));
+				const __m128d hit(_mm_cmple_pd(distsc2, radius2));
+				// max with zero as first operand, to get the same sign of zero as std::max(x, 0.)
+				const __m128d halfChord(_mm_sqrt_pd(_mm_max_pd(zero, _mm_sub_pd(radius2, distsc2))));
+				const __m128d dist(_mm_max_pd(zero, _mm_sub_pd(projection, halfChord)));
+				_mm_storeu_pd(dists + i, _mm_or_pd(_mm_and_pd(hit, dist), _mm_andnot_pd(hit, huge)));
+			}
+		}
+		#endif
+		for (; i < count; ++i)
+		{
+			const double cross(dirsX[i] * v.y - dirsY[i] * v.x);
+			const double distsc2(cross * cross);
+			if (distsc2 <= r2)
+			{
+				const double projection(fabs(dirsX[i] * v.x + dirsY[i] * v.y));
+				const double halfChord(sqrt(std::max(r2 - distsc2, 0.)));
+				dists[i] = std::max(projection - halfChord, 0.);
+			}
+			else
+				dists[i] = HUGE_VAL;
+		}
+	}
+	
+	void IRSensor::castRaysOnPolygon(unsigned count, const double* dirsX, const double* dirsY, double length, const Point& origin, const Polygone& p, double* dists, bool vectorised)
+	{
+		// same algorithm as distanceToPolygon(), but rays do not return early, they are marked as missing instead
+		unsigned i = 0;
+		#ifdef __SSE2__
+		if (vectorised)
+		{
+			const int n = p.size();
+			const __m128d len(_mm_set1_pd(length));
+			const __m128d zero(_mm_setzero_pd());
+			const __m128d one(_mm_set1_pd(1.0));
+			const __m128d epsilon(_mm_set1_pd(0.00000001));
+			const __m128d signMask(_mm_set1_pd(-0.0));
+			const __m128d huge(_mm_set1_pd(HUGE_VAL));
+			for (; i + 2 <= count; i += 2)
+			{
+				// the segment direction vector
+				const __m128d dSx(_mm_mul_pd(_mm_loadu_pd(dirsX + i), len));
+				const __m128d dSy(_mm_mul_pd(_mm_loadu_pd(dirsY + i), len));
+				__m128d tE(zero);
+				__m128d tL(one);
+				__m128d miss(_mm_setzero_pd());
+				for (int j = 0; j < n; j++)
+				{
+					const Vector e(p[j == n-1 ? 0: j + 1] - p[j]);
+					const __m128d N(_mm_set1_pd(e.cross(origin - p[j])));
+					const __m128d D(_mm_xor_pd(_mm_sub_pd(_mm_mul_pd(_mm_set1_pd(e.x), dSy), _mm_mul_pd(_mm_set1_pd(e.y), dSx)), signMask));
+					// S is nearly parallel to this edge, if P0 is outside this edge, S is outside the polygon
+					const __m128d parallel(_mm_cmplt_pd(_mm_andnot_pd(signMask, D), epsilon));
+					miss = _mm_or_pd(miss, _mm_and_pd(parallel, _mm_cmplt_pd(N, zero)));
+					// otherwise update the entering or leaving parameter
+					const __m128d t(_mm_div_pd(N, D));
+					const __m128d entering(_mm_andnot_pd(parallel, _mm_cmplt_pd(D, zero)));
+					const __m128d leaving(_mm_andnot_pd(parallel, _mm_cmpge_pd(D, zero)));
+					const __m128d newTE(_mm_and_pd(entering, _mm_cmpgt_pd(t, tE)));
+					const __m128d newTL(_mm_and_pd(leaving, _mm_cmplt_pd(t, tL)));
+					tE = _mm_or_pd(_mm_and_pd(newTE, t), _mm_andnot_pd(newTE, tE));
+					tL = _mm_or_pd(_mm_and_pd(newTL, t), _mm_andnot_pd(newTL, tL));
+					miss = _mm_or_pd(miss, _mm_and_pd(newTE, _mm_cmpgt_pd(tE, tL)));
+					miss = _mm_or_pd(miss, _mm_and_pd(newTL, _mm_cmplt_pd(tL, tE)));
+				}
+				const __m128d x(_mm_mul_pd(dSx, tE));
+				const __m128d y(_mm_mul_pd(dSy, tE));
+				const __m128d dist(_mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y))));
+				_mm_storeu_pd(dists + i, _mm_or_pd(_mm_andnot_pd(miss, dist), _mm_and_pd(miss, huge)));
+			}
+		}
+		#endif
+		for (; i < count; ++i)
+			dists[i] = distanceToPolygon(Vector(dirsX[i], dirsY[i]), length, origin, p);
+	}
+	
 	// Detect collision with a physical object's bounding polygon
 	// Cyrus & Beck line/polygon intersection algorithm
 	//   adapted by yvan.bourquin@epfl.ch from the
 	//   code from http://softsurfer.com/ (by Dan Sunday)
-	// Input: rayAngle: angle of ray segment to intersect with polygon
+	// Input: dir: unit direction of the ray segment to intersect with polygon
+	// Input: length: length of the ray segment
+	// Input: origin: start of the ray segment
 	// Input: p: polygon
 	//   Note: The polygon MUST be convex and have vertices oriented counterclockwise (ccw).
 	// This code does not check for and verify these conditions.
 	// Return: distance to shortest intersection point
 	//   or HUGE_VAL if there's no intersection
-	double IRSensor::distanceToPolygon(double rayAngle, const Polygone &p) const 
+	double IRSensor::distanceToPolygon(const Vector& dir, double length, const Point& origin, const Polygone &p)
 	{
-		// compute ray segment in global coordinates
-		Point absEnd = absPos + Vector(cos(rayAngle), sin(rayAngle)) * range;
-		Segment ray(absPos.x, absPos.y, absEnd.x, absEnd.y);
-
 		const int n = p.size();         // number of points in the polygon
 		double tE = 0.0;          // the maximum entering segment parameter
 		double tL = 1.0;          // the minimum leaving segment parameter
 		double t, N, D;           // intersect parameter t = N / D
-		Vector dS(ray.b - ray.a); // the segment direction vector
+		const Vector dS(dir * length); // the segment direction vector
 
 		for (int i = 0; i < n; i++)     			// process polygon edge V[i]V[i+1] 
 		{
 			Vector e(p[i == n-1 ? 0: i + 1] - p[i]);	// edge vector
-			N = e.cross(ray.a - p[i]);			// = -dot(ne, S.P0-V[i])
+			N = e.cross(origin - p[i]);			// = -dot(ne, S.P0-V[i])
 			D = -e.cross(dS);				// = dot(ne, dS)
 			
 			// S is nearly parallel to this edge
@@ -375,9 +507,8 @@ namespace Enki
 		}
 
 		// tE <= tL implies that there is a valid intersection subsegment
-		// ray.a + tE * dS = point where S enters polygon
-		// ray.a + tL * dS = point where S leaves polygon
+		// origin + tE * dS = point where S enters polygon
+		// origin + tL * dS = point where S leaves polygon
   		return (dS * tE).norm();
 	}
 }
-
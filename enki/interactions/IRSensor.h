@@ -125,8 +125,20 @@ namespace Enki
 		std::vector<double> rayValues;
 		//! The angle for each ray relative to the sensor orientation in relative (robot) coordinates
 		std::vector<double> rayAngles;
+		//! The unit direction of each ray in relative (robot) coordinates
+		std::vector<Vector> rayDirs;
 		//! The angle for each ray relative to the sensor orientation in absolute (world) coordinates
 		std::vector<double> absRayAngles;
+		//! The x component of the unit direction of each ray in absolute (world) coordinates, updated on init()
+		std::vector<double> absRayDirsX;
+		//! The y component of the unit direction of each ray in absolute (world) coordinates, updated on init()
+		std::vector<double> absRayDirsY;
+		//! Temporary distances of rays to the current object
+		std::vector<double> objectRayDists;
+		//! Temporary flags of the rays crossing the bounding circle of the current object
+		std::vector<char> objectRayHits;
+		//! Temporary numbers of the static objects crossed by the rays, see staticSceneStep()
+		StaticScene::Indices staticObjects;
 	
 		//! Final sensor value
 		double finalValue;
@@ -151,10 +163,18 @@ namespace Enki
 		void init(double dt, World* w);
 		//! Check for all potential intersections using smartRadius of sensor and calculate and find closest distance for each ray.
 		void objectStep(double dt, World *w, PhysicalObject *po);
+		//! Return true, static objects are found by casting the rays into the static scene
+		virtual bool usesStaticScene() const { return true; }
+		//! Call objectStep() for the static objects whose bounding box is crossed by the rays
+		virtual void staticSceneStep(double dt, World* w, const StaticScene& scene);
 		//! Separated from objectStep because it is much simpler. 
 		void wallsStep(double dt, World* w);
 		//! Applies the SensorResponseFunction to each ray and combines all rays using weights defined in the rayCombinationKernel.
 		void finalize(double dt, World* w);
+		//! Write the values and distances of the rays and the final ones
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot);
 		
 		//! Return the final sensor value
 		double getValue(void) const { return finalValue; }
@@ -165,6 +185,30 @@ namespace Enki
 		//! Return the distance of a ray
 		double getRayDist(unsigned i) const { return rayDists.at(i); }
 		
+		//! Compute the distances from the sensor along count rays to a circle
+		/*!
+			\param count number of rays
+			\param dirsX x components of the unit directions of the rays
+			\param dirsY y components of the unit directions of the rays
+			\param v vector from the sensor to the center of the circle
+			\param r2 squared radius of the circle
+			\param dists resulting distances, HUGE_VAL for rays that do not intersect the circle
+			\param vectorised whether to use SIMD instructions if available, results are identical in both cases
+		*/
+		static void castRaysOnCircle(unsigned count, const double* dirsX, const double* dirsY, const Vector& v, double r2, double* dists, bool vectorised = true);
+		//! Compute the distances from the sensor along count rays of a given length to a convex polygon
+		/*!
+			\param count number of rays
+			\param dirsX x components of the unit directions of the rays
+			\param dirsY y components of the unit directions of the rays
+			\param length length of the rays
+			\param origin start of the rays
+			\param p polygon, which MUST be convex and have vertices oriented counterclockwise (ccw)
+			\param dists resulting distances, HUGE_VAL for rays that do not intersect the polygon
+			\param vectorised whether to use SIMD instructions if available, results are identical in both cases
+		*/
+		static void castRaysOnPolygon(unsigned count, const double* dirsX, const double* dirsY, double length, const Point& origin, const Polygone& p, double* dists, bool vectorised = true);
+		
 		//! Return the absolute position of the IR sensor, updated at each time step on init()
 		Point getAbsolutePosition(void) const { return absPos; }
 		//! Return the absolute orientation of the IR sensor, updated at each time step on init()
@@ -187,9 +231,9 @@ namespace Enki
 		double responseFunction(double x) const;
 		//! Return the inverse response for a given distance
 		double inverseResponseFunction(double v) const;
-		//! Returns distance to PhysicalObject po for angle rayAngle.
+		//! Return the distance from origin to polygon p along the ray of direction dir and given length, using the Cyrus-Beck algorithm.
 		//! Note: The polygon MUST be convex and have vertices oriented counterclockwise (ccw). This code does not check for and verify these conditions. Returns distance to shortest intersection point or HUGE_VAL if there is no intersection
-		double distanceToPolygon(double rayAngle, const Polygone &p) const;
+		static double distanceToPolygon(const Vector& dir, double length, const Point& origin, const Polygone &p);
 	};
 }
 
@@ -141,6 +141,18 @@ namespace Enki
 	{
 		return micAbsPos;
 	}
+	
+	void Microphone::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(micAbsPos);
+		snapshot.writeArray(acquiredSound, noOfChannels);
+	}
+	
+	void Microphone::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readValue(micAbsPos);
+		snapshot.readArray(acquiredSound, noOfChannels);
+	}
 		
 	FourWayMic::FourWayMic(Robot *owner, double micDist, double range, 
 						   MicrophoneResponseModel micModel, unsigned channels)
@@ -256,4 +268,22 @@ namespace Enki
 	{
 		return allMicAbsPos[micNo];
 	}
+	
+	void FourWayMic::saveState(Snapshot& snapshot) const
+	{
+		for (size_t i = 0; i < 4; i++)
+		{
+			snapshot.writeValue(allMicAbsPos[i]);
+			snapshot.writeArray(acquiredSound[i], noOfChannels);
+		}
+	}
+	
+	void FourWayMic::restoreState(Snapshot& snapshot)
+	{
+		for (size_t i = 0; i < 4; i++)
+		{
+			snapshot.readValue(allMicAbsPos[i]);
+			snapshot.readArray(acquiredSound[i], noOfChannels);
+		}
+	}
 }
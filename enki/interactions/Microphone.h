@@ -82,6 +82,10 @@ namespace Enki
 		void init();
 		//! Check for local interactions with other physical objects
 		virtual void objectStep(double dt, PhysicalObject *po, World *w);
+		//! Write the sound buffer
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot);
 		//! Reset sound buffer to 0 after one time-step in experiment
 		void resetSound(void);
 		//! Return frequencies of input sound
@@ -125,6 +129,10 @@ namespace Enki
 		void init();
 		//! Check for local interactions with other physical objects
 		virtual void objectStep(double dt, PhysicalObject *po, World *w);
+		//! Write the sound buffers of the four microphones
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot);
 		//! Reset sound buffer to 0 after one time-step in experiment
 		void resetSound(void);
 		//! Return frequencies of input sound
@@ -71,13 +71,14 @@ namespace Enki
 		// +/- noiseAmout % of motor noise
 		const double baseFactor = 1 - noiseAmount;
 		const double noiseFactor = 2 * noiseAmount;
+		RandomStream randomStream(getRandomStream(0));
 		
 		const double realLeftSpeed = clamp(
-			leftSpeed * (baseFactor + random.getRange(noiseFactor)),
+			leftSpeed * (baseFactor + randomStream.getRange(noiseFactor)),
 			-maxSpeed,maxSpeed
 		);
 		const double realRightSpeed = clamp(
-			rightSpeed * (baseFactor + random.getRange(noiseFactor)),
+			rightSpeed * (baseFactor + randomStream.getRange(noiseFactor)),
 			-maxSpeed, maxSpeed
 		);
 		
@@ -104,5 +105,31 @@ namespace Enki
 		angSpeed = cmdAngSpeed;
 		speed = cmdVelocity;
 	}
+	
+	void DifferentialWheeled::saveState(Snapshot& snapshot) const
+	{
+		Robot::saveState(snapshot);
+		snapshot.writeValue(leftSpeed);
+		snapshot.writeValue(rightSpeed);
+		snapshot.writeValue(leftEncoder);
+		snapshot.writeValue(rightEncoder);
+		snapshot.writeValue(leftOdometry);
+		snapshot.writeValue(rightOdometry);
+		snapshot.writeValue(cmdAngSpeed);
+		snapshot.writeValue(cmdSpeed);
+	}
+	
+	void DifferentialWheeled::restoreState(Snapshot& snapshot)
+	{
+		Robot::restoreState(snapshot);
+		snapshot.readValue(leftSpeed);
+		snapshot.readValue(rightSpeed);
+		snapshot.readValue(leftEncoder);
+		snapshot.readValue(rightEncoder);
+		snapshot.readValue(leftOdometry);
+		snapshot.readValue(rightOdometry);
+		snapshot.readValue(cmdAngSpeed);
+		snapshot.readValue(cmdSpeed);
+	}
 }
 
@@ -32,6 +32,7 @@
 */
 
 #include "EPuck.h"
+#include "../../ResponseTable.h"
 #include <algorithm>
 #include <functional>
 #include <climits>
@@ -43,6 +44,9 @@ namespace Enki
 {
 	using namespace std;
 	
+	//! Response of the scanner turret, tabulated every mm up to 4 m, within 0.5 of the calibrated function; beyond 4 m, the response is below 0.001
+	static const ResponseTable<4001> scannerTurretResponseTable(EPuckScannerTurret::responseFunction, 0, 400);
+	
 	EPuckScannerTurret::EPuckScannerTurret(Robot *owner, double height, unsigned halfPixelCount) :
 		OmniCam(owner, height, halfPixelCount),
 		scan(halfPixelCount * 2)
@@ -54,6 +58,29 @@ namespace Enki
 		OmniCam::finalize(dt, w);
 		
 		// apply sensor response
+		assert(scan.size() == zbuffer.size());
+		
+		for (size_t i = 0; i < zbuffer.size(); i++)
+		{
+			size_t destIndex = ((scan.size()/2) -1 + scan.size() - i) % scan.size();
+			scan[destIndex] = scannerTurretResponseTable(sqrt(zbuffer[i]));
+		}
+	}
+	
+	void EPuckScannerTurret::saveState(Snapshot& snapshot) const
+	{
+		OmniCam::saveState(snapshot);
+		snapshot.writeArray(scan);
+	}
+	
+	void EPuckScannerTurret::restoreState(Snapshot& snapshot)
+	{
+		OmniCam::restoreState(snapshot);
+		snapshot.readArray(scan);
+	}
+	
+	double EPuckScannerTurret::responseFunction(double x)
+	{
 		const double a1 =        1116;
 		const double b1 =       56.92;
 		const double c1 =       26.26;
@@ -64,15 +91,9 @@ namespace Enki
 		const double b3 = -1.908e+004;
 		const double c3 =        3433;
 		
-		assert(scan.size() == zbuffer.size());
-		
-		for (size_t i = 0; i < zbuffer.size(); i++)
-		{
-			// calibration was done in mm, convert to cm
-			double x = sqrt(zbuffer[i]) * 10;
-			size_t destIndex = ((scan.size()/2) -1 + scan.size() - i) % scan.size();
-			scan[destIndex] = a1*exp(-((x-b1)/c1)*((x-b1)/c1)) + a2*exp(-((x-b2)/c2)*((x-b2)/c2)) + a3*exp(-((x-b3)/c3)*((x-b3)/c3));
-		}
+		// calibration was done in mm, convert to cm
+		x *= 10;
+		return a1*exp(-((x-b1)/c1)*((x-b1)/c1)) + a2*exp(-((x-b2)/c2)*((x-b2)/c2)) + a3*exp(-((x-b3)/c3)*((x-b3)/c3));
 	}
 	
 	
@@ -63,6 +63,11 @@ namespace Enki
 		EPuckScannerTurret(Robot *owner, double height, unsigned halfPixelCount);
 		
 		virtual void finalize(double dt, World* w);
+		virtual void saveState(Snapshot& snapshot) const;
+		virtual void restoreState(Snapshot& snapshot);
+		
+		//! Return the calibrated response of the physical sensor for an object at distance x, in cm; finalize() uses a tabulated version of it
+		static double responseFunction(double x);
 	
 	public:
 		std::valarray<double> scan;
@@ -43,6 +43,8 @@
 
 namespace Enki
 {
+	//! Return the response of a virtual bumper of the marXbot to an obstacle at dist, with noise drawn from randomStream
+	double marxbotVirtualBumperResponseFunction(double dist, RandomStream& randomStream);
 	
 	//! A very simplified model of the Sbot mobile robot.
 	/*! Only implement distance sensors, both short and long range, using an omnicam.
@@ -136,6 +136,22 @@ namespace Enki
 		lastDEnergy = dEnergy;
 		dEnergy = 0;
 	}
+	
+	void FeedableSbot::saveState(Snapshot& snapshot) const
+	{
+		Sbot::saveState(snapshot);
+		snapshot.writeValue(energy);
+		snapshot.writeValue(dEnergy);
+		snapshot.writeValue(lastDEnergy);
+	}
+	
+	void FeedableSbot::restoreState(Snapshot& snapshot)
+	{
+		Sbot::restoreState(snapshot);
+		snapshot.readValue(energy);
+		snapshot.readValue(dEnergy);
+		snapshot.readValue(lastDEnergy);
+	}
 
 	SoundSbot::SoundSbot() :
 		// microphones can pick up sound reaching up to 1m away
@@ -68,6 +68,10 @@ namespace Enki
 		virtual void init() { worldFrequenciesState = 0; }
 		//! Emit our frequencies to the world
 		virtual void step(double dt, World *w) { worldFrequenciesState |= frequenciesState; }
+		//! Write our frequencies
+		virtual void saveState(Snapshot& snapshot) const { snapshot.writeValue(frequenciesState); }
+		//! Read our frequencies
+		virtual void restoreState(Snapshot& snapshot) { snapshot.readValue(frequenciesState); }
 		// FIXME: ugly and not re-entrant, will be removed by ECS refactor
 		//! Return state of the frequencies in the world
 		static unsigned getWorldFrequenciesState(void);
@@ -132,6 +136,10 @@ namespace Enki
 		FeedableSbot() { energy=0; dEnergy=0; lastDEnergy=0; }
 		//! Call DifferentialWheeled::step and compute the new energy
 		virtual void controlStep(double dt) ;
+		//! Write the state of the Sbot and its energy
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot);
 	};
 
 
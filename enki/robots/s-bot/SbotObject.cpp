@@ -87,6 +87,18 @@ namespace Enki
 		}
 	}
 
+	void SbotFeeding::saveState(Snapshot& snapshot) const
+	{
+		snapshot.writeValue(actualEnergy);
+		snapshot.writeValue(actualTime);
+	}
+	
+	void SbotFeeding::restoreState(Snapshot& snapshot)
+	{
+		snapshot.readValue(actualEnergy);
+		snapshot.readValue(actualTime);
+	}
+	
 	void SbotFeeding::finalize(double dt)
 	{
 		if ( activeDuration == -1 )
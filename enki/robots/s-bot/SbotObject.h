@@ -72,6 +72,8 @@ namespace Enki
 		SbotFeeding(double r, Robot *owner);
 		virtual void objectStep (double dt, PhysicalObject *po, World *w);
 		virtual void finalize(double dt);
+		virtual void saveState(Snapshot& snapshot) const;
+		virtual void restoreState(Snapshot& snapshot);
 	};
 
 	//! SbotActiveObject give or remove energy to nearby Sbots through an SbotFeeding interaction
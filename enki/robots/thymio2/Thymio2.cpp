@@ -44,6 +44,30 @@ namespace Enki
 {
 	using namespace std;
 	
+	//! Return the hull of the Thymio II, built once and shared by all robots
+	static const PhysicalObject::Hull& thymio2Hull()
+	{
+		static PhysicalObject::Hull hull;
+		#pragma omp critical(EnkiThymio2Hull)
+		if (hull.empty())
+		{
+			// define the physical shape of the Thymio
+			Enki::Polygone thymio2Shape;
+			const double amount = 10.0;
+			const double radius = 8.0;
+			const double height = 5.1;
+			const double angle1 = asin(5.5/8.0);
+			const double angle2 = atan(5.5/3.0);
+			const double distance = sqrt(3.0*3.0+5.5*5.5);
+			for (double a = -angle1; a < angle1+0.01; a += 2*angle1/amount)
+				thymio2Shape.push_back(Enki::Point(radius * cos(a), radius * sin(a)));        
+			thymio2Shape.push_back(Enki::Point(distance * cos(M_PI - angle2), distance * sin(M_PI - angle2)));
+			thymio2Shape.push_back(Enki::Point(distance * cos(M_PI - angle2), distance * sin(M_PI + angle2)));
+			hull.push_back(Enki::PhysicalObject::Part(thymio2Shape, height));
+		}
+		return hull;
+	}
+	
 	Thymio2::Thymio2() :
 		DifferentialWheeled(9.4, 16.6, 0.027),
 		infraredSensor0(this, Vector(6.2, 4.85),   3.4, 0.69813,  14, 4505, 0.03, 73, 2.87),
@@ -71,20 +95,8 @@ namespace Enki
 		dryFrictionCoefficient = 0.25;
 		dryFrictionCoefficient = 2.5;
 		
-		// define the physical shape of the Thymio
-		Enki::Polygone thymio2Shape;
-		const double amount = 10.0;
-		const double radius = 8.0;
-		const double height = 5.1;
-		const double angle1 = asin(5.5/8.0);
-		const double angle2 = atan(5.5/3.0);
-		const double distance = sqrt(3.0*3.0+5.5*5.5);
-		for (double a = -angle1; a < angle1+0.01; a += 2*angle1/amount)
-			thymio2Shape.push_back(Enki::Point(radius * cos(a), radius * sin(a)));        
-		thymio2Shape.push_back(Enki::Point(distance * cos(M_PI - angle2), distance * sin(M_PI - angle2)));
-		thymio2Shape.push_back(Enki::Point(distance * cos(M_PI - angle2), distance * sin(M_PI + angle2)));
-		Enki::PhysicalObject::Hull hull(Enki::PhysicalObject::Part(thymio2Shape, height));
-		setCustomHull(hull, 200);
+		// the physical shape of the Thymio is shared by all robots
+		setCustomHull(thymio2Hull(), 200);
 		setColor(Color(0.98, 0.98, 0.98));
 
 		textureID = 0;
@@ -163,5 +175,18 @@ namespace Enki
 		else
 			return ledColor[ledIndex];
 	}
+	
+	void Thymio2::saveState(Snapshot& snapshot) const
+	{
+		DifferentialWheeled::saveState(snapshot);
+		snapshot.writeArray(ledColor, LED_COUNT);
+	}
+	
+	void Thymio2::restoreState(Snapshot& snapshot)
+	{
+		DifferentialWheeled::restoreState(snapshot);
+		snapshot.readArray(ledColor, LED_COUNT);
+		ledTextureNeedUpdate = true;
+	}
 }
 
@@ -70,6 +70,8 @@ namespace Enki
 		GroundSensor groundSensor1;
 
 		unsigned int textureID;
+		//! colors of the LEDs used to generate the texture textureID, set by the viewer
+		std::vector<Color> ledTextureColors;
 		unsigned int* ledTexture;
 		bool ledTextureNeedUpdate;
 
@@ -102,6 +104,11 @@ namespace Enki
 		void setLedIntensity(LedIndex ledIndex, double intensity = 1.f);
 		void setLedColor(LedIndex ledIndex, const Color& color = Color(1.,1.,1.,1.));
 		Color getColorLed(LedIndex ledIndex) const;
+		
+		//! Write the state of the robot and the colors of its LEDs
+		virtual void saveState(Snapshot& snapshot) const;
+		//! Read the state written by saveState()
+		virtual void restoreState(Snapshot& snapshot);
 
 	protected:
 		Color ledColor[LED_COUNT];
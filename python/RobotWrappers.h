@@ -0,0 +1,159 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef __ENKI_PYTHON_ROBOTWRAPPERS_H
+#define __ENKI_PYTHON_ROBOTWRAPPERS_H
+
+#include <boost/python.hpp>
+#include "../enki/robots/e-puck/EPuck.h"
+#include "../enki/robots/thymio2/Thymio2.h"
+
+/*!	\file RobotWrappers.h
+	\brief Wrappers of robots whose control step can be overridden from Python, shared by pyenki and pyenkiviewer
+*/
+
+namespace Enki
+{
+	//! Base of the robots whose control step can be overridden from Python
+	struct PythonControlled
+	{
+		//! Whether the Python override of controlStep() is called, false while a world runs with a batch controller
+		bool pythonControlStepEnabled;
+		
+		PythonControlled():
+			pythonControlStepEnabled(true)
+		{}
+	};
+
+	struct EPuckWrap: EPuck, boost::python::wrapper<EPuck>, PythonControlled
+	{
+		EPuckWrap():
+			EPuck(CAPABILITY_BASIC_SENSORS|CAPABILITY_CAMERA)
+		{}
+		
+		virtual void controlStep(double dt)
+		{
+			if (pythonControlStepEnabled)
+				if (boost::python::override controlStep = this->get_override("controlStep"))
+					controlStep(dt);
+			
+			EPuck::controlStep(dt);
+		}
+		
+		boost::python::list getProxSensorValues(void)
+		{
+			boost::python::list l;
+			l.append(infraredSensor0.getValue());
+			l.append(infraredSensor1.getValue());
+			l.append(infraredSensor2.getValue());
+			l.append(infraredSensor3.getValue());
+			l.append(infraredSensor4.getValue());
+			l.append(infraredSensor5.getValue());
+			l.append(infraredSensor6.getValue());
+			l.append(infraredSensor7.getValue());
+			return l;
+		}
+		
+		boost::python::list getProxSensorDistances(void)
+		{
+			boost::python::list l;
+			l.append(infraredSensor0.getDist());
+			l.append(infraredSensor1.getDist());
+			l.append(infraredSensor2.getDist());
+			l.append(infraredSensor3.getDist());
+			l.append(infraredSensor4.getDist());
+			l.append(infraredSensor5.getDist());
+			l.append(infraredSensor6.getDist());
+			l.append(infraredSensor7.getDist());
+			return l;
+		}
+		
+		Texture getCameraImage(void)
+		{
+			Texture texture;
+			texture.reserve(camera.image.size());
+			for (size_t i = 0; i < camera.image.size(); ++i)
+				texture.push_back(camera.image[i]);
+			return texture;
+		}
+	};
+
+	struct Thymio2Wrap: Thymio2, boost::python::wrapper<Thymio2>, PythonControlled
+	{
+		virtual void controlStep(double dt)
+		{
+			if (pythonControlStepEnabled)
+				if (boost::python::override controlStep = this->get_override("controlStep"))
+					controlStep(dt);
+			
+			Thymio2::controlStep(dt);
+		}
+		
+		boost::python::list getProxSensorValues(void)
+		{
+			boost::python::list l;
+			l.append(infraredSensor0.getValue());
+			l.append(infraredSensor1.getValue());
+			l.append(infraredSensor2.getValue());
+			l.append(infraredSensor3.getValue());
+			l.append(infraredSensor4.getValue());
+			l.append(infraredSensor5.getValue());
+			l.append(infraredSensor6.getValue());
+			return l;
+		}
+		
+		boost::python::list getProxSensorDistances(void)
+		{
+			boost::python::list l;
+			l.append(infraredSensor0.getDist());
+			l.append(infraredSensor1.getDist());
+			l.append(infraredSensor2.getDist());
+			l.append(infraredSensor3.getDist());
+			l.append(infraredSensor4.getDist());
+			l.append(infraredSensor5.getDist());
+			l.append(infraredSensor6.getDist());
+			return l;
+		}
+		
+		boost::python::list getGroundSensorValues(void)
+		{
+			boost::python::list l;
+			l.append(groundSensor0.getValue());
+			l.append(groundSensor1.getValue());
+			return l;
+		}
+	};
+}
+
+#endif
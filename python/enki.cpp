@@ -38,12 +38,19 @@
 #include "../enki/Types.h"
 #include "../enki/Geometry.h"
 #include "../enki/PhysicalEngine.h"
-#include "../enki/robots/e-puck/EPuck.h"
-#include "../enki/robots/thymio2/Thymio2.h"
-#include "../viewer/Viewer.h"
-#include <QApplication>
-#include <QImage>
-#include <QGLWidget>
+#include "RobotWrappers.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#ifdef HAVE_NUMPY
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+#endif
+
+#if PY_MAJOR_VERSION >= 3
+#define PyInt_Check PyLong_Check
+#endif
 
 using namespace boost::python;
 using namespace Enki;
@@ -152,51 +159,172 @@ struct Vector_from_python
 	}
 };
 
+// NumPy arrays
+
+#ifdef HAVE_NUMPY
+
+//! Return a NumPy array of doubles of dimensions dims, viewing data without copying it, and keeping owner alive as long as the array exists
+static object makeArrayView(double* data, int nd, npy_intp* dims, object owner)
+{
+	PyObject* array(PyArray_SimpleNewFromData(nd, dims, NPY_DOUBLE, data));
+	if (!array)
+		throw_error_already_set();
+	Py_INCREF(owner.ptr());
+	if (PyArray_SetBaseObject((PyArrayObject*)array, owner.ptr()) < 0)
+	{
+		Py_DECREF(array);
+		throw_error_already_set();
+	}
+	return object(handle<>(array));
+}
+
+//! Return a new NumPy array of doubles of size rows x columns, owning its memory
+static object makeArray(npy_intp rows, npy_intp columns)
+{
+	npy_intp dims[2] = { rows, columns };
+	return object(handle<>(PyArray_SimpleNew(2, dims, NPY_DOUBLE)));
+}
+
+//! Return the data of a NumPy array created by makeArray()
+static double* arrayData(const object& array)
+{
+	return (double*)PyArray_DATA((PyArrayObject*)array.ptr());
+}
+
+//! Return the size of a NumPy array created by makeArray() along dimension d
+static size_t arraySize(const object& array, int d)
+{
+	return PyArray_DIM((PyArrayObject*)array.ptr(), d);
+}
+
+//! Append to sensors the proximity sensors of object in the order of their numbers, if it is a robot having some
+static void getProximitySensors(PhysicalObject* object, std::vector<const IRSensor*>& sensors)
+{
+	if (const EPuck* epuck = dynamic_cast<const EPuck*>(object))
+	{
+		const IRSensor* epuckSensors[] = { &epuck->infraredSensor0, &epuck->infraredSensor1, &epuck->infraredSensor2, &epuck->infraredSensor3, &epuck->infraredSensor4, &epuck->infraredSensor5, &epuck->infraredSensor6, &epuck->infraredSensor7 };
+		sensors.insert(sensors.end(), epuckSensors, epuckSensors + 8);
+	}
+	else if (const Thymio2* thymio2 = dynamic_cast<const Thymio2*>(object))
+	{
+		const IRSensor* thymio2Sensors[] = { &thymio2->infraredSensor0, &thymio2->infraredSensor1, &thymio2->infraredSensor2, &thymio2->infraredSensor3, &thymio2->infraredSensor4, &thymio2->infraredSensor5, &thymio2->infraredSensor6 };
+		sensors.insert(sensors.end(), thymio2Sensors, thymio2Sensors + 7);
+	}
+}
+
+#endif // HAVE_NUMPY
+
 // wrappers for world
 
-static World::GroundTexture loadTexture(const std::string& fileName)
+//! Read the next value of the header of a PPM file, skipping comments
+static unsigned readPPMHeaderValue(std::istream& is, const std::string& fileName)
 {
-	/*World::GroundTexture t;
-	
-	std::ifstream ifs(ppmFileName.c_str(), std::ifstream::in);
+	is >> std::ws;
+	while (is.peek() == '#')
+	{
+		is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		is >> std::ws;
+	}
+	unsigned value;
+	if (!(is >> value))
+		throw std::runtime_error("Invalid PPM header: " + fileName);
+	return value;
+}
+
+//! Read a plain (P3) or raw (P6) PPM file into texture, return false if the file is not a PPM file
+static bool loadPPMTexture(const std::string& fileName, World::GroundTexture& texture)
+{
+	std::ifstream ifs(fileName.c_str(), std::ifstream::in | std::ifstream::binary);
 	if (!ifs.good())
-		throw std::runtime_error("Cannot open file " + ppmFileName);
-	std::string magic;
-	ifs >> magic;
-	if (magic != "P3")
-		throw std::runtime_error("Not a PPM file: " + ppmFileName);
-	ifs >> t.width;
-	ifs >> t.height;
-	int valuesScale;
-	ifs >> valuesScale;
-	t.data.reserve(t.width*t.height);
-	for (int y = 0; y < t.height; ++y)
+		throw std::runtime_error("Cannot open file " + fileName);
+	char magic[2] = { 0, 0 };
+	ifs.read(magic, 2);
+	if (magic[0] != 'P' || (magic[1] != '3' && magic[1] != '6'))
+		return false;
+	const bool raw(magic[1] == '6');
+	texture.width = readPPMHeaderValue(ifs, fileName);
+	texture.height = readPPMHeaderValue(ifs, fileName);
+	const unsigned valuesScale(readPPMHeaderValue(ifs, fileName));
+	if (valuesScale == 0 || valuesScale > 255)
+		throw std::runtime_error("Unsupported PPM depth: " + fileName);
+	if (raw)
+		ifs.get();
+	
+	// same layout as textures converted by Qt for OpenGL: RGBA bytes, bottom scanline first
+	texture.data.resize(texture.width * texture.height);
+	for (unsigned y = 0; y < texture.height; ++y)
 	{
-		for (int x = 0; x < t.width; ++x)
+		uint32_t* scanline(&texture.data[(texture.height - 1 - y) * texture.width]);
+		for (unsigned x = 0; x < texture.width; ++x)
 		{
-			unsigned r, g, b;
-			ifs >> r >> g >> b;
-			if (ifs.eof())
-				throw std::runtime_error("Early end-of-file: " + ppmFileName);
-			r = (r * 255) / valuesScale;
-			g = (g * 255) / valuesScale;
-			b = (b * 255) / valuesScale;
-			t.data.push_back(r|(g<<8)|(b<<16));
+			unsigned rgb[3];
+			for (unsigned c = 0; c < 3; ++c)
+			{
+				if (raw)
+					rgb[c] = (unsigned char)ifs.get();
+				else
+					ifs >> rgb[c];
+				rgb[c] = (std::min(rgb[c], valuesScale) * 255) / valuesScale;
+			}
+			if (!ifs)
+				throw std::runtime_error("Early end-of-file: " + fileName);
+			scanline[x] = rgb[0] | (rgb[1] << 8) | (rgb[2] << 16) | (0xffu << 24);
 		}
 	}
+	return true;
+}
+
+//! Load a ground texture, PPM files are read directly while other formats need pyenkiviewer, which depends on Qt
+static World::GroundTexture loadTexture(const std::string& fileName)
+{
+	World::GroundTexture texture;
+	if (loadPPMTexture(fileName, texture))
+		return texture;
 	
-	return t;*/
-	QImage gt(QGLWidget::convertToGLFormat(QImage(fileName.c_str())));
-	
-	#if QT_VERSION >= QT_VERSION_CHECK(4,7,0)
-	return World::GroundTexture(gt.width(), gt.height(), (const uint32_t*)gt.constBits());
-	#else
-	return World::GroundTexture(gt.width(), gt.height(), (uint32_t*)gt.bits());
-	#endif
+	tuple image = extract<tuple>(import("pyenkiviewer").attr("loadTextureData")(fileName));
+	const unsigned width = extract<unsigned>(image[0]);
+	const unsigned height = extract<unsigned>(image[1]);
+	object data(image[2]);
+	const char* bytes(PyBytes_AsString(data.ptr()));
+	if (!bytes)
+		throw_error_already_set();
+	if (size_t(PyBytes_Size(data.ptr())) != size_t(width) * height * 4)
+		throw std::runtime_error("Invalid texture data for " + fileName);
+	return World::GroundTexture(width, height, (const uint32_t*)bytes);
 }
 
+//! Release the Python lock for the lifetime of this object
+struct PythonLockReleaser
+{
+	PyThreadState *pythonSavedState;
+	
+	PythonLockReleaser():
+		pythonSavedState(PyEval_SaveThread())
+	{}
+	
+	~PythonLockReleaser()
+	{
+		PyEval_RestoreThread(pythonSavedState);
+	}
+};
+
 struct WorldWithoutObjectsOwnership: public World
 {
+	#ifdef HAVE_NUMPY
+	//! Packed x, y and angle of all objects, in the order of objects, shared with Python
+	object posesArray;
+	//! Packed left and right speeds of all objects, NaN for objects that are not differential wheeled robots
+	object wheelSpeedsArray;
+	//! Packed values of the proximity sensors of all objects, NaN where an object has fewer sensors; read-only
+	object proximitySensorValuesArray;
+	//! Content of posesArray when last written from objects, to find the values changed from Python
+	std::vector<double> writtenPoses;
+	//! Content of wheelSpeedsArray when last written from objects, to find the values changed from Python
+	std::vector<double> writtenWheelSpeeds;
+	//! Temporary storage for the proximity sensors of an object
+	std::vector<const IRSensor*> proximitySensors;
+	#endif // HAVE_NUMPY
+	
 	WorldWithoutObjectsOwnership(double width, double height, const Color& wallsColor = Color::gray, const GroundTexture& groundTexture = GroundTexture()):
 		World(width, height, wallsColor, groundTexture)
 	{
@@ -213,6 +341,170 @@ struct WorldWithoutObjectsOwnership: public World
 	{
 		takeObjectOwnership = false;
 	}
+	
+	#ifdef HAVE_NUMPY
+	virtual void step(double dt, unsigned physicsOversampling = 1)
+	{
+		readArrays();
+		World::step(dt, physicsOversampling);
+		writeArrays();
+	}
+	
+	//! Apply to objects the values of arrays changed from Python since they were last written
+	void readArrays()
+	{
+		// values changed before objects were added or removed are lost
+		if (posesArray.is_none() || writtenPoses.size() != 3 * objects.size())
+			return;
+		const double* poses(arrayData(posesArray));
+		const double* wheelSpeeds(arrayData(wheelSpeedsArray));
+		size_t i(0);
+		for (ObjectsIterator it = objects.begin(); it != objects.end(); ++it, ++i)
+		{
+			PhysicalObject* o(*it);
+			if (poses[3*i] != writtenPoses[3*i])
+				o->pos.x = poses[3*i];
+			if (poses[3*i+1] != writtenPoses[3*i+1])
+				o->pos.y = poses[3*i+1];
+			if (poses[3*i+2] != writtenPoses[3*i+2])
+				o->angle = poses[3*i+2];
+			DifferentialWheeled* robot(dynamic_cast<DifferentialWheeled*>(o));
+			if (!robot)
+				continue;
+			if (wheelSpeeds[2*i] != writtenWheelSpeeds[2*i])
+				robot->leftSpeed = wheelSpeeds[2*i];
+			if (wheelSpeeds[2*i+1] != writtenWheelSpeeds[2*i+1])
+				robot->rightSpeed = wheelSpeeds[2*i+1];
+		}
+	}
+	
+	//! Write the state of objects into the arrays, if they exist, reallocating them if objects were added or removed
+	void writeArrays()
+	{
+		if (posesArray.is_none())
+			return;
+		
+		// a new set of objects needs new arrays, as the old ones might still be referenced from Python
+		size_t proximitySensorCount(0);
+		for (ObjectsIterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			proximitySensors.clear();
+			getProximitySensors(*it, proximitySensors);
+			proximitySensorCount = std::max(proximitySensorCount, proximitySensors.size());
+		}
+		const size_t objectCount(objects.size());
+		if (arraySize(posesArray, 0) != objectCount || arraySize(proximitySensorValuesArray, 1) != proximitySensorCount)
+			allocateArrays(proximitySensorCount);
+		
+		double* poses(arrayData(posesArray));
+		double* wheelSpeeds(arrayData(wheelSpeedsArray));
+		double* proximitySensorValues(arrayData(proximitySensorValuesArray));
+		const double nan(std::numeric_limits<double>::quiet_NaN());
+		size_t i(0);
+		for (ObjectsIterator it = objects.begin(); it != objects.end(); ++it, ++i)
+		{
+			PhysicalObject* o(*it);
+			poses[3*i] = o->pos.x;
+			poses[3*i+1] = o->pos.y;
+			poses[3*i+2] = o->angle;
+			DifferentialWheeled* robot(dynamic_cast<DifferentialWheeled*>(o));
+			wheelSpeeds[2*i] = robot ? robot->leftSpeed : nan;
+			wheelSpeeds[2*i+1] = robot ? robot->rightSpeed : nan;
+			proximitySensors.clear();
+			getProximitySensors(o, proximitySensors);
+			for (size_t j = 0; j < proximitySensorCount; ++j)
+				proximitySensorValues[proximitySensorCount*i+j] = j < proximitySensors.size() ? proximitySensors[j]->getValue() : nan;
+		}
+		writtenPoses.assign(poses, poses + 3*objectCount);
+		writtenWheelSpeeds.assign(wheelSpeeds, wheelSpeeds + 2*objectCount);
+	}
+	
+	//! Allocate the arrays for the current objects
+	void allocateArrays(size_t proximitySensorCount)
+	{
+		const size_t objectCount(objects.size());
+		posesArray = makeArray(objectCount, 3);
+		wheelSpeedsArray = makeArray(objectCount, 2);
+		proximitySensorValuesArray = makeArray(objectCount, proximitySensorCount);
+		PyArray_CLEARFLAGS((PyArrayObject*)proximitySensorValuesArray.ptr(), NPY_ARRAY_WRITEABLE);
+		writtenPoses.clear();
+		writtenWheelSpeeds.clear();
+	}
+	
+	//! Return an array after synchronizing the arrays with objects, allocating them on first use
+	object getArray(const object& array)
+	{
+		if (posesArray.is_none())
+			allocateArrays(0);
+		readArrays();
+		writeArrays();
+		return array;
+	}
+	
+	object getPoses() { return getArray(posesArray); }
+	object getWheelSpeeds() { return getArray(wheelSpeedsArray); }
+	object getProximitySensorValues() { return getArray(proximitySensorValuesArray); }
+	
+	//! Run steps steps, releasing the Python lock while stepping and calling controller(proximitySensorValues, poses) after every step
+	/*!
+		The Python overrides of controlStep() of robots are not called, as the controller replaces
+		them. If the controller returns an array of left and right speeds, it is applied to the
+		robots in the same way as a change of wheelSpeeds.
+	*/
+	void runWithController(unsigned steps, object controller, double dt = 1./30., unsigned physicsOversampling = 3)
+	{
+		getArray(posesArray);
+		setPythonControlStepsEnabled(false);
+		try
+		{
+			for (unsigned i = 0; i < steps; ++i)
+			{
+				readArrays();
+				{
+					PythonLockReleaser releaser;
+					World::step(dt, physicsOversampling);
+				}
+				writeArrays();
+				object speeds(controller(proximitySensorValuesArray, posesArray));
+				if (!speeds.is_none())
+					setWheelSpeeds(speeds);
+			}
+			readArrays();
+		}
+		catch (...)
+		{
+			setPythonControlStepsEnabled(true);
+			throw;
+		}
+		setPythonControlStepsEnabled(true);
+	}
+	
+	//! Enable or disable the Python overrides of controlStep() of all robots
+	void setPythonControlStepsEnabled(bool enabled)
+	{
+		for (ObjectsIterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			PythonControlled* robot(dynamic_cast<PythonControlled*>(*it));
+			if (robot)
+				robot->pythonControlStepEnabled = enabled;
+		}
+	}
+	
+	//! Copy into wheelSpeedsArray the speeds returned by a controller
+	void setWheelSpeeds(const object& speeds)
+	{
+		handle<> array(PyArray_FROMANY(speeds.ptr(), NPY_DOUBLE, 2, 2, NPY_ARRAY_IN_ARRAY));
+		PyArrayObject* arrayObject((PyArrayObject*)array.get());
+		const size_t rows(arraySize(wheelSpeedsArray, 0));
+		if (size_t(PyArray_DIM(arrayObject, 0)) != rows || PyArray_DIM(arrayObject, 1) != 2)
+		{
+			PyErr_SetString(PyExc_ValueError, "Wheel speeds returned by the controller must have one row of two values per object");
+			throw_error_already_set();
+		}
+		const double* data((const double*)PyArray_DATA(arrayObject));
+		std::copy(data, data + 2 * rows, arrayData(wheelSpeedsArray));
+	}
+	#endif // HAVE_NUMPY
 };
 
 struct WorldWithTexturedGround: public WorldWithoutObjectsOwnership
@@ -248,156 +540,28 @@ struct RectangularPhysicalObject: public PhysicalObject
 	}
 };
 
-// wrappers for robots
-
-struct EPuckWrap: EPuck, wrapper<EPuck>
+#ifdef HAVE_NUMPY
+//! Return a view of the image of the camera of the EPuck self, as rows of RGBA components, which is valid as long as self exists
+static object getCameraImageArray(object self)
 {
-	EPuckWrap():
-		EPuck(CAPABILITY_BASIC_SENSORS|CAPABILITY_CAMERA)
-	{}
-	
-	virtual void controlStep(double dt)
-	{
-		if (override controlStep = this->get_override("controlStep"))
-			controlStep(dt);
-		
-		EPuck::controlStep(dt);
-	}
-	
-	list getProxSensorValues(void)
-	{
-		list l;
-		l.append(infraredSensor0.getValue());
-		l.append(infraredSensor1.getValue());
-		l.append(infraredSensor2.getValue());
-		l.append(infraredSensor3.getValue());
-		l.append(infraredSensor4.getValue());
-		l.append(infraredSensor5.getValue());
-		l.append(infraredSensor6.getValue());
-		l.append(infraredSensor7.getValue());
-		return l;
-	}
-	
-	list getProxSensorDistances(void)
-	{
-		list l;
-		l.append(infraredSensor0.getDist());
-		l.append(infraredSensor1.getDist());
-		l.append(infraredSensor2.getDist());
-		l.append(infraredSensor3.getDist());
-		l.append(infraredSensor4.getDist());
-		l.append(infraredSensor5.getDist());
-		l.append(infraredSensor6.getDist());
-		l.append(infraredSensor7.getDist());
-		return l;
-	}
-	
-	Texture getCameraImage(void)
-	{
-		Texture texture;
-		texture.reserve(camera.image.size());
-		for (size_t i = 0; i < camera.image.size(); ++i)
-			texture.push_back(camera.image[i]);
-		return texture;
-	}
-};
-
-struct Thymio2Wrap: Thymio2, wrapper<Thymio2>
-{
-	virtual void controlStep(double dt)
-	{
-		if (override controlStep = this->get_override("controlStep"))
-			controlStep(dt);
-		
-		Thymio2::controlStep(dt);
-	}
-	
-	list getProxSensorValues(void)
-	{
-		list l;
-		l.append(infraredSensor0.getValue());
-		l.append(infraredSensor1.getValue());
-		l.append(infraredSensor2.getValue());
-		l.append(infraredSensor3.getValue());
-		l.append(infraredSensor4.getValue());
-		l.append(infraredSensor5.getValue());
-		l.append(infraredSensor6.getValue());
-		return l;
-	}
-	
-	list getProxSensorDistances(void)
-	{
-		list l;
-		l.append(infraredSensor0.getDist());
-		l.append(infraredSensor1.getDist());
-		l.append(infraredSensor2.getDist());
-		l.append(infraredSensor3.getDist());
-		l.append(infraredSensor4.getDist());
-		l.append(infraredSensor5.getDist());
-		l.append(infraredSensor6.getDist());
-		return l;
-	}
-	
-	list getGroundSensorValues(void)
-	{
-		list l;
-		l.append(groundSensor0.getValue());
-		l.append(groundSensor1.getValue());
-		return l;
-	}
-};
+	EPuckWrap& epuck = extract<EPuckWrap&>(self);
+	npy_intp dims[2] = { npy_intp(epuck.camera.image.size()), 4 };
+	return makeArrayView(epuck.camera.image[0].components, 2, dims, self);
+}
 
-struct PythonViewer: public ViewerWidget
+//! Return a view of the depth buffer of the camera of the EPuck self, which is valid as long as self exists
+static object getCameraDepthArray(object self)
 {
-	PyThreadState *pythonSavedState;
-	 
-	PythonViewer(World& world, Vector camPos, double camAltitude, double camYaw, double camPitch, double _wallsHeight):
-		ViewerWidget(&world),
-		pythonSavedState(0)
-	{
-		camera.pos.setX(camPos.x);
-		camera.pos.setY(camPos.y);
-		camera.altitude = camAltitude;
-		camera.yaw = camYaw;
-		camera.pitch = camPitch;
-		wallsHeight = _wallsHeight;
-		
-		managedObjectsAliases[&typeid(EPuckWrap)] = &typeid(EPuck);
-	}
-	
-	void sceneCompletedHook()
-	{
-		glColor3d(0,0,0);
-		renderText(10, height()-50, tr("rotate camera by moving mouse while pressing ctrl+left mouse button"));
-		renderText(10, height()-30, tr("move camera on x/y by moving mouse while pressing ctrl+shift+left mouse button"));
-		renderText(10, height()-10, tr("move camera on z by moving mouse while pressing ctrl+shift+right mouse button"));
-	}
-	
-	void timerEvent(QTimerEvent * event)
-	{
-		// get back Python lock
-		if (pythonSavedState)
-			PyEval_RestoreThread(pythonSavedState);
-		// touch Python objects while locked
-		ViewerWidget::timerEvent(event);
-		// release Python lock
-		if (pythonSavedState)
-			pythonSavedState = PyEval_SaveThread();
-	}
-};
+	EPuckWrap& epuck = extract<EPuckWrap&>(self);
+	npy_intp dims[1] = { npy_intp(epuck.camera.zbuffer.size()) };
+	return makeArrayView(&epuck.camera.zbuffer[0], 1, dims, self);
+}
+#endif // HAVE_NUMPY
 
-void runInViewer(World& world, Vector camPos = Vector(0,0), double camAltitude = 0, double camYaw = 0, double camPitch = 0, double wallsHeight = 10)
+//! Show world in a viewer; pyenkiviewer is only imported when needed, so that pyenki does not depend on Qt
+void runInViewer(object world, object camPos = make_tuple(0., 0.), double camAltitude = 0, double camYaw = 0, double camPitch = 0, double wallsHeight = 10)
 {
-	int argc(1);
-	char* argv[1] = {(char*)"dummy"}; // FIXME: recovery sys.argv
-	QApplication app(argc, argv);
-	PythonViewer viewer(world, camPos, camAltitude, camYaw, camPitch, wallsHeight);
-	viewer.setWindowTitle("PyEnki Viewer");
-	viewer.show();
-	viewer.pythonSavedState = PyEval_SaveThread();
-	app.exec();
-	if (viewer.pythonSavedState)
-		PyEval_RestoreThread(viewer.pythonSavedState);
+	import("pyenkiviewer").attr("runInViewer")(world, camPos, camAltitude, camYaw, camPitch, wallsHeight);
 }
 
 void run(World& world, unsigned steps)
@@ -407,10 +571,19 @@ void run(World& world, unsigned steps)
 }
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(step_overloads, step, 1, 2)
+#ifdef HAVE_NUMPY
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(runWithController_overloads, runWithController, 2, 4)
+#endif // HAVE_NUMPY
 BOOST_PYTHON_FUNCTION_OVERLOADS(runInViewer_overloads, runInViewer, 1, 6)
 
 BOOST_PYTHON_MODULE(pyenki)
 {
+	#ifdef HAVE_NUMPY
+	// initialise the NumPy C API
+	if (_import_array() < 0)
+		throw_error_already_set();
+	#endif // HAVE_NUMPY
+	
 	// setup converters
 	to_python_converter<Vector, Vector_to_python_tuple>();
 	Vector_from_python();
@@ -518,6 +691,12 @@ BOOST_PYTHON_MODULE(pyenki)
 		.def_readonly("proximitySensorValues", &EPuckWrap::getProxSensorValues)
 		.def_readonly("proximitySensorDistances", &EPuckWrap::getProxSensorDistances)
 		.def_readonly("cameraImage", &EPuckWrap::getCameraImage)
+		#ifdef HAVE_NUMPY
+		.add_property("cameraImageArray", getCameraImageArray,
+			"NumPy array of the RGBA components of the pixels of the camera, sharing the memory of the camera")
+		.add_property("cameraDepthArray", getCameraDepthArray,
+			"NumPy array of the distances seen by the pixels of the camera, sharing the memory of the camera")
+		#endif // HAVE_NUMPY
 	;
 	
 	class_<Thymio2Wrap, bases<DifferentialWheeled>, boost::noncopyable>("Thymio2")
@@ -546,9 +725,26 @@ BOOST_PYTHON_MODULE(pyenki)
 		.def("setRandomSeed", &World::setRandomSeed)
 		.def("run", run)
 		.def("runInViewer", runInViewer, runInViewer_overloads(args("self", "camPos", "camAltitude", "camYaw", "camPitch", "wallsHeight")))
+		#ifdef HAVE_NUMPY
+		.add_property("poses", &WorldWithoutObjectsOwnership::getPoses,
+			"NumPy array of the x, y and angle of all objects, in the order they were added.\n"
+			"It is updated after every step, and values changed in it are applied to objects before the next step.\n"
+			"A new array is created when objects are added or removed.")
+		.add_property("wheelSpeeds", &WorldWithoutObjectsOwnership::getWheelSpeeds,
+			"NumPy array of the left and right speeds of all objects, NaN for objects that are not differential wheeled robots.\n"
+			"It is synchronized with objects as poses.")
+		.add_property("proximitySensorValues", &WorldWithoutObjectsOwnership::getProximitySensorValues,
+			"Read-only NumPy array of the values of the proximity sensors of all objects, NaN for missing sensors.\n"
+			"It is updated after every step.")
+		.def("runWithController", &WorldWithoutObjectsOwnership::runWithController, runWithController_overloads(
+			"Run steps steps without holding the Python lock while stepping, and call controller(proximitySensorValues, poses) after every step.\n"
+			"The controlStep() methods of robots written in Python are not called.\n"
+			"If the controller returns an array of left and right wheel speeds, one row per object, it is applied to robots.",
+			args("steps", "controller", "dt", "physicsOversampling")))
+		#endif // HAVE_NUMPY
 	;
 	
-	class_<WorldWithTexturedGround, bases<World> >("WorldWithTexturedGround",
+	class_<WorldWithTexturedGround, bases<WorldWithoutObjectsOwnership> >("WorldWithTexturedGround",
 		init<double, double, const std::string&, optional<const Color&> >(args("width", "height", "ppmFileName", "wallsColor"))
 	)
 		.def(init<double, const std::string&, optional<const Color&> >(args("r", "ppmFileName", "wallsColor")))
@@ -21,4 +21,27 @@ w.addObject(e)
 
 for i in range(10):
 	w.step(0.05)
-	print ''
\ No newline at end of file
+	print ''
+
+# state as arrays, when pyenki is built with NumPy
+if hasattr(w, 'poses'):
+	poses = w.poses
+	speeds = w.wheelSpeeds
+	print 'poses: ', poses
+	print 'IR values: ', w.proximitySensorValues
+	speeds[:, 0] = 1.
+	speeds[:, 1] = -1.
+	w.step(0.05)
+	print 'poses after turning on the spot: ', poses
+	assert(e.leftSpeed == 1. and e.rightSpeed == -1.)
+	assert(poses[0, 0] == e.pos[0] and poses[0, 2] == e.angle)
+	image = e.cameraImageArray
+	assert(image.shape == (len(e.cameraImage), 4))
+	
+	# batch controller replacing the control steps of robots
+	def braitenberg(proximitySensorValues, poses):
+		speeds = w.wheelSpeeds.copy()
+		speeds[0] = [2. - proximitySensorValues[0, 0] / 1000., 2. - proximitySensorValues[0, 7] / 1000.]
+		return speeds
+	w.runWithController(10, braitenberg)
+	print 'poses after running with a batch controller: ', w.poses
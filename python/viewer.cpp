@@ -0,0 +1,129 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include <Python.h>
+#include <boost/python.hpp>
+#include "../enki/PhysicalEngine.h"
+#include "../viewer/Viewer.h"
+#include "RobotWrappers.h"
+#include <QApplication>
+#include <QImage>
+#include <QGLWidget>
+
+/*!	\file viewer.cpp
+	\brief Python bindings of the viewer, in a separate module so that pyenki does not depend on Qt and OpenGL
+*/
+
+using namespace boost::python;
+using namespace Enki;
+
+struct PythonViewer: public ViewerWidget
+{
+	PyThreadState *pythonSavedState;
+	 
+	PythonViewer(World& world, Vector camPos, double camAltitude, double camYaw, double camPitch, double _wallsHeight):
+		ViewerWidget(&world),
+		pythonSavedState(0)
+	{
+		camera.pos.setX(camPos.x);
+		camera.pos.setY(camPos.y);
+		camera.altitude = camAltitude;
+		camera.yaw = camYaw;
+		camera.pitch = camPitch;
+		wallsHeight = _wallsHeight;
+		
+		managedObjectsAliases[&typeid(EPuckWrap)] = &typeid(EPuck);
+		managedObjectsAliases[&typeid(Thymio2Wrap)] = &typeid(Thymio2);
+	}
+	
+	void sceneCompletedHook()
+	{
+		glColor3d(0,0,0);
+		renderText(10, height()-50, tr("rotate camera by moving mouse while pressing ctrl+left mouse button"));
+		renderText(10, height()-30, tr("move camera on x/y by moving mouse while pressing ctrl+shift+left mouse button"));
+		renderText(10, height()-10, tr("move camera on z by moving mouse while pressing ctrl+shift+right mouse button"));
+	}
+	
+	void timerEvent(QTimerEvent * event)
+	{
+		// get back Python lock
+		if (pythonSavedState)
+			PyEval_RestoreThread(pythonSavedState);
+		// touch Python objects while locked
+		ViewerWidget::timerEvent(event);
+		// release Python lock
+		if (pythonSavedState)
+			pythonSavedState = PyEval_SaveThread();
+	}
+};
+
+void runInViewer(World& world, Vector camPos = Vector(0,0), double camAltitude = 0, double camYaw = 0, double camPitch = 0, double wallsHeight = 10)
+{
+	int argc(1);
+	char* argv[1] = {(char*)"dummy"}; // FIXME: recovery sys.argv
+	QApplication app(argc, argv);
+	PythonViewer viewer(world, camPos, camAltitude, camYaw, camPitch, wallsHeight);
+	viewer.setWindowTitle("PyEnki Viewer");
+	viewer.show();
+	viewer.pythonSavedState = PyEval_SaveThread();
+	app.exec();
+	if (viewer.pythonSavedState)
+		PyEval_RestoreThread(viewer.pythonSavedState);
+}
+
+//! Load an image with Qt and return its width, its height and its pixels in the layout of World::GroundTexture
+tuple loadTextureData(const std::string& fileName)
+{
+	QImage gt(QGLWidget::convertToGLFormat(QImage(fileName.c_str())));
+	
+	#if QT_VERSION >= QT_VERSION_CHECK(4,7,0)
+	const char* bits((const char*)gt.constBits());
+	#else
+	const char* bits((const char*)gt.bits());
+	#endif
+	object data(handle<>(PyBytes_FromStringAndSize(bits, gt.width() * gt.height() * 4)));
+	return make_tuple(gt.width(), gt.height(), data);
+}
+
+BOOST_PYTHON_FUNCTION_OVERLOADS(runInViewer_overloads, runInViewer, 1, 6)
+
+BOOST_PYTHON_MODULE(pyenkiviewer)
+{
+	// worlds and vectors are converted by pyenki
+	import("pyenki");
+	
+	def("runInViewer", runInViewer, runInViewer_overloads(args("world", "camPos", "camAltitude", "camYaw", "camPitch", "wallsHeight")));
+	def("loadTextureData", loadTextureData, args("fileName"),
+		"Load an image and return its width, its height and its pixels as bytes in the layout of ground textures");
+}
@@ -0,0 +1,231 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "../enki/interactions/IRSensor.h"
+#include <iostream>
+#include <ctime>
+#include <algorithm>
+
+/*
+	Micro-benchmark of the geometry of IRSensor, comparing the current implementation,
+	which uses ray directions computed once per step, to the former one, which used
+	trigonometry for every ray and object.
+*/
+
+using namespace Enki;
+using namespace std;
+
+//! The former distance to a circle, with trigonometry for every ray
+void legacyCastRaysOnCircle(unsigned count, const double* rayAngles, const Vector& v1, double r2, double* dists)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		dists[i] = HUGE_VAL;
+		const double myAngle = rayAngles[i] - v1.angle();
+		const double sine = sin(myAngle);
+		const double distsc2 = v1.norm2() * (sine * sine);
+		if (distsc2 <= r2)
+			dists[i] = std::max(sqrt(v1.norm2()-distsc2) - sqrt(r2-distsc2), 0.);
+	}
+}
+
+//! The former distance to a polygon, with trigonometry for every ray and polygon
+double legacyDistanceToPolygon(double rayAngle, double range, const Point& absPos, const Polygone &p)
+{
+	Point absEnd = absPos + Vector(cos(rayAngle), sin(rayAngle)) * range;
+	Segment ray(absPos.x, absPos.y, absEnd.x, absEnd.y);
+	
+	const int n = p.size();
+	double tE = 0.0;
+	double tL = 1.0;
+	double t, N, D;
+	Vector dS(ray.b - ray.a);
+	
+	for (int i = 0; i < n; i++)
+	{
+		Vector e(p[i == n-1 ? 0: i + 1] - p[i]);
+		N = e.cross(ray.a - p[i]);
+		D = -e.cross(dS);
+		if (fabs(D) < 0.00000001)
+		{
+			if (N < 0)
+				return HUGE_VAL;
+			else
+				continue;
+		}
+		t = N / D;
+		if (D < 0)
+		{
+			if (t > tE)
+			{
+				tE = t;
+				if (tE > tL)
+					return HUGE_VAL;
+			}
+		}
+		else
+		{
+			if (t < tL)
+			{
+				tL = t;
+				if (tL < tE)
+					return HUGE_VAL;
+			}
+		}
+	}
+	return (dS * tE).norm();
+}
+
+//! The former distance to polygon for all rays, with the bounding circle test for every ray
+void legacyCastRaysOnPolygon(unsigned count, const double* rayAngles, double range, const Vector& v1, double r2, const Polygone& p, double* dists)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		dists[i] = HUGE_VAL;
+		const double myAngle = rayAngles[i] - v1.angle();
+		const double sine = sin(myAngle);
+		const double distsc2 = v1.norm2() * (sine * sine);
+		if (distsc2 < r2)
+			dists[i] = legacyDistanceToPolygon(rayAngles[i], range, Point(0, 0), p);
+	}
+}
+
+//! The current distance to polygon for all rays, with the bounding circle test for every ray
+void castRaysOnPolygon(unsigned count, const double* dirsX, const double* dirsY, double range, const Vector& v1, double r2, const Polygone& p, double* dists)
+{
+	bool hit(false);
+	for (size_t i = 0; i < count; i++)
+	{
+		const double cross = dirsX[i] * v1.y - dirsY[i] * v1.x;
+		hit = hit || (cross * cross < r2);
+	}
+	if (hit)
+		IRSensor::castRaysOnPolygon(count, dirsX, dirsY, range, Point(0, 0), p, dists);
+	else
+		std::fill(dists, dists + count, HUGE_VAL);
+}
+
+//! Return the time in ns per sensor and per object since start
+double elapsed(clock_t start, unsigned objectCount, unsigned repetitions)
+{
+	return (double(clock() - start) / CLOCKS_PER_SEC) * 1e9 / (double(objectCount) * repetitions);
+}
+
+//! Return the distance if finite, 0 otherwise, to compute a checksum
+double checksumValue(double dist)
+{
+	return dist == HUGE_VAL ? 0 : dist;
+}
+
+int main()
+{
+	const unsigned rayCount = 3;
+	const unsigned objectCount = 1000;
+	const unsigned repetitions = 2000;
+	const double range = 12;
+	
+	// rays of a sensor at the origin, like the ones of IRSensor
+	double rayAngles[rayCount], dirsX[rayCount], dirsY[rayCount];
+	for (unsigned i = 0; i < rayCount; ++i)
+	{
+		rayAngles[i] = 0.3 + (-15. + i * 15.) * M_PI / 180.;
+		dirsX[i] = cos(rayAngles[i]);
+		dirsY[i] = sin(rayAngles[i]);
+	}
+	
+	// objects around the sensor
+	FastRandom random;
+	random.setSeed(1);
+	std::vector<Vector> centers(objectCount);
+	std::vector<double> radii2(objectCount);
+	std::vector<Polygone> polygons(objectCount);
+	for (unsigned i = 0; i < objectCount; ++i)
+	{
+		centers[i] = Vector(random.getRange(24) - 12, random.getRange(24) - 12);
+		const double size(1 + random.getRange(3));
+		radii2[i] = 2 * size * size;
+		polygons[i].push_back(centers[i] + Vector(-size, -size));
+		polygons[i].push_back(centers[i] + Vector(size, -size));
+		polygons[i].push_back(centers[i] + Vector(size, size));
+		polygons[i].push_back(centers[i] + Vector(-size, size));
+	}
+	
+	double dists[rayCount];
+	double sum(0);
+	clock_t start;
+	
+	start = clock();
+	for (unsigned r = 0; r < repetitions; ++r)
+		for (unsigned o = 0; o < objectCount; ++o)
+		{
+			legacyCastRaysOnCircle(rayCount, rayAngles, centers[o], radii2[o], dists);
+			sum += checksumValue(dists[1]);
+		}
+	const double legacyCirclesTime(elapsed(start, objectCount, repetitions));
+	
+	start = clock();
+	for (unsigned r = 0; r < repetitions; ++r)
+		for (unsigned o = 0; o < objectCount; ++o)
+		{
+			IRSensor::castRaysOnCircle(rayCount, dirsX, dirsY, centers[o], radii2[o], dists);
+			sum += checksumValue(dists[1]);
+		}
+	const double circlesTime(elapsed(start, objectCount, repetitions));
+	
+	start = clock();
+	for (unsigned r = 0; r < repetitions; ++r)
+		for (unsigned o = 0; o < objectCount; ++o)
+		{
+			legacyCastRaysOnPolygon(rayCount, rayAngles, range, centers[o], radii2[o], polygons[o], dists);
+			sum += checksumValue(dists[1]);
+		}
+	const double legacyPolygonsTime(elapsed(start, objectCount, repetitions));
+	
+	start = clock();
+	for (unsigned r = 0; r < repetitions; ++r)
+		for (unsigned o = 0; o < objectCount; ++o)
+		{
+			castRaysOnPolygon(rayCount, dirsX, dirsY, range, centers[o], radii2[o], polygons[o], dists);
+			sum += checksumValue(dists[1]);
+		}
+	const double polygonsTime(elapsed(start, objectCount, repetitions));
+	
+	cout << "time per sensor and object, in ns" << endl;
+	cout << "circles:  former " << legacyCirclesTime << ", current " << circlesTime << ", speedup " << legacyCirclesTime / circlesTime << endl;
+	cout << "polygons: former " << legacyPolygonsTime << ", current " << polygonsTime << ", speedup " << legacyPolygonsTime / polygonsTime << endl;
+	// print the checksum so that computations are not optimised away
+	cerr << "checksum " << sum << endl;
+	
+	return 0;
+}
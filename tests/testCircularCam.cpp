@@ -0,0 +1,260 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "../enki/PhysicalEngine.h"
+#include "../enki/interactions/CircularCam.h"
+#include <iostream>
+#include <cstdlib>
+#include <limits>
+
+using namespace Enki;
+using namespace std;
+
+#define CHECK(cond, msg) \
+	if (!(cond)) { \
+		cerr << msg << endl; \
+		exit(1); \
+	}
+
+//! A robot carrying a single camera at its center
+struct CameraRobot : public Robot
+{
+	CircularCam camera;
+	
+	CameraRobot(double halfFieldOfView, unsigned pixelCount) :
+		camera(this, Vector(0, 0), 0, 0, halfFieldOfView, pixelCount)
+	{
+		addLocalInteraction(&camera);
+		setCylindric(1, 1, 1);
+	}
+};
+
+//! A robot carrying an omnidirectional camera and two cameras covering the same field of view, as OmniCam used to be made of
+struct OmniCamRobot : public Robot
+{
+	OmniCam omniCam;
+	CircularCam cam0;
+	CircularCam cam1;
+	
+	OmniCamRobot(unsigned halfPixelCount) :
+		omniCam(this, 0, halfPixelCount),
+		cam0(this, Vector(0, 0), 0, -M_PI/2, M_PI/2, halfPixelCount),
+		cam1(this, Vector(0, 0), 0, M_PI/2, M_PI/2, halfPixelCount)
+	{
+		addLocalInteraction(&omniCam);
+		addLocalInteraction(&cam0);
+		addLocalInteraction(&cam1);
+		setCylindric(1, 1, 1);
+	}
+};
+
+//! Depth test going through the virtual pixel operation path
+struct CustomDepthTest : public PixelOperationFunctor
+{
+	virtual void operator()(double &zBuffer2, Color &pixelBuffer, const double &objectDist2, const Color &objectColor)
+	{
+		if (objectDist2 < zBuffer2)
+		{
+			zBuffer2 = objectDist2;
+			pixelBuffer = objectColor;
+		}
+	}
+};
+
+//! Return the square of the distance from origin along dir to segment p0-p1, or infinity if they do not intersect
+double rayDist2ToSegment(const Point& origin, const Vector& dir, const Point& p0, const Point& p1)
+{
+	const Vector v0(p0 - origin);
+	const Vector v10(p1 - p0);
+	const double denominator(dir.cross(v10));
+	if (denominator == 0)
+		return numeric_limits<double>::max();
+	const double lambda(-dir.cross(v0) / denominator);
+	if (lambda < 0 || lambda > 1)
+		return numeric_limits<double>::max();
+	const Vector p(v0 + v10 * lambda);
+	if (p * dir < 0)
+		return numeric_limits<double>::max();
+	return p.norm2();
+}
+
+//! Return the square of the distance to the closest polygonal object or wall, cast by brute force along every pixel
+void castPixels(const World& world, const vector<PhysicalObject*>& objects, CircularCam& camera, vector<double>& dist2)
+{
+	const size_t pixelCount(camera.zbuffer.size());
+	const double dAngle(2 * camera.halfFieldOfView / (pixelCount - 1));
+	const Point origin(camera.getAbsolutePosition());
+	dist2.assign(pixelCount, numeric_limits<double>::max());
+	Polygone walls;
+	walls.push_back(Point(0, 0));
+	walls.push_back(Point(world.w, 0));
+	walls.push_back(Point(world.w, world.h));
+	walls.push_back(Point(0, world.h));
+	for (size_t i = 0; i < pixelCount; ++i)
+	{
+		const double angle(camera.getAbsoluteOrientation() - camera.halfFieldOfView + i * dAngle);
+		const Vector dir(cos(angle), sin(angle));
+		for (size_t j = 0; j < walls.size(); ++j)
+			dist2[i] = min(dist2[i], rayDist2ToSegment(origin, dir, walls[j], walls[(j+1) % walls.size()]));
+		for (size_t k = 0; k < objects.size(); ++k)
+		{
+			const Polygone& shape(objects[k]->getHull()[0].getTransformedShape());
+			for (size_t j = 0; j < shape.size(); ++j)
+				dist2[i] = min(dist2[i], rayDist2ToSegment(origin, dir, shape[j], shape[(j+1) % shape.size()]));
+		}
+	}
+}
+
+void testRasterisation(double halfFieldOfView, unsigned pixelCount)
+{
+	FastRandom random;
+	random.setSeed(2);
+	CustomDepthTest customDepthTest;
+	
+	for (unsigned test = 0; test < 100; ++test)
+	{
+		World world(100, 100);
+		world.takeObjectOwnership = false;
+		CameraRobot robot(halfFieldOfView, pixelCount);
+		robot.pos = Point(30 + random.getRange(40), 30 + random.getRange(40));
+		robot.angle = random.getRange(2*M_PI);
+		world.addObject(&robot);
+		
+		// textured boxes and plain cylinders around the robot
+		PhysicalObject boxObjects[8];
+		vector<PhysicalObject*> boxes;
+		for (unsigned i = 0; i < 8; ++i)
+		{
+			Polygone shape;
+			shape.push_back(Point(-2, -2));
+			shape.push_back(Point(2, -2));
+			shape.push_back(Point(2, 2));
+			shape.push_back(Point(-2, 2));
+			Textures textures(4);
+			for (size_t j = 0; j < textures.size(); ++j)
+				for (unsigned k = 0; k < 1 + random.get() % 5; ++k)
+					textures[j].push_back(Color(random.getRange(1), random.getRange(1), random.getRange(1)));
+			PhysicalObject::Hull hull(PhysicalObject::Part(shape, 5, textures));
+			PhysicalObject& box(boxObjects[i]);
+			box.setCustomHull(hull, -1);
+			box.pos = Point(5 + random.getRange(90), 5 + random.getRange(90));
+			box.angle = random.getRange(2*M_PI);
+			if ((box.pos - robot.pos).norm() > 5)
+			{
+				boxes.push_back(&box);
+				world.addObject(&box);
+			}
+		}
+		
+		// without cylinders, the zbuffer must match brute-force ray casting
+		world.step(0.01);
+		vector<double> dist2;
+		castPixels(world, boxes, robot.camera, dist2);
+		for (size_t i = 0; i < pixelCount; ++i)
+			CHECK(fabs(robot.camera.zbuffer[i] - dist2[i]) <= 1e-9 * dist2[i], "pixel " << i << " at distance² " << robot.camera.zbuffer[i] << " instead of " << dist2[i]);
+		
+		PhysicalObject cylinders[8];
+		for (unsigned i = 0; i < 8; ++i)
+		{
+			cylinders[i].setCylindric(1 + random.getRange(2), 5, -1);
+			cylinders[i].setColor(Color(random.getRange(1), random.getRange(1), random.getRange(1)));
+			cylinders[i].pos = Point(5 + random.getRange(90), 5 + random.getRange(90));
+			world.addObject(&cylinders[i]);
+		}
+		
+		// the inlined depth test and a custom pixel operation must give the same result
+		world.step(0.01);
+		const valarray<double> zbuffer(robot.camera.zbuffer);
+		const valarray<Color> image(robot.camera.image);
+		robot.camera.pixelOperation = &customDepthTest;
+		world.step(0.01);
+		for (size_t i = 0; i < pixelCount; ++i)
+		{
+			CHECK(robot.camera.zbuffer[i] == zbuffer[i], "custom pixel operation gives distance² " << robot.camera.zbuffer[i] << " instead of " << zbuffer[i] << " at pixel " << i);
+			CHECK(robot.camera.image[i] == image[i], "custom pixel operation gives color " << robot.camera.image[i] << " instead of " << image[i] << " at pixel " << i);
+		}
+	}
+}
+
+void testOmniCam(unsigned halfPixelCount)
+{
+	FastRandom random;
+	random.setSeed(3);
+	
+	for (unsigned test = 0; test < 100; ++test)
+	{
+		World world(100, 100);
+		world.takeObjectOwnership = false;
+		OmniCamRobot robot(halfPixelCount);
+		robot.pos = Point(30 + random.getRange(40), 30 + random.getRange(40));
+		robot.angle = random.getRange(2*M_PI);
+		world.addObject(&robot);
+		
+		PhysicalObject objects[16];
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			PhysicalObject& object(objects[i]);
+			if (i % 2)
+				object.setRectangular(1 + random.getRange(6), 1 + random.getRange(6), 5, -1);
+			else
+				object.setCylindric(1 + random.getRange(2), 5, -1);
+			object.setColor(Color(random.getRange(1), random.getRange(1), random.getRange(1)));
+			object.pos = Point(5 + random.getRange(90), 5 + random.getRange(90));
+			object.angle = random.getRange(2*M_PI);
+			if ((object.pos - robot.pos).norm() > 6)
+				world.addObject(&object);
+		}
+		
+		// the omnidirectional camera must see what the two stitched cameras see
+		world.step(0.01);
+		for (size_t i = 0; i < 2 * halfPixelCount; ++i)
+		{
+			const CircularCam& cam(i < halfPixelCount ? robot.cam0 : robot.cam1);
+			const size_t j(i % halfPixelCount);
+			CHECK(fabs(robot.omniCam.zbuffer[i] - cam.zbuffer[j]) <= 1e-9 * cam.zbuffer[j], "omnidirectional pixel " << i << " at distance² " << robot.omniCam.zbuffer[i] << " instead of " << cam.zbuffer[j]);
+			CHECK(robot.omniCam.image[i] == cam.image[j], "omnidirectional pixel " << i << " of color " << robot.omniCam.image[i] << " instead of " << cam.image[j]);
+		}
+	}
+}
+
+int main()
+{
+	testRasterisation(M_PI/6, 60);
+	testRasterisation(M_PI/2, 64);
+	testRasterisation(M_PI/2, 2);
+	testOmniCam(32);
+	testOmniCam(90);
+	
+	return 0;
+}
@@ -0,0 +1,205 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "../enki/PhysicalEngine.h"
+#include <iostream>
+#include <cstdlib>
+
+using namespace Enki;
+using namespace std;
+
+#define CHECK(cond, msg) \
+	if (!(cond)) { \
+		cerr << msg << endl; \
+		exit(1); \
+	}
+
+//! Return the intensity at p filtered by point sampling the ground, as GroundSensor used to do
+double sampleGround(const World& world, const Point& p, double spatialSd)
+{
+	double kernel[GroundMap::kernelSize];
+	GroundMap::getKernel(spatialSd, kernel);
+	const int halfSize(GroundMap::kernelSize / 2);
+	double v(0);
+	for (int i = 0; i < GroundMap::kernelSize; ++i)
+		for (int j = 0; j < GroundMap::kernelSize; ++j)
+			v += kernel[i] * kernel[j] * world.getGroundColor(p + Vector(i - halfSize, j - halfSize) * GroundMap::kernelStep).toGray();
+	return v;
+}
+
+//! Return a texture of random texels if sharp is true, or of a smooth gradient of color otherwise
+vector<uint32_t> makeTexture(unsigned width, unsigned height, bool sharp, FastRandom& random)
+{
+	vector<uint32_t> texture(width * height);
+	for (unsigned y = 0; y < height; ++y)
+	{
+		for (unsigned x = 0; x < width; ++x)
+		{
+			if (sharp)
+				texture[y * width + x] = 0xff000000 | (random.get() & 0xffffff);
+			else
+			{
+				const double v(0.5 + 0.25 * sin(x * 0.05) + 0.25 * cos(y * 0.03));
+				texture[y * width + x] = Color::toARGB(Color(v, 1 - v, v * v));
+			}
+		}
+	}
+	return texture;
+}
+
+void testTexelCenters(World& world, unsigned width, unsigned height, const Point& origin, const Vector& size)
+{
+	const double spatialSds[] = { 0.2, 0.4, 1 };
+	for (size_t k = 0; k < 3; ++k)
+	{
+		const GroundMap* groundMap(world.getGroundMap(spatialSds[k]));
+		CHECK(groundMap == world.getGroundMap(spatialSds[k]), "ground map built twice for the same standard deviation");
+		for (unsigned y = 0; y < height; y += 7)
+		{
+			for (unsigned x = 0; x < width; x += 7)
+			{
+				const Point p(origin.x + (x + 0.5) * size.x / width, origin.y + (y + 0.5) * size.y / height);
+				const double expected(sampleGround(world, p, spatialSds[k]));
+				const double value(groundMap->getIntensity(p));
+				CHECK(fabs(value - expected) < 1e-6, "ground intensity at texel center " << p.x << ", " << p.y << " is " << value << " instead of " << expected);
+			}
+		}
+	}
+}
+
+void testSharpTextures()
+{
+	FastRandom random;
+	random.setSeed(4);
+	
+	// square and circular worlds, with texel sizes not aligned with the kernel
+	const unsigned width(333), height(217);
+	const vector<uint32_t> texture(makeTexture(width, height, true, random));
+	World squareWorld(100, 70, Color::gray, World::GroundTexture(width, height, &texture[0]));
+	testTexelCenters(squareWorld, width, height, Point(0, 0), Vector(100, 70));
+	World circularWorld(50, Color::gray, World::GroundTexture(width, height, &texture[0]));
+	testTexelCenters(circularWorld, width, height, Point(-50, -50), Vector(100, 100));
+}
+
+void testSmoothTexture()
+{
+	FastRandom random;
+	random.setSeed(5);
+	
+	// between texel centers, the reading is within 0.5 % of point sampling on a smooth texture
+	const unsigned width(400), height(300);
+	const vector<uint32_t> texture(makeTexture(width, height, false, random));
+	World world(100, 100, Color::gray, World::GroundTexture(width, height, &texture[0]));
+	const GroundMap* groundMap(world.getGroundMap(0.4));
+	for (unsigned i = 0; i < 10000; ++i)
+	{
+		const Point p(2 + random.getRange(96), 2 + random.getRange(96));
+		const double expected(sampleGround(world, p, 0.4));
+		const double value(groundMap->getIntensity(p));
+		CHECK(fabs(value - expected) < 0.005, "ground intensity at " << p.x << ", " << p.y << " is " << value << " instead of " << expected);
+	}
+	
+	// far outside the texture, the intensity is the one of the world color
+	CHECK(groundMap->getIntensity(Point(-10, 50)) == Color::gray.toGray(), "ground intensity outside the texture is " << groundMap->getIntensity(Point(-10, 50)));
+	CHECK(groundMap->getIntensity(Point(50, 110)) == Color::gray.toGray(), "ground intensity outside the texture is " << groundMap->getIntensity(Point(50, 110)));
+}
+
+void testEdges()
+{
+	FastRandom random;
+	random.setSeed(6);
+	
+	// across a black and white edge, away from corners, the reading is within the largest weight of the kernel along one axis of point sampling,
+	// twice this for a diagonal edge; the world is black, so the right border of the texture is an edge as well
+	const unsigned textureSizes[] = { 1000, 333, 100, 37 };
+	const double spatialSds[] = { 0.2, 0.4, 1 };
+	for (unsigned edge = 0; edge < 3; ++edge)
+	{
+		for (size_t t = 0; t < 4; ++t)
+		{
+			const unsigned size(textureSizes[t]);
+			vector<uint32_t> texture(size * size);
+			for (unsigned y = 0; y < size; ++y)
+			{
+				for (unsigned x = 0; x < size; ++x)
+				{
+					const bool white(edge == 0 ? 2 * x >= size : (edge == 1 ? 2 * y >= size : x + y >= size));
+					texture[y * size + x] = Color::toARGB(white ? Color::white : Color::black);
+				}
+			}
+			World world(100, 100, Color::black, World::GroundTexture(size, size, &texture[0]));
+			for (size_t k = 0; k < 3; ++k)
+			{
+				double kernel[GroundMap::kernelSize];
+				GroundMap::getKernel(spatialSds[k], kernel);
+				const double bound((edge == 2 ? 2 : 1) * kernel[GroundMap::kernelSize / 2] + 1e-6);
+				const GroundMap* groundMap(world.getGroundMap(spatialSds[k]));
+				for (unsigned i = 0; i < 3000; ++i)
+				{
+					const double along(5 + random.getRange(90));
+					const double across(random.getRange(4) - 2);
+					Point p;
+					if (i % 4 == 0)
+						p = edge == 1 ? Point(along, 100 + across) : Point(100 + across, along);
+					else if (edge == 0)
+						p = Point(50 + across, along);
+					else if (edge == 1)
+						p = Point(along, 50 + across);
+					else
+						p = Point(along + across, 100 - along + random.getRange(4) - 2);
+					const double expected(sampleGround(world, p, spatialSds[k]));
+					const double value(groundMap->getIntensity(p));
+					CHECK(fabs(value - expected) <= bound, "ground intensity across edge " << edge << " at " << p.x << ", " << p.y << " with " << size << " texels and standard deviation " << spatialSds[k] << " is " << value << " instead of " << expected);
+				}
+			}
+		}
+	}
+}
+
+void testUniformGround()
+{
+	World world(100, 100, Color::red);
+	const GroundMap* groundMap(world.getGroundMap(0.4));
+	CHECK(groundMap->getIntensity(Point(50, 50)) == Color::red.toGray(), "uniform ground intensity is " << groundMap->getIntensity(Point(50, 50)));
+}
+
+int main()
+{
+	testSharpTextures();
+	testSmoothTexture();
+	testEdges();
+	testUniformGround();
+	
+	return 0;
+}
@@ -0,0 +1,146 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "../enki/interactions/IRSensor.h"
+#include "../enki/robots/e-puck/EPuck.h"
+#include <iostream>
+#include <cstdlib>
+
+using namespace Enki;
+using namespace std;
+
+#define CHECK(cond, msg) \
+	if (!(cond)) { \
+		cerr << msg << endl; \
+		exit(1); \
+	}
+
+//! Return the distance along a ray of angle rayAngle from the origin to a circle, as computed with trigonometry by former versions of IRSensor
+double trigonometricDistanceToCircle(double rayAngle, const Vector& v, double r2)
+{
+	const double sine = sin(rayAngle - v.angle());
+	const double distsc2 = v.norm2() * (sine * sine);
+	if (distsc2 > r2)
+		return HUGE_VAL;
+	return std::max(sqrt(v.norm2()-distsc2) - sqrt(r2-distsc2), 0.);
+}
+
+//! Return a convex polygon with vertices in counterclockwise order
+Polygone randomPolygon(FastRandom& random)
+{
+	const Point center(random.getRange(20) - 10, random.getRange(20) - 10);
+	const unsigned count(3 + random.get() % 6);
+	const double phase(random.getRange(2*M_PI));
+	Polygone p;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		const double angle(phase + (2*M_PI*i) / count);
+		const double radius(1 + random.getRange(5));
+		p.push_back(center + Vector(cos(angle), sin(angle)) * radius);
+	}
+	return p;
+}
+
+void testRayCasting()
+{
+	FastRandom random;
+	random.setSeed(1);
+	const unsigned maxCount = 7;
+	double dirsX[maxCount], dirsY[maxCount], angles[maxCount];
+	double scalarDists[maxCount], vectorisedDists[maxCount];
+	
+	for (unsigned test = 0; test < 10000; ++test)
+	{
+		const unsigned count(1 + random.get() % maxCount);
+		for (unsigned i = 0; i < count; ++i)
+		{
+			angles[i] = random.getRange(2*M_PI) - M_PI;
+			dirsX[i] = cos(angles[i]);
+			dirsY[i] = sin(angles[i]);
+		}
+		
+		// circles
+		const Vector v(random.getRange(20) - 10, random.getRange(20) - 10);
+		const double r2(random.getRange(25));
+		IRSensor::castRaysOnCircle(count, dirsX, dirsY, v, r2, scalarDists, false);
+		IRSensor::castRaysOnCircle(count, dirsX, dirsY, v, r2, vectorisedDists, true);
+		for (unsigned i = 0; i < count; ++i)
+		{
+			CHECK(scalarDists[i] == vectorisedDists[i], "vectorised ray casting on circle gives " << vectorisedDists[i] << " instead of " << scalarDists[i]);
+			// directions do not give exactly the same results as angles near tangents
+			const double trigonometricDist(trigonometricDistanceToCircle(angles[i], v, r2));
+			if (scalarDists[i] != HUGE_VAL && trigonometricDist != HUGE_VAL)
+				CHECK(fabs(scalarDists[i] - trigonometricDist) < 1e-6, "ray casting on circle gives " << scalarDists[i] << " instead of " << trigonometricDist);
+		}
+		
+		// polygons
+		const Polygone p(randomPolygon(random));
+		const double length(1 + random.getRange(20));
+		IRSensor::castRaysOnPolygon(count, dirsX, dirsY, length, Point(0, 0), p, scalarDists, false);
+		IRSensor::castRaysOnPolygon(count, dirsX, dirsY, length, Point(0, 0), p, vectorisedDists, true);
+		for (unsigned i = 0; i < count; ++i)
+			CHECK(scalarDists[i] == vectorisedDists[i], "vectorised ray casting on polygon gives " << vectorisedDists[i] << " instead of " << scalarDists[i]);
+	}
+}
+
+void testCircularWalls()
+{
+	World world(20);
+	world.takeObjectOwnership = false;
+	EPuck epuck;
+	epuck.pos = Point(15, 0);
+	world.addObject(&epuck);
+	
+	// facing the wall, the central ray of the front sensor sees it at the remaining distance
+	epuck.angle = 0;
+	world.step(0.01);
+	const double dist(epuck.infraredSensor0.getRayDist(1));
+	const Point sensorPos(epuck.infraredSensor0.getAbsolutePosition());
+	const Vector rayDir(cos(epuck.infraredSensor0.getAbsoluteOrientation()), sin(epuck.infraredSensor0.getAbsoluteOrientation()));
+	CHECK(fabs((sensorPos + rayDir * dist).norm() - 20) < 1e-9, "circular wall seen at distance " << dist << " which is not on the wall");
+	
+	// facing the center, walls are out of range
+	epuck.angle = M_PI;
+	world.step(0.01);
+	for (unsigned i = 0; i < epuck.infraredSensor0.getRayCount(); ++i)
+		CHECK(epuck.infraredSensor0.getRayDist(i) == epuck.infraredSensor0.getRange(), "circular wall seen at distance " << epuck.infraredSensor0.getRayDist(i) << " while facing the center");
+}
+
+int main()
+{
+	testRayCasting();
+	testCircularWalls();
+	
+	return 0;
+}
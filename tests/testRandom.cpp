@@ -0,0 +1,135 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "../enki/PhysicalEngine.h"
+#include <iostream>
+#include <cstdlib>
+
+using namespace Enki;
+using namespace std;
+
+#define CHECK(cond, msg) \
+	if (!(cond)) { \
+		cerr << msg << endl; \
+		exit(1); \
+	}
+
+void testStreams()
+{
+	// a stream only depends on its key and on the index of the value
+	RandomStream a(RandomStream::combine(1, 2));
+	RandomStream b(1, 2);
+	uint64_t values[16];
+	for (unsigned i = 0; i < 16; ++i)
+	{
+		values[i] = a.get();
+		CHECK(values[i] == b.get(), "streams of the same key differ at value " << i);
+	}
+	b.seek(7);
+	CHECK(b.get() == values[7], "seeking a stream does not give the same value");
+	
+	// streams of different keys differ
+	RandomStream c(1, 3);
+	unsigned sameCount(0);
+	for (unsigned i = 0; i < 16; ++i)
+		sameCount += (c.get() == values[i]);
+	CHECK(sameCount == 0, "streams of different keys give the same values");
+}
+
+void testDistributions()
+{
+	const unsigned count(100000);
+	RandomStream stream(42);
+	
+	// uniform
+	double sum(0), sum2(0);
+	for (unsigned i = 0; i < count; ++i)
+	{
+		const double v(stream.uniform());
+		CHECK(v >= 0 && v < 1, "uniform number " << v << " out of [0;1[");
+		sum += v;
+		sum2 += v * v;
+	}
+	const double uniformMean(sum / count);
+	const double uniformVar(sum2 / count - uniformMean * uniformMean);
+	CHECK(fabs(uniformMean - 0.5) < 0.01 && fabs(uniformVar - 1./12.) < 0.01, "uniform numbers of mean " << uniformMean << " and variance " << uniformVar);
+	
+	// gaussian
+	sum = sum2 = 0;
+	for (unsigned i = 0; i < count; ++i)
+	{
+		const double v(stream.gaussian(2, 3));
+		sum += v;
+		sum2 += v * v;
+	}
+	const double gaussianMean(sum / count);
+	const double gaussianVar(sum2 / count - gaussianMean * gaussianMean);
+	CHECK(fabs(gaussianMean - 2) < 0.05 && fabs(gaussianVar - 9) < 0.2, "gaussian numbers of mean " << gaussianMean << " and variance " << gaussianVar);
+}
+
+void testObjectStreams()
+{
+	// streams depend on the seed, the object, the step and the stream identifier, not on the world
+	World worlds[2];
+	PhysicalObject objects[2][2];
+	uint64_t values[2][2][2];
+	for (unsigned w = 0; w < 2; ++w)
+	{
+		worlds[w].takeObjectOwnership = false;
+		worlds[w].setRandomSeed(5);
+		worlds[w].addObject(&objects[w][0]);
+		worlds[w].addObject(&objects[w][1]);
+		worlds[w].step(0.1);
+		for (unsigned o = 0; o < 2; ++o)
+			for (unsigned s = 0; s < 2; ++s)
+				values[w][o][s] = objects[w][o].getRandomStream(s).get();
+	}
+	CHECK(values[0][0][0] == values[1][0][0] && values[0][1][1] == values[1][1][1], "identical worlds give different random streams");
+	CHECK(values[0][0][0] != values[0][1][0] && values[0][0][0] != values[0][0][1], "different objects or streams give the same random numbers");
+	
+	worlds[0].step(0.1);
+	CHECK(objects[0][0].getRandomStream(0).get() != values[0][0][0], "different steps give the same random numbers");
+	worlds[1].setRandomSeed(6);
+	worlds[1].step(0.1);
+	CHECK(objects[0][0].getRandomStream(0).get() != objects[1][0].getRandomStream(0).get(), "different seeds give the same random numbers");
+}
+
+int main()
+{
+	testStreams();
+	testDistributions();
+	testObjectStreams();
+	
+	return 0;
+}
@@ -0,0 +1,138 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "../enki/ResponseTable.h"
+#include "../enki/robots/e-puck/EPuck.h"
+#include "../enki/robots/marxbot/Marxbot.h"
+#include <iostream>
+#include <cstdlib>
+
+using namespace Enki;
+using namespace std;
+
+#define CHECK(cond, msg) \
+	if (!(cond)) { \
+		cerr << msg << endl; \
+		exit(1); \
+	}
+
+double affine(double x)
+{
+	return 3 * x - 2;
+}
+
+double sine(double x)
+{
+	return sin(x);
+}
+
+void testInterpolation()
+{
+	// affine functions are interpolated exactly, values are clamped outside the interval
+	const ResponseTable<2> table(affine, -1, 3);
+	for (double x = -1; x <= 3; x += 0.125)
+		CHECK(fabs(table(x) - affine(x)) < 1e-12, "table gives " << table(x) << " instead of " << affine(x) << " at " << x);
+	CHECK(table(-10) == affine(-1), "table gives " << table(-10) << " below its interval");
+	CHECK(table(10) == affine(3), "table gives " << table(10) << " above its interval");
+	
+	// the interpolation error of a smooth function decreases quadratically with the step
+	const ResponseTable<17> coarse(sine, 0, M_PI);
+	const ResponseTable<33> fine(sine, 0, M_PI);
+	double coarseError(0), fineError(0);
+	for (double x = 0; x <= M_PI; x += 0.001)
+	{
+		coarseError = max(coarseError, fabs(coarse(x) - sin(x)));
+		fineError = max(fineError, fabs(fine(x) - sin(x)));
+	}
+	CHECK(coarseError < 0.005 && fineError < coarseError / 3.5, "interpolation errors of sine are " << coarseError << " and " << fineError);
+}
+
+void testScannerTurret()
+{
+	// the tabulated response of the scanner turret is within 0.5 of the calibrated one
+	World world(200, 200);
+	world.takeObjectOwnership = false;
+	EPuck epuck(EPuck::CAPABILITY_SCANNER_TURRET);
+	epuck.pos = Point(60, 100);
+	world.addObject(&epuck);
+	FastRandom random;
+	random.setSeed(6);
+	PhysicalObject objects[30];
+	for (unsigned i = 0; i < 30; ++i)
+	{
+		objects[i].setCylindric(0.5 + random.getRange(2), 10, -1);
+		const double angle(random.getRange(2*M_PI));
+		objects[i].pos = epuck.pos + Vector(cos(angle), sin(angle)) * (5 + random.getRange(50));
+		world.addObject(&objects[i]);
+	}
+	for (unsigned step = 0; step < 50; ++step)
+	{
+		epuck.angle = random.getRange(2*M_PI);
+		world.step(0.1);
+		const EPuckScannerTurret& turret(epuck.scannerTurret);
+		for (size_t i = 0; i < turret.zbuffer.size(); ++i)
+		{
+			const size_t destIndex(((turret.scan.size()/2) -1 + turret.scan.size() - i) % turret.scan.size());
+			const double expected(EPuckScannerTurret::responseFunction(sqrt(turret.zbuffer[i])));
+			CHECK(fabs(turret.scan[destIndex] - expected) < 0.5, "scanner turret gives " << turret.scan[destIndex] << " instead of " << expected << " at distance " << sqrt(turret.zbuffer[i]));
+		}
+	}
+	
+	// beyond the tabulated 4 m, the calibrated response is below 0.001
+	for (double distance = 400; distance < 10000; distance *= 1.01)
+		CHECK(EPuckScannerTurret::responseFunction(distance) < 0.001, "scanner turret response is " << EPuckScannerTurret::responseFunction(distance) << " at distance " << distance);
+}
+
+void testMarxbotVirtualBumpers()
+{
+	// the tabulated exponential part of the virtual bumpers is within 0.1 % of the function
+	for (double distance = 0.5; distance <= 9; distance += 0.001)
+	{
+		// replay the noise that the response function draws
+		RandomStream randomStream(7, unsigned(distance * 1000));
+		RandomStream noiseStream(randomStream);
+		const double response(marxbotVirtualBumperResponseFunction(distance, randomStream));
+		const double expected(4526 * exp(-0.9994 * distance) * (0.97 + noiseStream.getRange(0.06)));
+		CHECK(fabs(response - expected) < 0.001 * expected, "virtual bumper gives " << response << " instead of " << expected << " at distance " << distance);
+	}
+}
+
+int main()
+{
+	testInterpolation();
+	testScannerTurret();
+	testMarxbotVirtualBumpers();
+	
+	return 0;
+}
@@ -0,0 +1,1214 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "../enki/PhysicalEngine.h"
+#include "../enki/WorldBatch.h"
+#include "../enki/robots/e-puck/EPuck.h"
+#include "../enki/robots/thymio2/Thymio2.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+using namespace Enki;
+using namespace std;
+
+#define CHECK(cond, msg) \
+	if (!(cond)) { \
+		cerr << msg << endl; \
+		exit(1); \
+	}
+
+//! A crowded arena, objects are members so that they can easily be compared between instances
+struct Arena
+{
+	static const unsigned robotCount = 60;
+	static const unsigned boxCount = 20;
+	static const unsigned cylinderCount = 20;
+	
+	EPuck robots[robotCount];
+	PhysicalObject boxes[boxCount];
+	PhysicalObject cylinders[cylinderCount];
+	World world;
+	
+	Arena():
+		world(120, 120)
+	{
+		world.takeObjectOwnership = false;
+		FastRandom placement;
+		placement.setSeed(1);
+		for (unsigned i = 0; i < robotCount; ++i)
+		{
+			robots[i].pos = Point(5 + placement.getRange(110), 5 + placement.getRange(110));
+			robots[i].angle = placement.getRange(2*M_PI);
+			robots[i].leftSpeed = placement.getRange(12);
+			robots[i].rightSpeed = placement.getRange(12);
+			world.addObject(&robots[i]);
+		}
+		for (unsigned i = 0; i < boxCount; ++i)
+		{
+			boxes[i].setRectangular(3 + placement.getRange(10), 2 + placement.getRange(5), 4, i % 4 == 0 ? -1 : 50);
+			boxes[i].pos = Point(10 + placement.getRange(100), 10 + placement.getRange(100));
+			boxes[i].angle = placement.getRange(2*M_PI);
+			world.addObject(&boxes[i]);
+		}
+		for (unsigned i = 0; i < cylinderCount; ++i)
+		{
+			cylinders[i].setCylindric(1 + placement.getRange(3), 3, 20);
+			cylinders[i].pos = Point(10 + placement.getRange(100), 10 + placement.getRange(100));
+			cylinders[i].speed = Vector(placement.getRange(20) - 10, placement.getRange(20) - 10);
+			world.addObject(&cylinders[i]);
+		}
+	}
+	
+	void run(unsigned steps)
+	{
+		world.setRandomSeed(0);
+		srand(0);
+		for (unsigned i = 0; i < steps; ++i)
+			world.step(1./30., 3);
+	}
+	
+	bool operator==(const Arena& that) const
+	{
+		for (unsigned i = 0; i < robotCount; ++i)
+			if (!sameState(robots[i], that.robots[i]) || !sameSensors(robots[i], that.robots[i]))
+				return false;
+		for (unsigned i = 0; i < boxCount; ++i)
+			if (!sameState(boxes[i], that.boxes[i]))
+				return false;
+		for (unsigned i = 0; i < cylinderCount; ++i)
+			if (!sameState(cylinders[i], that.cylinders[i]))
+				return false;
+		return true;
+	}
+	
+	static bool sameSensors(const EPuck& r1, const EPuck& r2)
+	{
+		const IRSensor* s1[] = { &r1.infraredSensor0, &r1.infraredSensor1, &r1.infraredSensor2, &r1.infraredSensor3, &r1.infraredSensor4, &r1.infraredSensor5, &r1.infraredSensor6, &r1.infraredSensor7 };
+		const IRSensor* s2[] = { &r2.infraredSensor0, &r2.infraredSensor1, &r2.infraredSensor2, &r2.infraredSensor3, &r2.infraredSensor4, &r2.infraredSensor5, &r2.infraredSensor6, &r2.infraredSensor7 };
+		for (unsigned i = 0; i < 8; ++i)
+			if (s1[i]->getValue() != s2[i]->getValue())
+				return false;
+		for (size_t i = 0; i < r1.camera.image.size(); ++i)
+			if (r1.camera.image[i] != r2.camera.image[i] || r1.camera.zbuffer[i] != r2.camera.zbuffer[i])
+				return false;
+		for (size_t i = 0; i < r1.scannerTurret.image.size(); ++i)
+			if (r1.scannerTurret.image[i] != r2.scannerTurret.image[i] || r1.scannerTurret.zbuffer[i] != r2.scannerTurret.zbuffer[i])
+				return false;
+		return true;
+	}
+	
+	static bool sameState(const PhysicalObject& o1, const PhysicalObject& o2)
+	{
+		return o1.pos.x == o2.pos.x && o1.pos.y == o2.pos.y && o1.angle == o2.angle &&
+			o1.speed.x == o2.speed.x && o1.speed.y == o2.speed.y && o1.angSpeed == o2.angSpeed;
+	}
+};
+
+void testObjects()
+{
+	World world;
+	world.takeObjectOwnership = false;
+	PhysicalObject objects[5];
+	for (unsigned i = 0; i < 5; ++i)
+		world.addObject(&objects[4 - i]);
+	world.addObject(&objects[2]);
+	CHECK(world.objects.size() == 5, "adding an object twice should do nothing");
+	
+	world.removeObject(&objects[3]);
+	world.removeObject(&objects[3]);
+	CHECK(world.objects.size() == 4, "removing an object twice should do nothing");
+	
+	// objects are in insertion order, the removed one is skipped
+	const PhysicalObject* expected[] = { &objects[4], &objects[2], &objects[1], &objects[0] };
+	unsigned i = 0;
+	for (World::ObjectsIterator it = world.objects.begin(); it != world.objects.end(); ++it, ++i)
+		CHECK(*it == expected[i], "objects are not iterated in insertion order");
+	CHECK(i == 4, "iteration does not go through all objects");
+	
+	// compacting keeps the order, and re-added objects go at the end
+	world.step(0.1);
+	CHECK(world.objects.slotCount() == 4, "step should remove empty slots");
+	world.addObject(&objects[3]);
+	CHECK(world.objects[0] == &objects[4] && world.objects[3] == &objects[0] && world.objects[4] == &objects[3], "compacting does not keep insertion order");
+}
+
+void testMassProperties()
+{
+	const double l1(6), l2(2), mass(3);
+	const double rectangleInertia(mass * (l1*l1 + l2*l2) / 12);
+	
+	PhysicalObject rectangle;
+	rectangle.setRectangular(l1, l2, 1, mass);
+	CHECK(fabs(rectangle.getMomentOfInertia() - rectangleInertia) < 1e-12, "rectangle has moment of inertia " << rectangle.getMomentOfInertia() << " instead of " << rectangleInertia);
+	
+	// the same rectangle made of two off-center halves, composed with the parallel axis theorem
+	Polygone left, right;
+	left << Point(0, 0) << Point(l1/2, 0) << Point(l1/2, l2) << Point(0, l2);
+	right << Point(l1/2, 0) << Point(l1, 0) << Point(l1, l2) << Point(l1/2, l2);
+	PhysicalObject::Hull halves(PhysicalObject::Part(left, 1));
+	halves.push_back(PhysicalObject::Part(right, 1));
+	PhysicalObject composed;
+	composed.setCustomHull(halves, mass);
+	CHECK(fabs(composed.getMomentOfInertia() - rectangleInertia) < 1e-12, "rectangle made of two parts has moment of inertia " << composed.getMomentOfInertia() << " instead of " << rectangleInertia);
+	CHECK(fabs(composed.pos.x - l1/2) < 1e-12 && fabs(composed.pos.y - l2/2) < 1e-12, "rectangle made of two parts has its center of mass at " << composed.pos);
+	
+	// a right triangle, whose moment of inertia around its centroid is m(a²+b²+c²)/36
+	const double a(3), b(4);
+	Polygone triangleShape;
+	triangleShape << Point(0, 0) << Point(a, 0) << Point(0, b);
+	PhysicalObject triangle;
+	triangle.setCustomHull(PhysicalObject::Hull(PhysicalObject::Part(triangleShape, 1)), mass);
+	const double triangleInertia(mass * (a*a + b*b + (a*a + b*b)) / 36);
+	CHECK(fabs(triangle.getMomentOfInertia() - triangleInertia) < 1e-12, "triangle has moment of inertia " << triangle.getMomentOfInertia() << " instead of " << triangleInertia);
+}
+
+void testSharedHulls()
+{
+	// robots of the same model share the geometry of their hulls, but not their transformed shapes
+	Thymio2 thymio1, thymio2;
+	const PhysicalObject::Part& part1(thymio1.getHull()[0]);
+	const PhysicalObject::Part& part2(thymio2.getHull()[0]);
+	CHECK(part1.isShared() && &part1.getShape() == &part2.getShape(), "Thymio II robots do not share their shape");
+	thymio2.pos = Point(10, 0);
+	World world(50, 50);
+	world.takeObjectOwnership = false;
+	world.addObject(&thymio1);
+	world.addObject(&thymio2);
+	world.step(0.1);
+	CHECK(part1.getTransformedShape()[0].x != part2.getTransformedShape()[0].x, "Thymio II robots share their transformed shape");
+	
+	// modifying a part copies its geometry
+	PhysicalObject::Part copy(part1);
+	Polygone shape(part1.getShape());
+	copy.applyTransformation(Matrix22::identity(), Vector(1, 0), 0);
+	CHECK(&copy.getShape() != &part1.getShape(), "modified part still shares its shape");
+	CHECK(part1.getShape()[0].x == shape[0].x && copy.getShape()[0].x == shape[0].x + 1, "modifying a part changed its original");
+}
+
+void testTransformedShape()
+{
+	// transformed shapes are only computed again when the pose or the hull of an object changes
+	PhysicalObject box;
+	box.setRectangular(4, 2, 1, -1);
+	box.pos = Point(10, 10);
+	World world(50, 50);
+	world.takeObjectOwnership = false;
+	world.addObject(&box);
+	world.step(0.1);
+	CHECK(box.getHull()[0].getTransformedShape()[0].x == 8, "transformed shape not computed");
+	
+	box.pos = Point(20, 10);
+	world.step(0.1);
+	CHECK(box.getHull()[0].getTransformedShape()[0].x == 18, "transformed shape not updated after moving the object");
+	
+	box.setRectangular(6, 2, 1, -1);
+	world.step(0.1);
+	CHECK(box.getHull()[0].getTransformedShape()[0].x == 17, "transformed shape not updated after changing the hull");
+}
+
+void testGridBroadphase()
+{
+	Arena allPairs;
+	allPairs.run(300);
+	
+	Arena grid;
+	grid.world.broadphaseType = World::BROADPHASE_GRID;
+	grid.run(300);
+	
+	CHECK(allPairs == grid, "grid broadphase does not give the same results as all pairs");
+}
+
+//! Collide a ball pushed by a heavy one into a third ball, which was too far to touch before the push, and return the position of that third ball
+Point pushIntoContact(World::BroadphaseType broadphaseType, bool useStaticScene)
+{
+	// the pushed ball has the smallest index, so it is moved before colliding with the far one
+	PhysicalObject pushed, heavy, far, corner;
+	pushed.setCylindric(1, 1, 1);
+	pushed.pos = Point(4.1, 0);
+	heavy.setCylindric(1, 1, 1000);
+	heavy.pos = Point(5, 0);
+	far.setCylindric(1, 1, 1);
+	far.pos = Point(1.9, 0);
+	// a static object sets the origin of the grid, so that the far ball is two cells of twice the largest radius away
+	corner.setCylindric(1, 1, -1);
+	corner.pos = Point(0, 20);
+	World world;
+	world.takeObjectOwnership = false;
+	world.broadphaseType = broadphaseType;
+	world.useStaticScene = useStaticScene;
+	world.addObject(&pushed);
+	world.addObject(&heavy);
+	world.addObject(&far);
+	world.addObject(&corner);
+	world.step(0.01, 1);
+	return far.pos;
+}
+
+void testGridMargin()
+{
+	// objects pushed into contact during a collision pass are found by the grid, even if they were more than one cell apart
+	const Point allPairs(pushIntoContact(World::BROADPHASE_ALL_PAIRS, false));
+	CHECK(allPairs.x < 1.9, "ball pushed into contact was not collided with by all pairs");
+	for (unsigned useStaticScene = 0; useStaticScene < 2; ++useStaticScene)
+	{
+		const Point grid(pushIntoContact(World::BROADPHASE_GRID, useStaticScene));
+		CHECK(grid.x == allPairs.x && grid.y == allPairs.y, "grid broadphase " << (useStaticScene ? "with" : "without") << " static scene missed a ball pushed into contact, at " << grid << " instead of " << allPairs);
+	}
+}
+
+void testGridLocalInteractions()
+{
+	Arena arenas[2];
+	for (unsigned a = 0; a < 2; ++a)
+	{
+		// cameras of limited range, otherwise all objects are seen and the grid is not used
+		for (unsigned i = 0; i < Arena::robotCount; ++i)
+		{
+			EPuck& robot(arenas[a].robots[i]);
+			robot.scannerTurret.setRange(15);
+			robot.camera.setRange(20);
+			robot.addLocalInteraction(&robot.camera);
+		}
+	}
+	arenas[0].run(100);
+	arenas[1].world.broadphaseType = World::BROADPHASE_GRID;
+	arenas[1].run(100);
+	
+	CHECK(arenas[0] == arenas[1], "grid broadphase does not give the same local interactions as all pairs");
+}
+
+//! A spinning robot whose camera sees small cylinders many grid cells away, and the end of a long wall whose centre is out of range
+struct FarSightArena
+{
+	static const unsigned cylinderCount = 36;
+	
+	EPuck robot;
+	PhysicalObject cylinders[cylinderCount];
+	PhysicalObject wall;
+	World world;
+	
+	FarSightArena():
+		robot(EPuck::CAPABILITY_BASIC_SENSORS | EPuck::CAPABILITY_CAMERA),
+		world(200, 200)
+	{
+		world.takeObjectOwnership = false;
+		robot.pos = Point(100, 100);
+		robot.leftSpeed = -5;
+		robot.rightSpeed = 5;
+		robot.camera.setRange(50);
+		world.addObject(&robot);
+		// cylinders spiral away up to beyond the range of the camera, the last visible ones being several cells of the grid away,
+		// every other one is static so that both the grid and the static scene are queried
+		for (unsigned i = 0; i < cylinderCount; ++i)
+		{
+			const double angle(i * 2 * M_PI / 12);
+			const double dist(10 + i * 1.25);
+			cylinders[i].setCylindric(1, 3, i % 2 == 0 ? 1 : -1);
+			cylinders[i].pos = robot.pos + Vector(cos(angle), sin(angle)) * dist;
+			cylinders[i].setColor(Color(i / double(cylinderCount), 0, 1));
+			world.addObject(&cylinders[i]);
+		}
+		wall.setRectangular(60, 1, 5, -1);
+		wall.pos = Point(160, 130);
+		world.addObject(&wall);
+	}
+	
+	//! Return the largest distance seen by the camera
+	double farthestPixel() const
+	{
+		double dist2(0);
+		for (size_t i = 0; i < robot.camera.zbuffer.size(); ++i)
+			if (robot.camera.zbuffer[i] < std::numeric_limits<double>::max())
+				dist2 = std::max(dist2, robot.camera.zbuffer[i]);
+		return sqrt(dist2);
+	}
+};
+
+void testGridLocalRange()
+{
+	// objects within the range of interactions are found by the grid even if they are many cells away or if their centre is out of range
+	FarSightArena allPairs, grid, staticScene;
+	grid.world.broadphaseType = World::BROADPHASE_GRID;
+	staticScene.world.broadphaseType = World::BROADPHASE_GRID;
+	staticScene.world.useStaticScene = true;
+	double farthest(0);
+	bool sawWall(false);
+	for (unsigned i = 0; i < 60; ++i)
+	{
+		allPairs.world.step(1./30.);
+		grid.world.step(1./30.);
+		staticScene.world.step(1./30.);
+		for (size_t p = 0; p < allPairs.robot.camera.image.size(); ++p)
+		{
+			CHECK(allPairs.robot.camera.image[p] == grid.robot.camera.image[p] && allPairs.robot.camera.zbuffer[p] == grid.robot.camera.zbuffer[p], "grid broadphase does not give the same camera pixel " << p << " as all pairs at step " << i);
+			CHECK(allPairs.robot.camera.image[p] == staticScene.robot.camera.image[p] && allPairs.robot.camera.zbuffer[p] == staticScene.robot.camera.zbuffer[p], "static scene does not give the same camera pixel " << p << " as all pairs at step " << i);
+			sawWall = sawWall || allPairs.robot.camera.image[p] == allPairs.wall.getColor();
+		}
+		farthest = std::max(farthest, allPairs.farthestPixel());
+	}
+	CHECK(farthest > 40, "camera did not see the far cylinders, farthest pixel at " << farthest);
+	CHECK(sawWall, "camera did not see the end of the wall");
+}
+
+void testStaticScene()
+{
+	// the static scene gives the same collisions and local interactions as all pairs, also when multithreaded
+	Arena arenas[3];
+	for (unsigned a = 0; a < 3; ++a)
+	{
+		for (unsigned i = 0; i < Arena::robotCount; ++i)
+		{
+			EPuck& robot(arenas[a].robots[i]);
+			robot.scannerTurret.setRange(15);
+			robot.camera.setRange(20);
+			robot.addLocalInteraction(&robot.camera);
+		}
+	}
+	arenas[0].run(300);
+	arenas[1].world.broadphaseType = World::BROADPHASE_GRID;
+	arenas[1].world.useStaticScene = true;
+	arenas[1].run(300);
+	arenas[2].world.broadphaseType = World::BROADPHASE_GRID;
+	arenas[2].world.useStaticScene = true;
+	arenas[2].world.threadCount = 4;
+	arenas[2].world.parallelInteractions = true;
+	arenas[2].run(300);
+	
+	CHECK(arenas[0] == arenas[1], "static scene does not give the same results as all pairs");
+	CHECK(arenas[0] == arenas[2], "multithreaded static scene does not give the same results as all pairs");
+	
+	// a long wall stops a ball, also after being moved
+	PhysicalObject wall;
+	wall.setRectangular(1, 80, 10, -1);
+	wall.pos = Point(50, 200);
+	PhysicalObject ball;
+	ball.setCylindric(1, 1, 1);
+	ball.pos = Point(40, 20);
+	World world;
+	world.takeObjectOwnership = false;
+	world.broadphaseType = World::BROADPHASE_GRID;
+	world.useStaticScene = true;
+	world.addObject(&ball);
+	world.addObject(&wall);
+	world.step(0.1);
+	
+	wall.pos.y = 50;
+	ball.speed = Vector(10, 0);
+	for (unsigned i = 0; i < 20; ++i)
+		world.step(0.1);
+	CHECK(ball.pos.x < 49, "ball went through a static wall that was moved");
+	
+	// a static wall turned by changing its hull, without changing its pose or radius, is seen by rays and found by queries
+	double shortestRays[2][2];
+	for (unsigned useStaticScene = 0; useStaticScene < 2; ++useStaticScene)
+	{
+		EPuck robot;
+		robot.pos = Point(50, 60);
+		robot.angle = -M_PI/2;
+		PhysicalObject turned;
+		turned.setRectangular(10, 4, 5, -1);
+		turned.pos = Point(50, 50);
+		World turnWorld(100, 100);
+		turnWorld.takeObjectOwnership = false;
+		turnWorld.broadphaseType = World::BROADPHASE_GRID;
+		turnWorld.useStaticScene = useStaticScene;
+		turnWorld.addObject(&turned);
+		turnWorld.addObject(&robot);
+		for (unsigned turn = 0; turn < 2; ++turn)
+		{
+			if (turn == 1)
+				turned.setRectangular(4, 10, 5, -1);
+			turnWorld.step(0.1);
+			const IRSensor* sensors[] = { &robot.infraredSensor0, &robot.infraredSensor1, &robot.infraredSensor2, &robot.infraredSensor3, &robot.infraredSensor4, &robot.infraredSensor5, &robot.infraredSensor6, &robot.infraredSensor7 };
+			shortestRays[useStaticScene][turn] = std::numeric_limits<double>::max();
+			for (unsigned i = 0; i < 8; ++i)
+				for (unsigned j = 0; j < 3; ++j)
+					shortestRays[useStaticScene][turn] = std::min(shortestRays[useStaticScene][turn], sensors[i]->getRayDist(j));
+		}
+		if (useStaticScene)
+		{
+			StaticScene::Indices found;
+			turnWorld.getStaticScene()->getNeighbours(Point(51.5, 54), 0.1, found);
+			CHECK(found.size() == 1, "static scene query finds " << found.size() << " objects next to a turned wall");
+		}
+	}
+	CHECK(shortestRays[0][1] < shortestRays[0][0] - 2, "turned wall is not closer to the rays, at " << shortestRays[0][1] << " instead of " << shortestRays[0][0]);
+	CHECK(shortestRays[1][0] == shortestRays[0][0] && shortestRays[1][1] == shortestRays[0][1], "rays in the static scene see a turned wall at " << shortestRays[1][1] << " instead of " << shortestRays[0][1]);
+}
+
+//! A maze of static walls and pillars crossed by robots, to compare the rays of their infrared sensors
+struct MazeArena
+{
+	static const unsigned robotCount = 30;
+	static const unsigned wallCount = 200;
+	static const unsigned pillarCount = 40;
+	
+	EPuck robots[robotCount];
+	PhysicalObject walls[wallCount];
+	PhysicalObject pillars[pillarCount];
+	World world;
+	
+	MazeArena():
+		world(200, 200)
+	{
+		world.takeObjectOwnership = false;
+		FastRandom placement;
+		placement.setSeed(3);
+		for (unsigned i = 0; i < wallCount; ++i)
+		{
+			// walls on the edges of a grid of 20 cm, some of them tilted in the upper half
+			const bool vertical(i % 2 == 0);
+			walls[i].setRectangular(vertical ? 1 : 20, vertical ? 20 : 1, 5, -1);
+			walls[i].pos = Point(10 + 20 * ((i / 2) % 10), 10 + 20 * ((i / 2) / 10 % 10)) + (vertical ? Vector(10, 0) : Vector(0, 10));
+			walls[i].angle = (i >= 100 && i % 7 == 0) ? placement.getRange(0.5) : 0;
+			world.addObject(&walls[i]);
+		}
+		for (unsigned i = 0; i < pillarCount; ++i)
+		{
+			pillars[i].setCylindric(1 + placement.getRange(2), 5, -1);
+			pillars[i].pos = Point(20 * (1 + i % 9), 20 * (1 + (i / 9) % 9));
+			world.addObject(&pillars[i]);
+		}
+		for (unsigned i = 0; i < robotCount; ++i)
+		{
+			robots[i].pos = Point(5 + 20 * (i % 10) + placement.getRange(10), 5 + 20 * (i / 10) * 3 + placement.getRange(10));
+			robots[i].angle = placement.getRange(2*M_PI);
+			robots[i].leftSpeed = 5 + placement.getRange(10);
+			robots[i].rightSpeed = 5 + placement.getRange(10);
+			world.addObject(&robots[i]);
+		}
+	}
+	
+	bool operator==(const MazeArena& that) const
+	{
+		for (unsigned i = 0; i < robotCount; ++i)
+		{
+			if (!Arena::sameState(robots[i], that.robots[i]))
+				return false;
+			const IRSensor* s1[] = { &robots[i].infraredSensor0, &robots[i].infraredSensor1, &robots[i].infraredSensor2, &robots[i].infraredSensor3, &robots[i].infraredSensor4, &robots[i].infraredSensor5, &robots[i].infraredSensor6, &robots[i].infraredSensor7 };
+			const IRSensor* s2[] = { &that.robots[i].infraredSensor0, &that.robots[i].infraredSensor1, &that.robots[i].infraredSensor2, &that.robots[i].infraredSensor3, &that.robots[i].infraredSensor4, &that.robots[i].infraredSensor5, &that.robots[i].infraredSensor6, &that.robots[i].infraredSensor7 };
+			for (unsigned j = 0; j < 8; ++j)
+				for (unsigned k = 0; k < 3; ++k)
+					if (s1[j]->getRayDist(k) != s2[j]->getRayDist(k) || s1[j]->getValue() != s2[j]->getValue())
+						return false;
+		}
+		return true;
+	}
+	
+	//! Return the number of rays that hit an obstacle
+	unsigned hitRayCount() const
+	{
+		unsigned count(0);
+		for (unsigned i = 0; i < robotCount; ++i)
+		{
+			const IRSensor* s[] = { &robots[i].infraredSensor0, &robots[i].infraredSensor1, &robots[i].infraredSensor2, &robots[i].infraredSensor3, &robots[i].infraredSensor4, &robots[i].infraredSensor5, &robots[i].infraredSensor6, &robots[i].infraredSensor7 };
+			for (unsigned j = 0; j < 8; ++j)
+				for (unsigned k = 0; k < 3; ++k)
+					count += s[j]->getRayDist(k) < 12;
+		}
+		return count;
+	}
+};
+
+void testStaticSceneRays()
+{
+	// infrared sensors casting rays into the static scene give the same distances as all pairs, at every step
+	MazeArena allPairs, staticScene, parallelStaticScene;
+	staticScene.world.broadphaseType = World::BROADPHASE_GRID;
+	staticScene.world.useStaticScene = true;
+	parallelStaticScene.world.broadphaseType = World::BROADPHASE_GRID;
+	parallelStaticScene.world.useStaticScene = true;
+	parallelStaticScene.world.threadCount = 4;
+	parallelStaticScene.world.parallelInteractions = true;
+	unsigned hitRayCount(0);
+	for (unsigned i = 0; i < 200; ++i)
+	{
+		allPairs.world.step(1./30., 3);
+		staticScene.world.step(1./30., 3);
+		parallelStaticScene.world.step(1./30., 3);
+		CHECK(allPairs == staticScene, "rays in the static scene do not give the same distances as all pairs at step " << i);
+		CHECK(allPairs == parallelStaticScene, "multithreaded rays in the static scene do not give the same distances as all pairs at step " << i);
+		hitRayCount += allPairs.hitRayCount();
+	}
+	CHECK(hitRayCount > 1000, "only " << hitRayCount << " rays hit the maze");
+	
+	// a ray query finds the walls crossed by a segment, also ending on their border or going backwards
+	StaticScene::Indices neighbours;
+	staticScene.world.step(0.1);
+	const StaticScene* scene(staticScene.world.getStaticScene());
+	CHECK(scene && scene->size() == MazeArena::wallCount + MazeArena::pillarCount, "static scene has the wrong size");
+	scene->getRayNeighbours(Point(25, 5), Vector(0, 40), neighbours);
+	CHECK(neighbours.size() == 2 && scene->getObject(neighbours[0]) == &staticScene.walls[3] && scene->getObject(neighbours[1]) == &staticScene.walls[23], "ray query along x = 25 finds " << neighbours.size() << " objects");
+	neighbours.clear();
+	scene->getRayNeighbours(Point(25, 39.5), Vector(0, -20), neighbours);
+	CHECK(neighbours.size() == 2, "backward ray query ending on borders finds " << neighbours.size() << " objects");
+	neighbours.clear();
+	scene->getRayNeighbours(Point(25, 22), Vector(0, 6), neighbours);
+	CHECK(neighbours.empty(), "ray query between walls finds " << neighbours.size() << " objects");
+}
+
+void testMultithreading()
+{
+	for (unsigned b = 0; b < 2; ++b)
+	{
+		const World::BroadphaseType broadphaseType(b == 0 ? World::BROADPHASE_ALL_PAIRS : World::BROADPHASE_GRID);
+		
+		Arena singleThreaded;
+		singleThreaded.world.broadphaseType = broadphaseType;
+		singleThreaded.run(300);
+		
+		Arena multiThreaded;
+		multiThreaded.world.broadphaseType = broadphaseType;
+		multiThreaded.world.threadCount = 4;
+		multiThreaded.run(300);
+		
+		CHECK(singleThreaded == multiThreaded, "multithreaded physics does not give the same results as single-threaded with broadphase " << broadphaseType);
+	}
+}
+
+//! Rows of touching balls hit at one end and ending on a static wall shared by all rows, every row being an island spanning many grid cells
+struct CradleArena
+{
+	static const unsigned rowCount = 6;
+	static const unsigned ballsPerRow = 12;
+	
+	PhysicalObject wall;
+	PhysicalObject balls[rowCount][ballsPerRow];
+	World world;
+	
+	CradleArena():
+		world(60, 80)
+	{
+		world.takeObjectOwnership = false;
+		world.broadphaseType = World::BROADPHASE_GRID;
+		// the wall is just beyond the last ball of every row, so that pushed rows touch it
+		wall.setRectangular(1, 70, 5, -1);
+		wall.pos = Point(33.8, 40);
+		world.addObject(&wall);
+		for (unsigned row = 0; row < rowCount; ++row)
+		{
+			for (unsigned i = 0; i < ballsPerRow; ++i)
+			{
+				PhysicalObject& ball(balls[row][i]);
+				ball.setCylindric(1, 1, 1 + (i + row) % 3);
+				ball.pos = Point(10 + i * 1.99, 10 + row * 11);
+				world.addObject(&ball);
+			}
+			balls[row][0].speed = Vector(20 + row, 0);
+		}
+	}
+	
+	bool operator==(const CradleArena& that) const
+	{
+		for (unsigned row = 0; row < rowCount; ++row)
+			for (unsigned i = 0; i < ballsPerRow; ++i)
+				if (!Arena::sameState(balls[row][i], that.balls[row][i]))
+					return false;
+		return true;
+	}
+};
+
+void testParallelIslands()
+{
+	// every row is collided in its island on its own thread, its pairs in the same order as when single-threaded
+	CradleArena singleThreaded, multiThreaded;
+	multiThreaded.world.threadCount = 4;
+	bool reachedWall[CradleArena::rowCount] = { false };
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		singleThreaded.world.step(1./30., 3);
+		multiThreaded.world.step(1./30., 3);
+		CHECK(singleThreaded == multiThreaded, "multithreaded collisions of islands do not give the same results as single-threaded at step " << i);
+		for (unsigned row = 0; row < CradleArena::rowCount; ++row)
+			reachedWall[row] = reachedWall[row] || multiThreaded.balls[row][CradleArena::ballsPerRow - 1].pos.x > 32.2;
+	}
+	for (unsigned row = 0; row < CradleArena::rowCount; ++row)
+	{
+		CHECK(reachedWall[row], "push was not transmitted along row " << row);
+		CHECK(multiThreaded.balls[row][CradleArena::ballsPerRow - 1].pos.x < 32.31, "last ball of row " << row << " went through the wall");
+	}
+	CHECK(multiThreaded.wall.pos.x == 33.8 && multiThreaded.wall.speed.x == 0, "static wall was moved by collisions");
+}
+
+//! Static walls between rows of balls, every wall being touched by balls of many different islands
+struct WallsArena
+{
+	static const unsigned wallCount = 4;
+	static const unsigned ballsPerWall = 10;
+	
+	PhysicalObject walls[wallCount];
+	PhysicalObject balls[wallCount][2][ballsPerWall];
+	World world;
+	
+	WallsArena():
+		world(100, 100)
+	{
+		world.takeObjectOwnership = false;
+		world.broadphaseType = World::BROADPHASE_GRID;
+		world.allowSleeping = true;
+		for (unsigned w = 0; w < wallCount; ++w)
+		{
+			walls[w].setRectangular(1, 90, 5, -1);
+			walls[w].pos = Point(12.5 + w * 25, 50);
+			world.addObject(&walls[w]);
+			// balls are far enough from each other not to link their islands, but all bounce on the wall
+			for (unsigned side = 0; side < 2; ++side)
+			{
+				for (unsigned i = 0; i < ballsPerWall; ++i)
+				{
+					PhysicalObject& ball(balls[w][side][i]);
+					ball.setCylindric(1, 1, 1 + i);
+					ball.pos = Point(walls[w].pos.x + (side == 0 ? -6 : 6), 8 + i * 9);
+					const double direction(side == 0 ? 1 : -1);
+					ball.speed = Vector(direction * (10 + i), 0);
+					world.addObject(&ball);
+				}
+			}
+		}
+	}
+	
+	void run(unsigned steps)
+	{
+		for (unsigned i = 0; i < steps; ++i)
+			world.step(1./30., 3);
+	}
+	
+	bool operator==(const WallsArena& that) const
+	{
+		for (unsigned w = 0; w < wallCount; ++w)
+			for (unsigned side = 0; side < 2; ++side)
+				for (unsigned i = 0; i < ballsPerWall; ++i)
+					if (!Arena::sameState(balls[w][side][i], that.balls[w][side][i]))
+						return false;
+		return true;
+	}
+};
+
+void testParallelStaticWalls()
+{
+	// static walls are shared by the islands colliding in parallel, collisions must not write to them
+	WallsArena sequential;
+	sequential.run(200);
+	WallsArena parallel;
+	parallel.world.threadCount = 4;
+	parallel.run(200);
+	
+	CHECK(sequential == parallel, "multithreaded physics with static walls shared by islands does not give the same results as single-threaded");
+	for (unsigned w = 0; w < WallsArena::wallCount; ++w)
+	{
+		CHECK(!parallel.walls[w].isSleeping(), "static wall " << w << " fell asleep");
+		CHECK(parallel.walls[w].pos.x == sequential.walls[w].pos.x && parallel.walls[w].speed.x == 0, "static wall " << w << " was moved by collisions");
+	}
+	bool bounced(true);
+	for (unsigned w = 0; w < WallsArena::wallCount; ++w)
+		for (unsigned i = 0; i < WallsArena::ballsPerWall; ++i)
+			bounced = bounced && parallel.balls[w][0][i].pos.x < parallel.walls[w].pos.x && parallel.balls[w][1][i].pos.x > parallel.walls[w].pos.x;
+	CHECK(bounced, "balls went through static walls");
+}
+
+void testParallelInteractions()
+{
+	for (unsigned b = 0; b < 2; ++b)
+	{
+		const World::BroadphaseType broadphaseType(b == 0 ? World::BROADPHASE_ALL_PAIRS : World::BROADPHASE_GRID);
+		
+		Arena sequential;
+		sequential.world.broadphaseType = broadphaseType;
+		sequential.run(100);
+		
+		// noise is drawn from per-object random streams, so results do not depend on the number of threads
+		for (unsigned threadCount = 1; threadCount <= 4; threadCount *= 4)
+		{
+			Arena parallel;
+			parallel.world.broadphaseType = broadphaseType;
+			parallel.world.parallelInteractions = true;
+			parallel.world.threadCount = threadCount;
+			parallel.run(100);
+			
+			CHECK(sequential == parallel, "parallel interactions do not give the same results as sequential ones with broadphase " << broadphaseType << " and " << threadCount << " threads");
+		}
+	}
+}
+
+//! An e-puck avoiding obstacles and sending what its front sensors see to the next robot of a ring over Bluetooth
+struct RelayEPuck : public EPuck
+{
+	unsigned next;
+	unsigned previous;
+	std::vector<int> received;
+	
+	RelayEPuck():
+		EPuck(CAPABILITY_BASIC_SENSORS | CAPABILITY_BLUETOOTH),
+		next(0),
+		previous(0)
+	{}
+	
+	//! Read the sensors and the data received, only writing to this robot and its own interactions as required by World::parallelInteractions
+	virtual void controlStep(double dt)
+	{
+		if (bluetooth->didIReceive(previous))
+		{
+			int value;
+			memcpy(&value, bluetooth->getRxBuffer(previous), sizeof(value));
+			received.push_back(value);
+		}
+		const double left(infraredSensor6.getValue() + infraredSensor7.getValue());
+		const double right(infraredSensor0.getValue() + infraredSensor1.getValue());
+		leftSpeed = 10 - right * 0.01 + left * 0.005;
+		rightSpeed = 10 - left * 0.01 + right * 0.005;
+		int value(int(left + right));
+		bluetooth->sendDataTo(next, reinterpret_cast<char*>(&value), sizeof(value));
+		EPuck::controlStep(dt);
+	}
+};
+
+//! A ring of relaying e-pucks in a small square
+struct RelayArena
+{
+	static const unsigned robotCount = 8;
+	
+	RelayEPuck robots[robotCount];
+	World world;
+	
+	RelayArena():
+		world(40, 40)
+	{
+		world.takeObjectOwnership = false;
+		for (unsigned i = 0; i < robotCount; ++i)
+		{
+			robots[i].pos = Point(20 + 12 * cos(i * 2 * M_PI / robotCount), 20 + 12 * sin(i * 2 * M_PI / robotCount));
+			robots[i].angle = i;
+			robots[i].bluetooth->setAddress(i + 1);
+			robots[i].next = (i + 1) % robotCount + 1;
+			robots[i].previous = (i + robotCount - 1) % robotCount + 1;
+			world.addObject(&robots[i]);
+		}
+		for (unsigned i = 0; i < robotCount; ++i)
+			robots[i].bluetooth->connectTo(robots[i].next);
+	}
+	
+	bool operator==(const RelayArena& that) const
+	{
+		for (unsigned i = 0; i < robotCount; ++i)
+			if (!Arena::sameState(robots[i], that.robots[i]) || !Arena::sameSensors(robots[i], that.robots[i]) || robots[i].received != that.robots[i].received)
+				return false;
+		return true;
+	}
+};
+
+void testParallelControllers()
+{
+	// controllers run concurrently, reading their sensors and the data relayed by the global Bluetooth base, which is stepped one robot at a time
+	RelayArena sequential, parallel;
+	parallel.world.parallelInteractions = true;
+	parallel.world.threadCount = 4;
+	for (unsigned i = 0; i < 200; ++i)
+	{
+		sequential.world.step(1./30.);
+		parallel.world.step(1./30.);
+		CHECK(sequential == parallel, "parallel controllers do not give the same results as sequential ones at step " << i);
+	}
+	double sensed(0);
+	for (unsigned i = 0; i < RelayArena::robotCount; ++i)
+	{
+		CHECK(parallel.robots[i].received.size() > 50, "robot " << i << " only received " << parallel.robots[i].received.size() << " messages");
+		for (size_t j = 0; j < parallel.robots[i].received.size(); ++j)
+			sensed += parallel.robots[i].received[j];
+	}
+	CHECK(sensed > 0, "robots relayed no sensor values");
+}
+
+void testSleeping()
+{
+	// with the default threshold, sleeping does not change the results
+	Arena awake;
+	awake.run(300);
+	
+	Arena sleeping;
+	sleeping.world.allowSleeping = true;
+	sleeping.run(300);
+	
+	CHECK(awake == sleeping, "sleeping changes the results of the simulation");
+	
+	// sleeping objects moved between steps are woken up the same way when physics and interactions are multithreaded
+	Arena singleThreaded, multiThreaded;
+	multiThreaded.world.broadphaseType = World::BROADPHASE_GRID;
+	multiThreaded.world.threadCount = 4;
+	multiThreaded.world.parallelInteractions = true;
+	Arena* arenas[2] = { &singleThreaded, &multiThreaded };
+	unsigned wokenCount(0);
+	for (unsigned a = 0; a < 2; ++a)
+	{
+		World& world(arenas[a]->world);
+		world.allowSleeping = true;
+		world.sleepSpeedThreshold = 2;
+		// longer than the physics steps of one step, so that woken objects are still awake after it
+		world.sleepDelay = 10;
+		world.setRandomSeed(0);
+		bool nudged[Arena::cylinderCount] = { false };
+		for (unsigned i = 0; i < 200; ++i)
+		{
+			world.step(1./30., 3);
+			for (unsigned c = 0; c < Arena::cylinderCount; ++c)
+			{
+				// nudge every sleeping cylinder once in a while, so that it wakes up and might push its neighbours
+				PhysicalObject& cylinder(arenas[a]->cylinders[c]);
+				CHECK(!nudged[c] || !cylinder.isSleeping(), "cylinder " << c << " moved between steps was not woken up in arena " << a);
+				nudged[c] = cylinder.isSleeping() && (i + c) % 40 == 0;
+				if (nudged[c])
+				{
+					cylinder.pos += Vector(0.5, 0);
+					wokenCount += a == 0;
+				}
+			}
+		}
+	}
+	CHECK(wokenCount > 0, "no sleeping object was moved");
+	CHECK(singleThreaded == multiThreaded, "multithreaded physics does not give the same results as single-threaded with sleeping objects moved between steps");
+	for (unsigned c = 0; c < Arena::cylinderCount; ++c)
+		CHECK(singleThreaded.cylinders[c].isSleeping() == multiThreaded.cylinders[c].isSleeping(), "cylinder " << c << " is not in the same sleeping state when multithreaded");
+	
+	// a pushed box comes to rest and falls asleep
+	PhysicalObject box;
+	box.setRectangular(4, 2, 1, 10);
+	box.pos = Point(20, 20);
+	box.speed = Vector(5, 0);
+	PhysicalObject ball;
+	ball.setCylindric(1, 1, 10);
+	ball.pos = Point(40, 20);
+	World world(60, 60);
+	world.takeObjectOwnership = false;
+	world.allowSleeping = true;
+	world.addObject(&box);
+	world.addObject(&ball);
+	for (unsigned i = 0; i < 100; ++i)
+		world.step(0.1);
+	CHECK(box.isSleeping(), "box at rest is not asleep");
+	CHECK(box.speed.x == 0 && box.speed.y == 0 && box.angSpeed == 0, "sleeping box is moving");
+	
+	// moving it from outside wakes it up
+	box.pos.y = 30;
+	world.step(0.1);
+	CHECK(!box.isSleeping(), "box moved from outside is still asleep");
+	for (unsigned i = 0; i < 100; ++i)
+		world.step(0.1);
+	CHECK(box.isSleeping(), "box at rest did not fall asleep again");
+	
+	// being hit wakes it up
+	ball.pos = Point(box.pos.x + 10, 30);
+	ball.speed = Vector(-20, 0);
+	for (unsigned i = 0; i < 10; ++i)
+		world.step(0.1);
+	CHECK(!box.isSleeping() && box.pos.x < 20, "box hit by a ball did not wake up");
+	
+	// disabling sleeping wakes all objects
+	for (unsigned i = 0; i < 200; ++i)
+		world.step(0.1);
+	CHECK(box.isSleeping(), "box at rest did not fall asleep after being hit");
+	world.allowSleeping = false;
+	world.step(0.1);
+	CHECK(!box.isSleeping(), "box still asleep when sleeping is disabled");
+}
+
+void testSnapshot()
+{
+	Arena reference;
+	reference.run(150);
+	
+	Arena arena;
+	arena.run(50);
+	Snapshot snapshot;
+	arena.world.snapshot(snapshot);
+	const size_t snapshotSize(snapshot.size());
+	
+	// running from the restored state twice gives the results of an uninterrupted run
+	for (unsigned replay = 0; replay < 2; ++replay)
+	{
+		for (unsigned i = 0; i < 100; ++i)
+			arena.world.step(1./30., 3);
+		CHECK(arena == reference, "run " << replay << " from the snapshot does not give the same results as an uninterrupted run");
+		CHECK(arena.world.restore(snapshot), "restore failed");
+		CHECK(arena.world.getStepCount() == 50, "restore brought back step " << arena.world.getStepCount() << " instead of 50");
+	}
+	arena.world.snapshot(snapshot);
+	CHECK(snapshot.size() == snapshotSize, "snapshot size changed from " << snapshotSize << " to " << snapshot.size());
+	
+	// a world with other objects is left untouched
+	arena.world.removeObject(&arena.boxes[0]);
+	const Point pos(arena.robots[0].pos);
+	arena.robots[0].pos += Vector(1, 1);
+	CHECK(!arena.world.restore(snapshot), "restore succeeded on a world with other objects");
+	CHECK(arena.robots[0].pos.x == pos.x + 1, "failed restore changed the world");
+	arena.world.addObject(&arena.boxes[0]);
+	CHECK(!arena.world.restore(snapshot), "restore succeeded on a world whose objects were added in another order");
+	
+	// static objects moved after the snapshot are brought back, and the static scene and sleeping follow them
+	Arena staticReference, staticArena;
+	Arena* arenas[2] = { &staticReference, &staticArena };
+	for (unsigned a = 0; a < 2; ++a)
+	{
+		World& world(arenas[a]->world);
+		world.broadphaseType = World::BROADPHASE_GRID;
+		world.useStaticScene = true;
+		world.allowSleeping = true;
+		world.sleepSpeedThreshold = 2;
+	}
+	staticReference.run(150);
+	staticArena.run(50);
+	staticArena.world.snapshot(snapshot);
+	for (unsigned b = 0; b < Arena::boxCount; b += 4)
+		staticArena.boxes[b].pos += Vector(30, 0);
+	for (unsigned i = 0; i < 100; ++i)
+		staticArena.world.step(1./30., 3);
+	CHECK(!(staticArena == staticReference), "moving static boxes did not change the results");
+	CHECK(staticArena.world.restore(snapshot), "restore failed with static boxes moved");
+	for (unsigned i = 0; i < 100; ++i)
+		staticArena.world.step(1./30., 3);
+	CHECK(staticArena == staticReference, "run from the snapshot does not give the same results as an uninterrupted run after static boxes were moved");
+}
+
+void testSnapshotBluetooth()
+{
+	// two e-pucks exchanging data over Bluetooth
+	EPuck sender(EPuck::CAPABILITY_BLUETOOTH), receiver(EPuck::CAPABILITY_BLUETOOTH);
+	sender.pos = Point(10, 10);
+	sender.bluetooth->setAddress(1);
+	receiver.pos = Point(20, 10);
+	receiver.bluetooth->setAddress(2);
+	World world(50, 50);
+	world.takeObjectOwnership = false;
+	world.addObject(&sender);
+	world.addObject(&receiver);
+	sender.bluetooth->connectTo(2);
+	world.step(0.1);
+	char message[] = "snapshot";
+	CHECK(sender.bluetooth->sendDataTo(2, message, sizeof(message)), "e-pucks are not connected");
+	Snapshot snapshot;
+	world.snapshot(snapshot);
+	
+	// the data is sent again after a restore
+	for (unsigned replay = 0; replay < 2; ++replay)
+	{
+		world.step(0.1);
+		CHECK(receiver.bluetooth->didIReceive(1) && receiver.bluetooth->getSizeReceived(1) == sizeof(message), "no data received in run " << replay);
+		CHECK(std::string(receiver.bluetooth->getRxBuffer(1)) == message, "wrong data received in run " << replay);
+		CHECK(world.restore(snapshot), "restore failed");
+	}
+	
+	// a world whose Bluetooth buffers changed size is left untouched
+	receiver.bluetooth->changeTxBufferSize(50);
+	const Point pos(sender.pos);
+	sender.pos.x += 1;
+	CHECK(!world.restore(snapshot), "restore succeeded with Bluetooth buffers of another size");
+	CHECK(sender.pos.x == pos.x + 1, "failed restore changed the world");
+	receiver.bluetooth->changeTxBufferSize(100);
+	CHECK(world.restore(snapshot) && sender.pos.x == pos.x, "restore failed with Bluetooth buffers of the original size");
+}
+
+//! A small world of a few e-pucks, for evaluations
+struct SmallWorld : public World
+{
+	static const unsigned robotCount = 5;
+	EPuck robots[robotCount];
+	
+	SmallWorld(unsigned seed):
+		World(50, 50)
+	{
+		takeObjectOwnership = false;
+		setRandomSeed(seed);
+		FastRandom placement;
+		placement.setSeed(seed);
+		for (unsigned i = 0; i < robotCount; ++i)
+		{
+			robots[i].pos = Point(5 + placement.getRange(40), 5 + placement.getRange(40));
+			robots[i].angle = placement.getRange(2*M_PI);
+			addObject(&robots[i]);
+		}
+	}
+	
+	bool operator==(const SmallWorld& that) const
+	{
+		for (unsigned i = 0; i < robotCount; ++i)
+			if (!Arena::sameState(robots[i], that.robots[i]) || !Arena::sameSensors(robots[i], that.robots[i]))
+				return false;
+		return true;
+	}
+};
+
+//! Braitenberg obstacle avoidance for all the robots of a batch of small worlds, checking that worlds run in lock-step
+struct AvoidObstacles : public WorldBatchCallback
+{
+	unsigned callCount;
+	
+	AvoidObstacles() : callCount(0) {}
+	
+	virtual void operator()(WorldBatch& batch, unsigned step)
+	{
+		CHECK(step == callCount, "callback called for step " << step << " instead of " << callCount);
+		++callCount;
+		for (size_t w = 0; w < batch.size(); ++w)
+		{
+			CHECK(batch[w]->getStepCount() == step + 1, "world " << w << " did " << batch[w]->getStepCount() << " steps instead of " << step + 1);
+			avoidObstacles(*static_cast<SmallWorld*>(batch[w]));
+		}
+	}
+	
+	static void avoidObstacles(SmallWorld& world)
+	{
+		for (unsigned i = 0; i < SmallWorld::robotCount; ++i)
+		{
+			EPuck& robot(world.robots[i]);
+			const double left(robot.infraredSensor6.getValue() + robot.infraredSensor7.getValue());
+			const double right(robot.infraredSensor0.getValue() + robot.infraredSensor1.getValue());
+			robot.leftSpeed = 10 - right * 0.01 + left * 0.005;
+			robot.rightSpeed = 10 - left * 0.01 + right * 0.005;
+		}
+	}
+};
+
+void testWorldBatch()
+{
+	const unsigned worldCount(8);
+	const unsigned steps(100);
+	
+	// worlds stepped one by one, owned by a batch that is not run
+	WorldBatch reference;
+	for (unsigned w = 0; w < worldCount; ++w)
+	{
+		SmallWorld* world(new SmallWorld(w));
+		reference.addWorld(world);
+		for (unsigned i = 0; i < steps; ++i)
+		{
+			world->step(0.1);
+			AvoidObstacles::avoidObstacles(*world);
+		}
+	}
+	
+	// worlds in a batch, in lock-step
+	WorldBatch batch(4);
+	for (unsigned w = 0; w < worldCount; ++w)
+		batch.addWorld(new SmallWorld(w));
+	AvoidObstacles callback;
+	batch.run(steps, 0.1, 1, &callback);
+	CHECK(callback.callCount == steps, "callback called " << callback.callCount << " times instead of " << steps);
+	for (unsigned w = 0; w < worldCount; ++w)
+		CHECK(*static_cast<SmallWorld*>(batch[w]) == *static_cast<SmallWorld*>(reference[w]), "world " << w << " of batch does not give the same results as when stepped alone");
+	
+	// without callback, worlds run freely
+	for (unsigned w = 0; w < worldCount; ++w)
+		for (unsigned i = 0; i < steps; ++i)
+			reference[w]->step(0.1);
+	batch.run(steps, 0.1);
+	for (unsigned w = 0; w < worldCount; ++w)
+		CHECK(*static_cast<SmallWorld*>(batch[w]) == *static_cast<SmallWorld*>(reference[w]), "world " << w << " of free-running batch does not give the same results as when stepped alone");
+}
+
+//! Count the steps, for batches whose worlds are not SmallWorld
+struct CountSteps : public WorldBatchCallback
+{
+	unsigned callCount;
+	
+	CountSteps() : callCount(0) {}
+	
+	virtual void operator()(WorldBatch& batch, unsigned step)
+	{
+		++callCount;
+	}
+};
+
+void testWorldBatchLoad()
+{
+	// a crowded world and small ones take very different times per step, which does not change their results
+	Arena reference, crowded;
+	reference.world.setRandomSeed(0);
+	SmallWorld referenceSmall(1);
+	for (unsigned i = 0; i < 50; ++i)
+	{
+		reference.world.step(1./30., 3);
+		referenceSmall.step(1./30., 3);
+	}
+	crowded.world.setRandomSeed(0);
+	WorldBatch batch(4);
+	batch.takeWorldOwnership = false;
+	SmallWorld small0(1), small1(1);
+	batch.addWorld(&small0);
+	batch.addWorld(&crowded.world);
+	batch.addWorld(&small1);
+	CountSteps callback;
+	batch.run(50, 1./30., 3, &callback);
+	CHECK(callback.callCount == 50, "callback called " << callback.callCount << " times instead of 50");
+	CHECK(crowded == reference, "crowded world of batch does not give the same results as when stepped alone");
+	CHECK(small0 == referenceSmall && small1 == referenceSmall, "small worlds of batch with a crowded one do not give the same results as when stepped alone");
+	
+	// more threads than worlds, and no world at all
+	batch.removeWorld(&small0);
+	batch.removeWorld(&crowded.world);
+	CHECK(batch.size() == 1, "batch has " << batch.size() << " worlds instead of 1");
+	for (unsigned i = 0; i < 20; ++i)
+		referenceSmall.step(1./30., 3);
+	batch.run(20, 1./30., 3, &callback);
+	CHECK(small1 == referenceSmall, "single world of batch does not give the same results as when stepped alone");
+	batch.removeWorld(&small1);
+	batch.run(20, 1./30., 3, &callback);
+	CHECK(callback.callCount == 90, "callback of empty batch called " << callback.callCount - 70 << " times instead of 20");
+}
+
+int main()
+{
+	testObjects();
+	testMassProperties();
+	testSharedHulls();
+	testTransformedShape();
+	testGridBroadphase();
+	testGridMargin();
+	testGridLocalInteractions();
+	testGridLocalRange();
+	testStaticScene();
+	testStaticSceneRays();
+	testMultithreading();
+	testParallelIslands();
+	testParallelStaticWalls();
+	testParallelInteractions();
+	testParallelControllers();
+	testSleeping();
+	testSnapshot();
+	testSnapshotBluetooth();
+	testWorldBatch();
+	testWorldBatchLoad();
+	
+	return 0;
+}
@@ -52,57 +52,85 @@ namespace Enki
 		textures.resize(2);
 		textures[0] = viewer->bindTexture(QPixmap(QString(":/textures/epuck.png")), GL_TEXTURE_2D);
 		textures[1] = viewer->bindTexture(QPixmap(QString(":/textures/epuckr.png")), GL_TEXTURE_2D, GL_LUMINANCE8);
-		lists.resize(5);
-		lists[0] = GenEPuckBody();
-		lists[1] = GenEPuckRest();
-		lists[2] = GenEPuckRing();
-		lists[3] = GenEPuckWheelLeft();
-		lists[4] = GenEPuckWheelRight();
+		meshes.resize(6);
+		meshes[0] = GenEPuckBody();
+		meshes[1] = GenEPuckRest();
+		meshes[2] = GenEPuckRing();
+		meshes[3] = GenEPuckWheelLeft();
+		meshes[4] = GenEPuckWheelRight();
+		const GLfloat shadowTexCoords[4][2] = { { 0.49f, 0.01f }, { 0.49f, 0.49f }, { 0.01f, 0.49f }, { 0.01f, 0.01f } };
+		meshes[5].addGroundQuad(-5.f, -5.f, 5.f, 5.f, shadowTexCoords);
+		meshes[5].upload();
 	}
 	
 	void EPuckModel::cleanup(ViewerWidget* viewer)
 	{
 		for (int i = 0; i < textures.size(); i++)
 			viewer->deleteTexture(textures[i]);
-		for (int i = 0; i < lists.size(); i++)
-			glDeleteLists(lists[i], 1);
+		for (int i = 0; i < meshes.size(); i++)
+			meshes[i].destroy();
 	}
 	
 	void EPuckModel::draw(PhysicalObject* object) const
 	{
-		DifferentialWheeled* dw = polymorphic_downcast<DifferentialWheeled*>(object);
-		
+		drawAsInstance(object);
+	}
+	
+	void EPuckModel::drawInstances(const Instances& objects) const
+	{
 		const double wheelRadius = 2.1;
 		const double wheelCirc = 2 * M_PI * wheelRadius;
 		const double radiosityScale = 1.01;
 		
-		glPushMatrix();
-		glTranslated(0, 0, wheelRadius);
 		glEnable(GL_TEXTURE_2D);
 		glBindTexture(GL_TEXTURE_2D, textures[0]);
 		
 		glColor3d(1, 1, 1);
 		
-		glCallList(lists[0]);
+		// body and rest
+		for (int part = 0; part < 2; ++part)
+		{
+			meshes[part].bind();
+			for (size_t i = 0; i < objects.size(); ++i)
+			{
+				pushObjectPose(objects[i]);
+				glTranslated(0, 0, wheelRadius);
+				meshes[part].draw();
+				glPopMatrix();
+			}
+			meshes[part].release();
+		}
 		
-		glCallList(lists[1]);
-		
-		//glColor3d(1-object->getColor().components[0], 1+object->getColor().components[1], 1+object->getColor().components[2]);
-		glColor3d(0.6+object->getColor().components[0]-0.3*object->getColor().components[1]-0.3*object->getColor().components[2], 0.6+object->getColor().components[1]-0.3*object->getColor().components[0]-0.3*object->getColor().components[2], 0.6+object->getColor().components[2]-0.3*object->getColor().components[0]-0.3*object->getColor().components[1]);
-		glCallList(lists[2]);
+		// ring, in the color of each robot
+		meshes[2].bind();
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			const Color& color(objects[i]->color);
+			glColor3d(0.6+color.components[0]-0.3*color.components[1]-0.3*color.components[2], 0.6+color.components[1]-0.3*color.components[0]-0.3*color.components[2], 0.6+color.components[2]-0.3*color.components[0]-0.3*color.components[1]);
+			pushObjectPose(objects[i]);
+			glTranslated(0, 0, wheelRadius);
+			meshes[2].draw();
+			glPopMatrix();
+		}
+		meshes[2].release();
 		
 		glColor3d(1, 1, 1);
 		
 		// wheels
-		glPushMatrix();
-		glRotated((fmod(dw->leftOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
-		glCallList(lists[3]);
-		glPopMatrix();
-		
-		glPushMatrix();
-		glRotated((fmod(dw->rightOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
-		glCallList(lists[4]);
-		glPopMatrix();
+		for (int wheel = 0; wheel < 2; ++wheel)
+		{
+			meshes[3 + wheel].bind();
+			for (size_t i = 0; i < objects.size(); ++i)
+			{
+				const double odometry(wheel == 0 ? objects[i]->leftOdometry : objects[i]->rightOdometry);
+				pushObjectPose(objects[i]);
+				glTranslated(0, 0, wheelRadius);
+				glRotated((fmod(odometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
+				meshes[3 + wheel].draw();
+				glPopMatrix();
+			}
+			meshes[3 + wheel].release();
+		}
 		
 		// shadow
 		glBindTexture(GL_TEXTURE_2D, textures[1]);
@@ -111,45 +139,41 @@ namespace Enki
 		glBlendFunc(GL_ZERO, GL_SRC_COLOR);
 		
 		// bottom shadow
-		glPushMatrix();
 		// disable writing of z-buffer
 		glDepthMask( GL_FALSE );
-		//glTranslated(0, 0, -wheelRadius+0.01);
-		glTranslated(0, 0, -wheelRadius);
 		glEnable(GL_POLYGON_OFFSET_FILL);
-		glBegin(GL_QUADS);
-		glTexCoord2f(0.49f, 0.01f);
-		glVertex2f(-5.f, -5.f);
-		glTexCoord2f(0.49f, 0.49f);
-		glVertex2f(5.f, -5.f);
-		glTexCoord2f(0.01f, 0.49f);
-		glVertex2f(5.f, 5.f);
-		glTexCoord2f(0.01f, 0.01f);
-		glVertex2f(-5.f, 5.f);
-		glEnd();
+		meshes[5].bind();
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			pushObjectPose(objects[i]);
+			meshes[5].draw();
+			glPopMatrix();
+		}
+		meshes[5].release();
 		glDisable(GL_POLYGON_OFFSET_FILL);
 		glDepthMask( GL_TRUE );
-		glPopMatrix();
 		
 		// wheel shadow
-		glPushMatrix();
-		glScaled(radiosityScale, radiosityScale, radiosityScale);
-		glTranslated(0, -0.025, 0);
-		glCallList(lists[3]);
-		glPopMatrix();
-		
-		glPushMatrix();
-		glScaled(radiosityScale, radiosityScale, radiosityScale);
-		glTranslated(0, 0.025, 0);
-		glCallList(lists[4]);
-		glPopMatrix();
+		for (int wheel = 0; wheel < 2; ++wheel)
+		{
+			meshes[3 + wheel].bind();
+			for (size_t i = 0; i < objects.size(); ++i)
+			{
+				pushObjectPose(objects[i]);
+				glTranslated(0, 0, wheelRadius);
+				glScaled(radiosityScale, radiosityScale, radiosityScale);
+				glTranslated(0, wheel == 0 ? -0.025 : 0.025, 0);
+				meshes[3 + wheel].draw();
+				glPopMatrix();
+			}
+			meshes[3 + wheel].release();
+		}
 		
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 		glDisable(GL_BLEND);
 		glEnable(GL_LIGHTING);
 		
 		glDisable(GL_TEXTURE_2D);
-		glPopMatrix();
 	}
 	
 	void EPuckModel::drawSpecial(PhysicalObject* object, int param) const
@@ -157,7 +181,7 @@ namespace Enki
 		glEnable(GL_BLEND);
 		glBlendFunc(GL_ONE, GL_ONE);
 		glDisable(GL_TEXTURE_2D);
-		glCallList(lists[0]);
+		meshes[0].render();
 		glDisable(GL_BLEND);
 	}
 } // namespace Enki
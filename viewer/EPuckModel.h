@@ -44,6 +44,7 @@ namespace Enki
 		EPuckModel(ViewerWidget* viewer);
 		virtual void cleanup(ViewerWidget* viewer);
 		virtual void draw(PhysicalObject* object) const;
+		virtual void drawInstances(const Instances& objects) const;
 		virtual void drawSpecial(PhysicalObject* object, int param) const;
 	};
 } // namespace Enki
@@ -50,23 +50,26 @@ namespace Enki
 	{
 		textures.resize(1);
 		textures[0] = viewer->bindTexture(QPixmap(QString(":/textures/marxbot.png")), GL_TEXTURE_2D);
-		lists.resize(2);
-		lists[0] = GenMarxbotBase();
-		lists[1] = GenMarxbotWheel();
+		meshes.resize(2);
+		meshes[0] = GenMarxbotBase();
+		meshes[1] = GenMarxbotWheel();
 	}
 	
 	void MarxbotModel::cleanup(ViewerWidget* viewer)
 	{
 		for (int i = 0; i < textures.size(); i++)
 			viewer->deleteTexture(textures[i]);
-		for (int i = 0; i < lists.size(); i++)
-			glDeleteLists(lists[i], 1);
+		for (int i = 0; i < meshes.size(); i++)
+			meshes[i].destroy();
 	}
 	
 	void MarxbotModel::draw(PhysicalObject* object) const
 	{
-		DifferentialWheeled* dw = polymorphic_downcast<DifferentialWheeled*>(object);
-		
+		drawAsInstance(object);
+	}
+	
+	void MarxbotModel::drawInstances(const Instances& objects) const
+	{
 		const double wheelRadius = 2.9;
 		const double wheelCirc = 2 * M_PI * wheelRadius;
 		
@@ -76,100 +79,34 @@ namespace Enki
 		
 		
 		// body
-		glPushMatrix();
-		glCallList(lists[0]);
-		glPopMatrix();
+		meshes[0].bind();
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			pushObjectPose(objects[i]);
+			meshes[0].draw();
+			glPopMatrix();
+		}
+		meshes[0].release();
 		
 		// wheels
-		glPushMatrix();
-		glTranslatef(0,0,wheelRadius);
-			glPushMatrix();
-			glRotated((fmod(dw->rightOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
-			glCallList(lists[1]);
-			glPopMatrix();
-			glPushMatrix();
-			glRotated(180.f, 0, 0, 1);
-			glRotated((fmod(-dw->leftOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
-			glCallList(lists[1]);
+		meshes[1].bind();
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			pushObjectPose(objects[i]);
+			glTranslatef(0,0,wheelRadius);
+				glPushMatrix();
+				glRotated((fmod(objects[i]->rightOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
+				meshes[1].draw();
+				glPopMatrix();
+				glPushMatrix();
+				glRotated(180.f, 0, 0, 1);
+				glRotated((fmod(-objects[i]->leftOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
+				meshes[1].draw();
+				glPopMatrix();
 			glPopMatrix();
-		glPopMatrix();
+		}
+		meshes[1].release();
 		
 		glDisable(GL_TEXTURE_2D);
-		
-		
-		/*const double radiosityScale = 1.01;
-		
-		glTranslated(0, 0, wheelRadius);
-		glEnable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, textures[0]);
-		
-		glColor3d(1, 1, 1);
-		
-		glCallList(lists[0]);
-		
-		glCallList(lists[1]);
-		
-		//glColor3d(1-object->getColor().components[0], 1+object->getColor().components[1], 1+object->getColor().components[2]);
-		glColor3d(0.6+object->getColor().components[0]-0.3*object->getColor().components[1]-0.3*object->getColor().components[2], 0.6+object->getColor().components[1]-0.3*object->getColor().components[0]-0.3*object->getColor().components[2], 0.6+object->getColor().components[2]-0.3*object->getColor().components[0]-0.3*object->getColor().components[1]);
-		glCallList(lists[2]);
-		
-		glColor3d(1, 1, 1);
-		
-		// wheels
-		glPushMatrix();
-		glRotated((fmod(dw->leftOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
-		glCallList(lists[3]);
-		glPopMatrix();
-		
-		glPushMatrix();
-		glRotated((fmod(dw->rightOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
-		glCallList(lists[4]);
-		glPopMatrix();
-		
-		// shadow
-		glBindTexture(GL_TEXTURE_2D, textures[1]);
-		glDisable(GL_LIGHTING);
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_ZERO, GL_SRC_COLOR);
-		
-		// bottom shadow
-		glPushMatrix();
-		// disable writing of z-buffer
-		glDepthMask( GL_FALSE );
-		//glTranslated(0, 0, -wheelRadius+0.01);
-		glTranslated(0, 0, -wheelRadius);
-		glEnable(GL_POLYGON_OFFSET_FILL);
-		glBegin(GL_QUADS);
-		glTexCoord2f(0.49f, 0.01f);
-		glVertex2f(-5.f, -5.f);
-		glTexCoord2f(0.49f, 0.49f);
-		glVertex2f(5.f, -5.f);
-		glTexCoord2f(0.01f, 0.49f);
-		glVertex2f(5.f, 5.f);
-		glTexCoord2f(0.01f, 0.01f);
-		glVertex2f(-5.f, 5.f);
-		glEnd();
-		glDisable(GL_POLYGON_OFFSET_FILL);
-		glDepthMask( GL_TRUE );
-		glPopMatrix();
-		
-		// wheel shadow
-		glPushMatrix();
-		glScaled(radiosityScale, radiosityScale, radiosityScale);
-		glTranslated(0, -0.025, 0);
-		glCallList(lists[3]);
-		glPopMatrix();
-		
-		glPushMatrix();
-		glScaled(radiosityScale, radiosityScale, radiosityScale);
-		glTranslated(0, 0.025, 0);
-		glCallList(lists[4]);
-		glPopMatrix();
-		
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDisable(GL_BLEND);
-		glEnable(GL_LIGHTING);
-		
-		glDisable(GL_TEXTURE_2D);*/
 	}
 } // namespace Enki
\ No newline at end of file
@@ -44,6 +44,7 @@ namespace Enki
 		MarxbotModel(ViewerWidget* viewer);
 		virtual void cleanup(ViewerWidget* viewer);
 		virtual void draw(PhysicalObject* object) const;
+		virtual void drawInstances(const Instances& objects) const;
 	};
 } // namespace Enki
 
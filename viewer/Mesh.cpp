@@ -0,0 +1,131 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "Mesh.h"
+
+/*!	\file Mesh.cpp
+	\brief Implementation of a triangle mesh stored in a vertex buffer object
+*/
+
+namespace Enki
+{
+	//! Number of floats per vertex: normal, texture coordinates and position
+	static const int vertexSize = 8;
+	
+	Mesh::Mesh():
+		vertexCount(0)
+	{
+	}
+	
+	//! Add a vertex with its normal and texture coordinates, every three vertices form a triangle
+	void Mesh::addVertex(GLfloat nx, GLfloat ny, GLfloat nz, GLfloat s, GLfloat t, GLfloat x, GLfloat y, GLfloat z)
+	{
+		data << nx << ny << nz << s << t << x << y << z;
+		++vertexCount;
+	}
+	
+	//! Add a quad on the ground facing up, with corners (x0,y0), (x1,y0), (x1,y1), (x0,y1) having texCoords in this order
+	void Mesh::addGroundQuad(GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1, const GLfloat texCoords[4][2])
+	{
+		const GLfloat corners[4][2] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+		const int triangles[6] = { 0, 1, 2, 0, 2, 3 };
+		for (int i = 0; i < 6; ++i)
+		{
+			const int c(triangles[i]);
+			addVertex(0, 0, 1, texCoords[c][0], texCoords[c][1], corners[c][0], corners[c][1], 0);
+		}
+	}
+	
+	//! Copy the vertices to a vertex buffer object, must be called with the OpenGL context current
+	void Mesh::upload()
+	{
+		if (buffer.isCreated() || !buffer.create())
+			return;
+		buffer.bind();
+		buffer.setUsagePattern(QGLBuffer::StaticDraw);
+		buffer.allocate(data.constData(), data.size() * sizeof(GLfloat));
+		buffer.release();
+		data.clear();
+	}
+	
+	//! Delete the vertex buffer object and the vertices
+	void Mesh::destroy()
+	{
+		buffer.destroy();
+		data.clear();
+		vertexCount = 0;
+	}
+	
+	//! Setup the vertex arrays to use this mesh
+	void Mesh::bind() const
+	{
+		const GLsizei stride(vertexSize * sizeof(GLfloat));
+		const GLfloat* base(0);
+		if (buffer.isCreated())
+			buffer.bind();
+		else
+			base = data.constData();
+		
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glEnableClientState(GL_VERTEX_ARRAY);
+		glNormalPointer(GL_FLOAT, stride, base);
+		glTexCoordPointer(2, GL_FLOAT, stride, base + 3);
+		glVertexPointer(3, GL_FLOAT, stride, base + 5);
+	}
+	
+	//! Draw the triangles of this mesh with the current modelview matrix, bind() must have been called before
+	void Mesh::draw() const
+	{
+		glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+	}
+	
+	//! Disable the vertex arrays setup by bind()
+	void Mesh::release() const
+	{
+		glDisableClientState(GL_VERTEX_ARRAY);
+		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState(GL_NORMAL_ARRAY);
+		if (buffer.isCreated())
+			buffer.release();
+	}
+	
+	//! Draw a single instance of this mesh
+	void Mesh::render() const
+	{
+		bind();
+		draw();
+		release();
+	}
+} // namespace Enki
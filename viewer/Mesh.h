@@ -0,0 +1,75 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef __ENKI_VIEWER_MESH_H
+#define __ENKI_VIEWER_MESH_H
+
+#include <QGLBuffer>
+#include <QVector>
+
+/*!	\file Mesh.h
+	\brief Definition of a triangle mesh stored in a vertex buffer object
+*/
+
+namespace Enki
+{
+	//! A triangle mesh with normals and texture coordinates, stored in a vertex buffer object
+	/*!
+		The vertices are interleaved and drawn using glDrawArrays().
+		To draw several instances of the mesh, call bind() once, then draw() for every instance, and finally release().
+		If vertex buffer objects are not supported, the vertices are kept in client memory.
+	*/
+	class Mesh
+	{
+	public:
+		Mesh();
+		
+		void addVertex(GLfloat nx, GLfloat ny, GLfloat nz, GLfloat s, GLfloat t, GLfloat x, GLfloat y, GLfloat z);
+		void addGroundQuad(GLfloat x0, GLfloat y0, GLfloat x1, GLfloat y1, const GLfloat texCoords[4][2]);
+		void upload();
+		void destroy();
+		
+		void bind() const;
+		void draw() const;
+		void release() const;
+		void render() const;
+		
+	protected:
+		QVector<GLfloat> data; //!< interleaved normals, texture coordinates and positions, cleared once uploaded
+		mutable QGLBuffer buffer; //!< vertex buffer object, if created
+		int vertexCount; //!< number of vertices
+	};
+} // namespace Enki
+
+#endif // __ENKI_VIEWER_MESH_H
@@ -0,0 +1,174 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#include "SimulationThread.h"
+#include <enki/PhysicalEngine.h>
+#include <enki/robots/DifferentialWheeled.h>
+#include <enki/robots/thymio2/Thymio2.h>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+/*!	\file SimulationThread.cpp
+	\brief Implementation of the thread stepping a world independently of the viewer
+*/
+
+namespace Enki
+{
+	//! Copy the state of object
+	void ObjectState::capture(PhysicalObject* object)
+	{
+		this->object = object;
+		pos = object->pos;
+		angle = object->angle;
+		color = object->getColor();
+		
+		const DifferentialWheeled* dw(dynamic_cast<const DifferentialWheeled*>(object));
+		leftOdometry = dw ? dw->leftOdometry : 0;
+		rightOdometry = dw ? dw->rightOdometry : 0;
+		
+		const Thymio2* thymio(dynamic_cast<const Thymio2*>(object));
+		if (thymio)
+		{
+			ledColors.resize(Thymio2::LED_COUNT);
+			for (size_t i = 0; i < ledColors.size(); ++i)
+				ledColors[i] = thymio->getColorLed(Thymio2::LedIndex(i));
+		}
+		else
+			ledColors.clear();
+	}
+	
+	//! Copy the state of all objects of world, reusing the memory of the previous copy
+	void WorldState::capture(World* world)
+	{
+		objects.resize(world->objects.size());
+		size_t i(0);
+		for (World::ObjectsIterator it = world->objects.begin(); it != world->objects.end(); ++it, ++i)
+			objects[i].capture(*it);
+	}
+	
+	//! Return the state of object, or 0 if object was not in the world
+	const ObjectState* WorldState::find(const PhysicalObject* object) const
+	{
+		for (size_t i = 0; i < objects.size(); ++i)
+			if (objects[i].object == object)
+				return &objects[i];
+		return 0;
+	}
+	
+	WorldStateBuffer::WorldStateBuffer():
+		middle(1),
+		backIndex(0),
+		frontIndex(2)
+	{
+	}
+	
+	//! Return whether the reader has acquired the last published state, called by the writer
+	bool WorldStateBuffer::isConsumed() const
+	{
+		return (int(middle) & freshBit) == 0;
+	}
+	
+	//! Return the state to fill before calling publish(), called by the writer
+	WorldState& WorldStateBuffer::back()
+	{
+		return states[backIndex];
+	}
+	
+	//! Make the back state the latest one, called by the writer
+	void WorldStateBuffer::publish()
+	{
+		backIndex = middle.fetchAndStoreOrdered(backIndex | freshBit) & ~freshBit;
+	}
+	
+	//! Return the latest published state, valid until the next call, called by the reader
+	const WorldState& WorldStateBuffer::acquire()
+	{
+		// only the reader clears freshBit, so a fresh middle state cannot become stale before the exchange
+		if (int(middle) & freshBit)
+			frontIndex = middle.fetchAndStoreOrdered(frontIndex) & ~freshBit;
+		return states[frontIndex];
+	}
+	
+	SimulationThread::SimulationThread(World* world, double dt, unsigned physicsOversampling, double realTimeFactor):
+		world(world),
+		dt(dt),
+		physicsOversampling(physicsOversampling),
+		realTimeFactor(realTimeFactor),
+		stopRequested(0)
+	{
+	}
+	
+	//! Request the thread to stop after the current step, and wait until it has
+	void SimulationThread::stop()
+	{
+		stopRequested.fetchAndStoreOrdered(1);
+		wait();
+	}
+	
+	void SimulationThread::run()
+	{
+		// publish the initial state so that the viewer has something to draw
+		{
+			QMutexLocker locker(&worldMutex);
+			states.back().capture(world);
+			states.publish();
+		}
+		
+		QElapsedTimer timer;
+		timer.start();
+		unsigned long long stepCount(0);
+		while (!int(stopRequested))
+		{
+			{
+				QMutexLocker locker(&worldMutex);
+				world->step(dt, physicsOversampling);
+				// copying the state at every step would slow down fast runs, so only copy it once the viewer took the previous one
+				if (states.isConsumed())
+				{
+					states.back().capture(world);
+					states.publish();
+				}
+			}
+			++stepCount;
+			
+			// if running at a given speed, wait until real time catches up with simulated time
+			if (realTimeFactor > 0)
+			{
+				const qint64 aheadMs(qint64((double(stepCount) * dt * 1000.) / realTimeFactor) - timer.elapsed());
+				if (aheadMs > 0)
+					msleep(aheadMs);
+			}
+		}
+	}
+} // namespace Enki
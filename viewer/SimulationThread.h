@@ -0,0 +1,131 @@
+/*
+    Enki - a fast 2D robot simulator
+    Copyright (C) 1999-2016 Stephane Magnenat <stephane at magnenat dot net>
+    Copyright (C) 2004-2005 Markus Waibel <markus dot waibel at epfl dot ch>
+    Copyright (c) 2004-2005 Antoine Beyeler <abeyeler at ab-ware dot com>
+    Copyright (C) 2005-2006 Laboratory of Intelligent Systems, EPFL, Lausanne
+    Copyright (C) 2006-2008 Laboratory of Robotics Systems, EPFL, Lausanne
+    See AUTHORS for details
+
+    This program is free software; the authors of any publication 
+    arising from research using this software are asked to add the 
+    following reference:
+    Enki - a fast 2D robot simulator
+    http://home.gna.org/enki
+    Stephane Magnenat <stephane at magnenat dot net>,
+    Markus Waibel <markus dot waibel at epfl dot ch>
+    Laboratory of Intelligent Systems, EPFL, Lausanne.
+
+    You can redistribute this program and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+#ifndef __ENKI_VIEWER_SIMULATION_THREAD_H
+#define __ENKI_VIEWER_SIMULATION_THREAD_H
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <vector>
+
+#include <enki/Geometry.h>
+#include <enki/Types.h>
+
+/*!	\file SimulationThread.h
+	\brief Definition of the thread stepping a world independently of the viewer
+*/
+
+namespace Enki
+{
+	class World;
+	class PhysicalObject;
+	
+	//! The state of an object required to draw it, copied from the world between two steps
+	struct ObjectState
+	{
+		PhysicalObject* object; //!< the object, only its constant properties may be read while the simulation thread runs
+		Point pos; //!< position of the object
+		double angle; //!< orientation of the object
+		Color color; //!< color of the object
+		double leftOdometry; //!< odometry of the left wheel, for differential wheeled robots
+		double rightOdometry; //!< odometry of the right wheel, for differential wheeled robots
+		std::vector<Color> ledColors; //!< colors of the LEDs, for robots having LEDs
+		
+		void capture(PhysicalObject* object);
+	};
+	
+	//! The state of all objects of a world, as drawn by the viewer
+	struct WorldState
+	{
+		std::vector<ObjectState> objects; //!< states of the objects, in the order of the world
+		
+		void capture(World* world);
+		const ObjectState* find(const PhysicalObject* object) const;
+	};
+	
+	//! Hand-off of world states from a writer thread to a reader thread, without locks
+	/*!
+		Three states are used: the writer fills the back one while the reader draws the front one.
+		The middle one holds the latest published state, and is exchanged atomically, so that
+		none of the threads ever waits for the other one.
+	*/
+	class WorldStateBuffer
+	{
+	public:
+		WorldStateBuffer();
+		
+		bool isConsumed() const;
+		WorldState& back();
+		void publish();
+		const WorldState& acquire();
+		
+	protected:
+		static const int freshBit = 4; //!< set in middle when it holds a state not yet acquired by the reader
+		
+		WorldState states[3]; //!< the three states
+		QAtomicInt middle; //!< index of the middle state, with freshBit
+		int backIndex; //!< index of the state owned by the writer
+		int frontIndex; //!< index of the state owned by the reader
+	};
+	
+	//! A thread stepping a world as fast as possible, or at a given multiple of real time
+	/*!
+		The thread holds worldMutex while stepping; other threads must lock it to modify the world.
+		Objects must not be deleted while the thread runs, as the published states point to them.
+	*/
+	class SimulationThread : public QThread
+	{
+	public:
+		QMutex worldMutex; //!< lock held while stepping the world
+		WorldStateBuffer states; //!< states published for the viewer
+		
+	public:
+		SimulationThread(World* world, double dt, unsigned physicsOversampling, double realTimeFactor);
+		
+		void stop();
+		
+	protected:
+		virtual void run();
+		
+	protected:
+		World* world; //!< the world to step
+		const double dt; //!< time step, in seconds
+		const unsigned physicsOversampling; //!< physics oversampling passed to World::step()
+		const double realTimeFactor; //!< ratio of simulated time over real time, 0 to step as fast as possible
+		QAtomicInt stopRequested; //!< non-zero when the thread must stop
+	};
+} // namespace Enki
+
+#endif // __ENKI_VIEWER_SIMULATION_THREAD_H
@@ -59,9 +59,18 @@ namespace Enki
 		bodyDiffusionMap1 = QImage(QString(":/textures/thymio-body-diffusionMap1.png"));
 		bodyDiffusionMap2 = QImage(QString(":/textures/thymio-body-diffusionMap2.png"));
 
-		lists.resize(2);
-		lists[0] = GenThymio2Body();
-		lists[1] = GenThymio2Wheel();
+		meshes.resize(5);
+		meshes[0] = GenThymio2Body();
+		meshes[1] = GenThymio2Wheel();
+		const GLfloat shadowTexCoords[4][2] = { { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }, { 0.0f, 0.0f } };
+		meshes[2].addGroundQuad(-10.f, -10.f, 10.f, 10.f, shadowTexCoords);
+		meshes[2].upload();
+		const GLfloat bottomLeftTexCoords[4][2] = { { 0.01f, 0.01f }, { 0.01f, 0.99f }, { 0.99f, 0.99f }, { 0.99f, 0.01f } };
+		meshes[3].addGroundQuad(-5.f, -2.f, 7.f, 9.f, bottomLeftTexCoords);
+		meshes[3].upload();
+		const GLfloat bottomRightTexCoords[4][2] = { { 0.99f, 0.01f }, { 0.99f, 0.99f }, { 0.01f, 0.99f }, { 0.01f, 0.01f } };
+		meshes[4].addGroundQuad(-5.f, -9.f, 7.f, 2.f, bottomRightTexCoords);
+		meshes[4].upload();
 
 		textureDimension = bodyTexture.width();
 		Vector buttonCenter(0.136f,0.764f);
@@ -114,53 +123,73 @@ namespace Enki
 	{
 		for (int i = 0; i < textures.size(); i++)
 			viewer->deleteTexture(textures[i]);
-		for (int i = 0; i < lists.size(); i++)
-			glDeleteLists(lists[i], 1);
+		for (int i = 0; i < meshes.size(); i++)
+			meshes[i].destroy();
 	}
 
 	void Thymio2Model::draw(PhysicalObject* object) const
 	{
-		Thymio2* thymio = polymorphic_downcast<Thymio2*>(object);
-		if (thymio->ledTextureNeedUpdate)
+		drawAsInstance(object);
+	}
+
+	void Thymio2Model::drawInstances(const Instances& objects) const
+	{
+		// update the textures of robots whose LEDs have changed since their texture was generated
+		for (size_t i = 0; i < objects.size(); ++i)
 		{
-			viewer->deleteTexture(thymio->textureID);
-			thymio->ledTextureNeedUpdate = false;
-			thymio->textureID = updateLedTexture(thymio);
+			Thymio2* thymio = polymorphic_downcast<Thymio2*>(objects[i]->object);
+			if (thymio->textureID == 0 || thymio->ledTextureColors != objects[i]->ledColors)
+			{
+				viewer->deleteTexture(thymio->textureID);
+				thymio->textureID = updateLedTexture(thymio, objects[i]->ledColors);
+				thymio->ledTextureColors = objects[i]->ledColors;
+			}
 		}
 
 		const double wheelRadius = 2.1;
 		const double wheelCirc = 2 * M_PI * wheelRadius;
 
-		// body
+		// body, each robot having its own texture
 		glDisable(GL_LIGHTING);
 		glColor3d(1, 1, 1);
 		glEnable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, thymio->textureID);
 		
-		glPushMatrix();
-		glTranslatef(2.5,0,0);
-		glCallList(lists[0]);
-		glPopMatrix();
+		meshes[0].bind();
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			const Thymio2* thymio = static_cast<const Thymio2*>(objects[i]->object);
+			glBindTexture(GL_TEXTURE_2D, thymio->textureID);
+			pushObjectPose(objects[i]);
+			glTranslatef(2.5,0,0);
+			meshes[0].draw();
+			glPopMatrix();
+		}
+		meshes[0].release();
 
 		// wheels
 		glBindTexture(GL_TEXTURE_2D, textures[1]);
 
-		glPushMatrix();
-		glTranslatef(0,0,wheelRadius);
-		glRotated(180.f, 0, 0, 1);
-			glPushMatrix();
-			glTranslatef(0,4,0);
-			glRotated(-(fmod(thymio->rightOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
-			glCallList(lists[1]);
-			glPopMatrix();
-
-			glPushMatrix();
-			glTranslatef(0,-4,0);
+		meshes[1].bind();
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			pushObjectPose(objects[i]);
+			glTranslatef(0,0,wheelRadius);
 			glRotated(180.f, 0, 0, 1);
-			glRotated(-(fmod(-thymio->leftOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
-			glCallList(lists[1]);
+				glPushMatrix();
+				glTranslatef(0,4,0);
+				glRotated(-(fmod(objects[i]->rightOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
+				meshes[1].draw();
+				glPopMatrix();
+
+				glPushMatrix();
+				glTranslatef(0,-4,0);
+				glRotated(180.f, 0, 0, 1);
+				glRotated(-(fmod(-objects[i]->leftOdometry, wheelCirc) * 360) / wheelCirc, 0, 1, 0);
+				meshes[1].draw();
+				glPopMatrix();
 			glPopMatrix();
-		glPopMatrix();
+		}
+		meshes[1].release();
 		
 		// shadow
 		glBindTexture(GL_TEXTURE_2D, textures[2]);
@@ -169,52 +198,38 @@ namespace Enki
 		glBlendFunc(GL_ZERO, GL_SRC_COLOR);
 		
 		// bottom shadow
-		glPushMatrix();
 		// disable writing of z-buffer
 		glDepthMask( GL_FALSE );
 		glEnable(GL_POLYGON_OFFSET_FILL);
-		glBegin(GL_QUADS);
-		glTexCoord2f(1.0f, 0.0f);
-		glVertex2f(-10.f, -10.f);
-		glTexCoord2f(1.0f, 1.0f);
-		glVertex2f(10.f, -10.f);
-		glTexCoord2f(0.0f, 1.0f);
-		glVertex2f(10.f, 10.f);
-		glTexCoord2f(0.0f, 0.0f);
-		glVertex2f(-10.f, 10.f);
-		glEnd();
-		
-		glPopMatrix();
+		meshes[2].bind();
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			pushObjectPose(objects[i]);
+			meshes[2].draw();
+			glPopMatrix();
+		}
+		meshes[2].release();
 		
 		// bottom lighting
 		glBindTexture(GL_TEXTURE_2D, textures[0]);
 		glBlendFunc(GL_SRC_COLOR, GL_ONE);
 		//glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		if (thymio->getColorLed(Thymio2::BOTTOM_LEFT).a() != 0.0)
+		for (int led = 0; led < 2; ++led)
 		{
-			const Color color = thymio->getColorLed(Thymio2::BOTTOM_LEFT) * 0.6;
-			glColor4d(color.r(),color.g(),color.b(),color.a());
-
-			glBegin (GL_QUADS);
-				glNormal3f (0,0,1);
-				glTexCoord2f(0.01f,0.01f); glVertex3f(-5, -2,0);
-				glTexCoord2f(0.01f,0.99f); glVertex3f(7, -2,0);
-				glTexCoord2f(0.99f,0.99f); glVertex3f(7, 9,0);
-				glTexCoord2f(0.99f,0.01f); glVertex3f(-5, 9,0);
-			glEnd();
-		}
-		if (thymio->getColorLed(Thymio2::BOTTOM_RIGHT).a() != 0.0)
-		{
-			const Color color = thymio->getColorLed(Thymio2::BOTTOM_RIGHT) * 0.6;
-			glColor4d(color.r(),color.g(),color.b(),color.a());
-
-			glBegin (GL_QUADS);
-				glNormal3f (0,0,1);
-				glTexCoord2f(0.99f,0.01f); glVertex3f(-5,-9,0);
-				glTexCoord2f(0.99f,0.99f); glVertex3f(7,-9,0);
-				glTexCoord2f(0.01f,0.99f); glVertex3f(7, 2,0);
-				glTexCoord2f(0.01f,0.01f); glVertex3f(-5, 2,0);
-			glEnd();
+			const Thymio2::LedIndex ledIndex(led == 0 ? Thymio2::BOTTOM_LEFT : Thymio2::BOTTOM_RIGHT);
+			meshes[3 + led].bind();
+			for (size_t i = 0; i < objects.size(); ++i)
+			{
+				const Color& ledColor(objects[i]->ledColors[ledIndex]);
+				if (ledColor.a() == 0.0)
+					continue;
+				const Color color = ledColor * 0.6;
+				glColor4d(color.r(),color.g(),color.b(),color.a());
+				pushObjectPose(objects[i]);
+				meshes[3 + led].draw();
+				glPopMatrix();
+			}
+			meshes[3 + led].release();
 		}
 		glDisable(GL_POLYGON_OFFSET_FILL);
 		glDepthMask( GL_TRUE );
@@ -226,7 +241,7 @@ namespace Enki
 		glDisable(GL_TEXTURE_2D);
 	}
 
-	unsigned Thymio2Model::updateLedTexture(Thymio2* thymio) const
+	unsigned Thymio2Model::updateLedTexture(Thymio2* thymio, const std::vector<Color>& ledColors) const
 	{
 		if (!thymio->ledTexture)
 		{
@@ -249,7 +264,7 @@ namespace Enki
 		{
 			for (unsigned j=0;j<ledCenter[i].size();j++)
 			{
-				const Color ledColor = thymio->getColorLed((Thymio2::LedIndex)i);
+				const Color& ledColor(ledColors[i]);
 				switch(i)
 				{
 					case Thymio2::TOP:
@@ -45,6 +45,7 @@ namespace Enki
 		Thymio2Model(ViewerWidget* viewer);
 		virtual void cleanup(ViewerWidget* viewer);
 		virtual void draw(PhysicalObject* object) const;
+		virtual void drawInstances(const Instances& objects) const;
 
 		unsigned textureDimension;
 		QImage bodyDiffusionMap0, bodyDiffusionMap1, bodyDiffusionMap2, bodyTexture;
@@ -55,7 +56,7 @@ namespace Enki
 
 		ViewerWidget* viewer;
 
-		unsigned updateLedTexture(Thymio2* thymio) const;
+		unsigned updateLedTexture(Thymio2* thymio, const std::vector<Color>& ledColors) const;
 		void drawRect(uint32_t* target, uint32_t* base, const Vector& center, const Vector& size, const Color& color, uint32_t* diffTex) const;
 	};
 } // namespace Enki
@@ -48,6 +48,7 @@
 	#endif // GL_BGRA
 #endif // Q_OS_WIN
 #include <QApplication>
+#include <QMutexLocker>
 #include <QtGui>
 
 /*!	\file Viewer.cpp
@@ -88,8 +89,18 @@ namespace Enki
 		
 		virtual void draw(PhysicalObject* object) const
 		{
-			glColor3d(object->getColor().components[0], object->getColor().components[1], object->getColor().components[2]);
-			glCallList(list);
+			drawAsInstance(object);
+		}
+		
+		virtual void drawInstances(const Instances& objects) const
+		{
+			for (size_t i = 0; i < objects.size(); ++i)
+			{
+				pushObjectPose(objects[i]);
+				glColor3d(objects[i]->color.components[0], objects[i]->color.components[1], objects[i]->color.components[2]);
+				glCallList(list);
+				glPopMatrix();
+			}
 		}
 		
 		virtual ~SimpleDisplayList()
@@ -103,6 +114,37 @@ namespace Enki
 		deletedWithObject = false;
 	}
 	
+	//! Draw objects sharing this user data, with the world matrix; by default, call draw() for every object in its local frame
+	void ViewerWidget::ViewerUserData::drawInstances(const Instances& objects) const
+	{
+		for (size_t i = 0; i < objects.size(); ++i)
+		{
+			pushObjectPose(objects[i]);
+			draw(objects[i]->object);
+			glPopMatrix();
+		}
+	}
+	
+	//! Push the modelview matrix and move it to the pose of an object
+	void ViewerWidget::ViewerUserData::pushObjectPose(const ObjectState* state)
+	{
+		glPushMatrix();
+		glTranslated(state->pos.x, state->pos.y, 0);
+		glRotated(rad2deg * state->angle, 0, 0, 1);
+	}
+	
+	//! Draw a single object in its local frame through drawInstances(), for user data implementing draw() with it; as this reads the object, hold the world mutex while the simulation thread runs
+	void ViewerWidget::ViewerUserData::drawAsInstance(PhysicalObject* object) const
+	{
+		ObjectState state;
+		state.capture(object);
+		glPushMatrix();
+		glRotated(rad2deg * -state.angle, 0, 0, 1);
+		glTranslated(-state.pos.x, -state.pos.y, 0);
+		drawInstances(Instances(1, &state));
+		glPopMatrix();
+	}
+	
 	//! Create a camera at 0
 	ViewerWidget::CameraPose::CameraPose():
 		altitude(0),
@@ -206,6 +248,8 @@ namespace Enki
 		initTexturesResources();
 		pointedObject = 0;
 		selectedObject = 0;
+		simulationThread = 0;
+		worldState = 0;
 		movingObject = false;
 		elapsedTime = double(30)/1000.; // average second between two frame, can be updated each frame to better precision
 		showHelp();
@@ -215,6 +259,7 @@ namespace Enki
 	
 	ViewerWidget::~ViewerWidget()
 	{
+		stopSimulationThread();
 		world->disconnectExternalObjectsUserData();
 		if (isValid())
 		{
@@ -290,6 +335,35 @@ namespace Enki
 		objectExtendedAttributesList[object].movableByPicking = movable;
 	}
 
+	/*!
+		\brief Step the world in a separate thread, instead of in the timer of the viewer.
+		The world is stepped by dt seconds as fast as possible if realTimeFactor is 0, or realTimeFactor times faster than real time otherwise.
+		The viewer then draws the latest state published by the thread, so that a slow frame does not slow down the simulation.
+		While the thread runs, the world must only be modified while holding getWorldMutex(), and objects must not be deleted.
+	*/
+	void ViewerWidget::startSimulationThread(double dt, unsigned physicsOversampling, double realTimeFactor)
+	{
+		stopSimulationThread();
+		simulationThread = new SimulationThread(world, dt, physicsOversampling, realTimeFactor);
+		simulationThread->start();
+	}
+	
+	//! Stop the simulation thread if any, the world is then stepped again in the timer of the viewer
+	void ViewerWidget::stopSimulationThread()
+	{
+		if (!simulationThread)
+			return;
+		simulationThread->stop();
+		worldState = 0;
+		delete simulationThread;
+		simulationThread = 0;
+	}
+	
+	bool ViewerWidget::isSimulationThreadRunning() const
+	{
+		return simulationThread != 0;
+	}
+	
 	void ViewerWidget::setCamera(const QPointF& pos, double altitude, double yaw, double pitch)
 	{
 		camera.pos = pos;
@@ -760,6 +834,9 @@ namespace Enki
 	
 	void ViewerWidget::renderSimpleObject(PhysicalObject *object)
 	{
+		// the shape and color of the object are read from the world, which the simulation thread might be stepping
+		QMutexLocker locker(getWorldMutex());
+		
 		SimpleDisplayList *userData = new SimpleDisplayList;
 		object->userData = userData;
 		glNewList(userData->list, GL_COMPILE);
@@ -813,7 +890,7 @@ namespace Enki
 		}
 	}
 	
-	//! Called when object is displayed, after the display list, with the current world matrix
+	//! Called when object is displayed, after all objects have been drawn, with the matrix of the object
 	void ViewerWidget::displayObjectHook(PhysicalObject *object)
 	{
 	
@@ -906,13 +983,16 @@ namespace Enki
 		glLightfv(GL_LIGHT0, GL_POSITION, LightPosition);
 		
 		glCallList(worldList);
-		for (World::ObjectsIterator it = world->objects.begin(); it != world->objects.end(); ++it)
+		for (size_t i = 0; i < worldState->objects.size(); ++i)
 		{
+			const ObjectState* state(&worldState->objects[i]);
+			PhysicalObject* object(state->object);
+			
 			// if required, initialize this object (display list)
-			if (!(*it)->userData)
+			if (!object->userData)
 			{
 				bool found = false;
-				const std::type_info* typeToSearch = &typeid(**it);
+				const std::type_info* typeToSearch = &typeid(*object);
 				
 				// search the alias map
 				ManagedObjectsAliasesMapIterator aliasIt(managedObjectsAliases);
@@ -933,45 +1013,78 @@ namespace Enki
 					dataIt.next();
 					if (*dataIt.key() == (*typeToSearch))
 					{
-						(*it)->userData = dataIt.value();
+						object->userData = dataIt.value();
 						found = true;
 						break;
 					}
 				}
 				
 				if (!found)
-					renderSimpleObject(*it);
+					renderSimpleObject(object);
 			}
 			
-			// draw object
+			// group objects by user data, so that objects of the same type are drawn together
+			ViewerUserData* userData = polymorphic_downcast<ViewerUserData *>(object->userData);
+			instances[userData].push_back(state);
+		}
+		
+		// draw objects, forgetting user data not used in the previous frame, as they might have been deleted
+		for (InstancesMap::iterator it = instances.begin(); it != instances.end();)
+		{
+			if (it->second.empty())
+			{
+				instances.erase(it++);
+			}
+			else
+			{
+				it->first->drawInstances(it->second);
+				it->second.clear();
+				++it;
+			}
+		}
+		
+		// let subclasses display additional information
+		for (size_t i = 0; i < worldState->objects.size(); ++i)
+		{
+			const ObjectState& state(worldState->objects[i]);
+			
 			glPushMatrix();
 			
-			glTranslated((*it)->pos.x, (*it)->pos.y, 0);
-			glRotated(rad2deg * (*it)->angle, 0, 0, 1);
+			glTranslated(state.pos.x, state.pos.y, 0);
+			glRotated(rad2deg * state.angle, 0, 0, 1);
 			
-			ViewerUserData* userData = polymorphic_downcast<ViewerUserData *>((*it)->userData);
-
-			userData->draw(*it);
-			displayObjectHook(*it);
+			displayObjectHook(state.object);
 			
 			glPopMatrix();
 		}
 
-		// if an object is selected
-		if (selectedObject)
+		// if an object is selected, take its pose from the drawn state, unless it is being moved and thus removed from the world
+		ObjectState movingState;
+		const ObjectState* selectedState(0);
+		if (selectedObject && movingObject)
+		{
+			// the object is moved while holding the world mutex, so copy its state with it
+			{
+				QMutexLocker locker(getWorldMutex());
+				movingState.capture(selectedObject);
+			}
+			selectedState = &movingState;
+			
+			// draw the object as it has not been drawn before
+			ViewerUserData* userData = polymorphic_downcast<ViewerUserData *>(selectedObject->userData);
+			userData->drawInstances(ViewerUserData::Instances(1, selectedState));
+		}
+		else if (selectedObject)
+			selectedState = worldState->find(selectedObject);
+		if (selectedState)
 		{
 			glPushMatrix();
 			
-			glTranslated(selectedObject->pos.x, selectedObject->pos.y, 0);
-			glRotated(rad2deg * selectedObject->angle, 0, 0, 1);
+			glTranslated(selectedState->pos.x, selectedState->pos.y, 0);
+			glRotated(rad2deg * selectedState->angle, 0, 0, 1);
 			
-			// if it is being move, draw the object as it has not been drawn before
 			if (movingObject)
-			{
-				ViewerUserData* userData = polymorphic_downcast<ViewerUserData *>(selectedObject->userData);
-				userData->draw(selectedObject);
 				displayObjectHook(selectedObject);
-			}
 			
 			// draw the selection circle
 			glEnable(GL_BLEND);
@@ -1033,18 +1146,24 @@ namespace Enki
 		// prepare to find which object is pointed
 		Point cursor2Dpoint(pointedPoint.x(),pointedPoint.y());
 		const double cursorRadius = 0.05f;
-		for (World::ObjectsIterator it = world->objects.begin(); it != world->objects.end(); ++it)
+		for (size_t i = 0; i < worldState->objects.size(); ++i)
 		{
-			const Vector distOCtoOC = (*it)->pos - cursor2Dpoint;		// distance between object bounding circle center and pointed point
-			const double addedRay = (*it)->getRadius() + cursorRadius;	// sum of bounded circle radius
+			const ObjectState& state(worldState->objects[i]);
+			PhysicalObject* object(state.object);
+			const Vector distOCtoOC = state.pos - cursor2Dpoint;		// distance between object bounding circle center and pointed point
+			const double addedRay = object->getRadius() + cursorRadius;	// sum of bounded circle radius
 			if (distOCtoOC.norm2() <= (addedRay*addedRay)) 			// cursor point colide bounding circle
 			{
-				if (!(*it)->getHull().empty())				// check pointer circle and bject hull
+				if (!object->getHull().empty())				// check pointer circle and bject hull
 				{
-					PhysicalObject::Hull hull = (*it)->getHull();
+					const PhysicalObject::Hull& hull = object->getHull();
+					const Matrix22 rot(state.angle);
 					for (PhysicalObject::Hull::const_iterator it2 = hull.begin(); it2 != hull.end(); ++it2) // check all convex shape of hull
 					{
-						const Polygone shape = it2->getTransformedShape();
+						// transform the shape with the drawn pose, as the object might have moved since
+						Polygone shape;
+						for (size_t j = 0; j < it2->getShape().size(); ++j)
+							shape.push_back(rot * it2->getShape()[j] + state.pos);
 						unsigned int inside = 0;
 
 						// standard test : if circularObject is inside a convex shape
@@ -1060,13 +1179,13 @@ namespace Enki
 						}
 						if (inside == shape.size()) // inside of hull
 						{
-							pointedObject = *it;
+							pointedObject = object;
 							break;
 						}
 					}
 				}
 				else	// object circle collide cursor circle => test already done !
-					pointedObject = *it;
+					pointedObject = object;
 			}
 		}
 	}
@@ -1179,10 +1298,20 @@ namespace Enki
 	void ViewerWidget::paintGL()
 	{
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		
+		// get the state of the world to draw, either the latest published by the simulation thread or a copy of the current one
+		if (simulationThread)
+			worldState = &simulationThread->states.acquire();
+		else
+		{
+			capturedWorldState.capture(world);
+			worldState = &capturedWorldState;
+		}
 
 		const double znear = 0.5;
-		if (trackingView && selectedObject)
-			camera.updateTracking(selectedObject->angle, QVector3D(selectedObject->pos.x, selectedObject->pos.y, selectedObject->getHeight()), znear);
+		const ObjectState* trackedState(trackingView && selectedObject ? worldState->find(selectedObject) : 0);
+		if (trackedState)
+			camera.updateTracking(trackedState->angle, QVector3D(trackedState->pos.x, trackedState->pos.y, selectedObject->getHeight()), znear);
 		else
 			camera.update();
 
@@ -1250,12 +1379,15 @@ namespace Enki
 
 		// if pointed object is a robot call the clicked interaction function
 		Robot* robot = dynamic_cast<Robot*>(pointedObject);
+		QMutexLocker locker(getWorldMutex());
 		if (robot)
 			robot->clickedInteraction(true, getButtonCode(event), pointedPoint.x(), pointedPoint.y(), pointedPoint.z());
 	}
 	
 	void ViewerWidget::mouseReleaseEvent(QMouseEvent * event)
 	{
+		QMutexLocker locker(getWorldMutex());
+		
 		// enable physics calculation for selected object
 		if (selectedObject)
 		{
@@ -1274,6 +1406,7 @@ namespace Enki
 		if (!trackingView && selectedObject)
 		{
 			// object movements
+			QMutexLocker locker(getWorldMutex());
 			
 			// rotate
 			if (event->buttons() & Qt::RightButton)
@@ -1373,7 +1506,8 @@ namespace Enki
 	
 	void ViewerWidget::timerEvent(QTimerEvent * event)
  	{
-		world->step(double(timerPeriodMs)/1000., 3);
+		if (!simulationThread)
+			world->step(double(timerPeriodMs)/1000., 3);
 		updateGL();
  	}
 
@@ -1391,4 +1525,10 @@ namespace Enki
 			buttonCode |= PhysicalObject::MIDDLE_MOUSE_BUTTON;
 		return buttonCode;
 	}
+	
+	//! Return the mutex to hold while modifying the world, or 0 if there is no simulation thread
+	QMutex* ViewerWidget::getWorldMutex() const
+	{
+		return simulationThread ? &simulationThread->worldMutex : 0;
+	}
 }
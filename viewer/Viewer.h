@@ -41,10 +41,15 @@
 #include <QMap>
 #include <QVector3D>
 #include <QUrl>
+#include <vector>
+#include <map>
 
 #include <enki/Geometry.h>
 #include <enki/PhysicalEngine.h>
 
+#include "Mesh.h"
+#include "SimulationThread.h"
+
 /*!	\file Viewer.h
 	\brief Definition of the Qt-based viewer widget
 */
@@ -67,11 +72,20 @@ namespace Enki
 		
 		class ViewerUserData : public PhysicalObject::UserData
 		{
+		public:
+			//! States of the objects sharing this user data, drawn together
+			typedef std::vector<const ObjectState*> Instances;
+			
 		public:
 			virtual void draw(PhysicalObject* object) const = 0;
+			virtual void drawInstances(const Instances& objects) const;
 			virtual void drawSpecial(PhysicalObject* object, int param = 0) const { }
 			// for data managed by the viewer, called upon viewer destructor
 			virtual void cleanup(ViewerWidget* viewer) { }
+			
+		protected:
+			static void pushObjectPose(const ObjectState* state);
+			void drawAsInstance(PhysicalObject* object) const;
 		};
 		
 		// complex robot, one per robot type stored here
@@ -79,6 +93,7 @@ namespace Enki
 		{
 		public:
 			QVector<GLuint> lists;
+			QVector<Mesh> meshes;
 			QVector<GLuint> textures;
 		
 		public:
@@ -145,6 +160,11 @@ namespace Enki
 		typedef QMap<const std::type_info*, const std::type_info*> ManagedObjectsAliasesMap;
 		typedef QMapIterator<const std::type_info*, const std::type_info*> ManagedObjectsAliasesMapIterator;
 		ManagedObjectsAliasesMap managedObjectsAliases;
+		SimulationThread* simulationThread; //!< thread stepping the world, if any
+		WorldState capturedWorldState; //!< state of the world copied at every frame, when not using a simulation thread
+		const WorldState* worldState; //!< state of the world being drawn
+		typedef std::map<ViewerUserData*, ViewerUserData::Instances> InstancesMap;
+		InstancesMap instances; //!< objects to draw in the current frame, grouped by user data
 		
 		struct InfoMessage
 		{
@@ -196,6 +216,11 @@ namespace Enki
 		
 		void setMovableByPicking(PhysicalObject* object, bool movable = true);
 		void removeExtendedAttributes(PhysicalObject* object);
+		
+		void startSimulationThread(double dt = 0.03, unsigned physicsOversampling = 3, double realTimeFactor = 1);
+		void stopSimulationThread();
+		bool isSimulationThreadRunning() const;
+		QMutex* getWorldMutex() const;
 
 	public slots:
 		void setCamera(const QPointF& pos, double altitude, double yaw, double pitch);
@@ -34,7 +34,7 @@
 
 // E-puck object file
 
-#include <QtOpenGL>
+#include "Objects.h"
 
 namespace Enki
 {
@@ -1791,35 +1791,28 @@ namespace Enki
 	{0.518065f,0.638945f},{0.510841f,0.646169f},{0.521519f,0.643447f},
 	{0.512672f,0.648555f},{0.523691f,0.648689f},{0.513823f,0.651333f}
 	};
-	GLint GenEPuckRest()
+	Mesh GenEPuckRest()
 	{
-	unsigned i;
-	unsigned j;
+	Mesh mesh;
 	
-	GLint lid=glGenLists(1);
-	glNewList(lid, GL_COMPILE);
-	
-		glBegin (GL_TRIANGLES);
-		for(i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
+		for(unsigned i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
 		{
-		for(j=0;j<3;j++)
+		for(unsigned j=0;j<3;j++)
 			{
 			int vi=face_indicies[i][j];
 			int ni=face_indicies[i][j+3];//Normal index
 			int ti=face_indicies[i][j+6];//Texture index
-			/*glNormal3f (normals[ni][0],normals[ni][1],normals[ni][2]);
-			glTexCoord2f(textures[ti][0],textures[ti][1]);
-			glVertex3f (vertices[vi][0],vertices[vi][1],vertices[vi][2]);*/
 			
 			// rotate 90 deg around z
-			glNormal3f (normals[ni][1],-normals[ni][0],normals[ni][2]);
-			glTexCoord2f(textures[ti][0],textures[ti][1]);
-			glVertex3f (vertices[vi][1],-vertices[vi][0],vertices[vi][2]);
+			mesh.addVertex(
+				normals[ni][1],-normals[ni][0],normals[ni][2],
+				textures[ti][0],textures[ti][1],
+				vertices[vi][1],-vertices[vi][0],vertices[vi][2]
+			);
 			}
 		}
-		glEnd ();
 	
-	glEndList();
-	return lid;
+	mesh.upload();
+	return mesh;
 	};
 }
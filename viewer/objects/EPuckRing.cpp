@@ -34,7 +34,7 @@
 
 // E-puck object file
 
-#include <QtOpenGL>
+#include "Objects.h"
 #define BYTE unsigned char
 
 namespace Enki
@@ -399,34 +399,28 @@ namespace Enki
 	{0.346647f,0.699725f},{0.325035f,0.699725f},{0.303423f,0.699725f},
 	{0.000859129f,0.700337f}
 	};
-	GLint GenEPuckRing()
+	Mesh GenEPuckRing()
 	{
-	unsigned i;
-	unsigned j;
+	Mesh mesh;
 	
-	GLint lid=glGenLists(1);
-	glNewList(lid, GL_COMPILE);
-		glBegin (GL_TRIANGLES);
-		for(i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
+		for(unsigned i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
 		{
-		for(j=0;j<3;j++)
+		for(unsigned j=0;j<3;j++)
 			{
 			int vi=face_indicies[i][j];
 			int ni=face_indicies[i][j+3];//Normal index
 			int ti=face_indicies[i][j+6];//Texture index
-			/*glNormal3f (normals[ni][0],normals[ni][1],normals[ni][2]);
-			glTexCoord2f(textures[ti][0],textures[ti][1]);
-			glVertex3f (vertices[vi][0],vertices[vi][1],vertices[vi][2]);*/
 			
 			// rotate 90 deg around z
-			glNormal3f (normals[ni][1],-normals[ni][0],normals[ni][2]);
-			glTexCoord2f(textures[ti][0],textures[ti][1]);
-			glVertex3f (vertices[vi][1],-vertices[vi][0],vertices[vi][2]);
+			mesh.addVertex(
+				normals[ni][1],-normals[ni][0],normals[ni][2],
+				textures[ti][0],textures[ti][1],
+				vertices[vi][1],-vertices[vi][0],vertices[vi][2]
+			);
 			}
 		}
-		glEnd ();
 	
-	glEndList();
-	return lid;
+	mesh.upload();
+	return mesh;
 	};
 }
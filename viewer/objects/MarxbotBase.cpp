@@ -34,7 +34,7 @@
 
 // Marxbot base
 
-#include <QtOpenGL>
+#include "Objects.h"
 
 namespace Enki
 {
@@ -2837,34 +2837,28 @@ namespace Enki
 	{0.853009f,0.639955f},{0.907781f,0.647428f},{0.853221f,0.60998f},
 	{0.843346f,0.600135f},{0.898905f,0.609506f},{0.908345f,0.599745f}
 	};
-	GLint GenMarxbotBase()
+	Mesh GenMarxbotBase()
 	{
-	unsigned i;
-	unsigned j;
-
-	GLint lid=glGenLists(1);
-	glNewList(lid, GL_COMPILE);
-
-		glBegin (GL_TRIANGLES);
-		for(i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
+	Mesh mesh;
+	
+		for(unsigned i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
 		{
-		for(j=0;j<3;j++)
+		for(unsigned j=0;j<3;j++)
 			{
 			int vi=face_indicies[i][j];
 			int ni=face_indicies[i][j+3];//Normal index
 			int ti=face_indicies[i][j+6];//Texture index
-			/*glNormal3f (normals[ni][0],normals[ni][1],normals[ni][2]);
-			glTexCoord2f(textures[ti][0],textures[ti][1]);
-			glVertex3f (vertices[vi][0],vertices[vi][1],vertices[vi][2]);*/
+			
 			// rotate 90 deg around z
-			glNormal3f (normals[ni][1],-normals[ni][0],normals[ni][2]);
-			glTexCoord2f(textures[ti][0],textures[ti][1]);
-			glVertex3f (vertices[vi][1],-vertices[vi][0],vertices[vi][2]);
+			mesh.addVertex(
+				normals[ni][1],-normals[ni][0],normals[ni][2],
+				textures[ti][0],textures[ti][1],
+				vertices[vi][1],-vertices[vi][0],vertices[vi][2]
+			);
 			}
 		}
-		glEnd ();
-
-	glEndList();
-	return lid;
+	
+	mesh.upload();
+	return mesh;
 	};
 }
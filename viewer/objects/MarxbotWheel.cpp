@@ -34,7 +34,7 @@
 
 // Marxbot wheel
 
-#include <QtOpenGL>
+#include "Objects.h"
 
 namespace Enki
 {
@@ -825,34 +825,28 @@ namespace Enki
 	{0.794404f,0.360201f},{0.804341f,0.361741f},{0.814367f,0.360885f},
 	{0.824184f,0.358436f},{0.805938f,0.310263f},{0.60673f,0.048133f}
 	};
-	GLint GenMarxbotWheel()
+	Mesh GenMarxbotWheel()
 	{
-	unsigned i;
-	unsigned j;
-
-	GLint lid=glGenLists(1);
-	glNewList(lid, GL_COMPILE);
-
-		glBegin (GL_TRIANGLES);
-		for(i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
+	Mesh mesh;
+	
+		for(unsigned i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
 		{
-		for(j=0;j<3;j++)
+		for(unsigned j=0;j<3;j++)
 			{
 			int vi=face_indicies[i][j];
 			int ni=face_indicies[i][j+3];//Normal index
 			int ti=face_indicies[i][j+6];//Texture index
-			/*glNormal3f (normals[ni][0],normals[ni][1],normals[ni][2]);
-			glTexCoord2f(textures[ti][0],textures[ti][1]);
-			glVertex3f (vertices[vi][0],vertices[vi][1],vertices[vi][2]);*/
+			
 			// rotate 90 deg around z
-			glNormal3f (normals[ni][1],-normals[ni][0],normals[ni][2]);
-			glTexCoord2f(textures[ti][0],textures[ti][1]);
-			glVertex3f (vertices[vi][1],-vertices[vi][0],vertices[vi][2]);
+			mesh.addVertex(
+				normals[ni][1],-normals[ni][0],normals[ni][2],
+				textures[ti][0],textures[ti][1],
+				vertices[vi][1],-vertices[vi][0],vertices[vi][2]
+			);
 			}
 		}
-		glEnd ();
-
-	glEndList();
-	return lid;
+	
+	mesh.upload();
+	return mesh;
 	};
 }
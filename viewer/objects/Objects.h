@@ -36,21 +36,21 @@
 #ifndef __ENKI_VIEWER_OBJECTS_H
 #define __ENKI_VIEWER_OBJECTS_H
 
-#include <QtOpenGL>
+#include "../Mesh.h"
 
 namespace Enki
 {
-	GLint GenEPuckBody();
-	GLint GenEPuckRest();
-	GLint GenEPuckRing();
-	GLint GenEPuckWheelLeft();
-	GLint GenEPuckWheelRight();
+	Mesh GenEPuckBody();
+	Mesh GenEPuckRest();
+	Mesh GenEPuckRing();
+	Mesh GenEPuckWheelLeft();
+	Mesh GenEPuckWheelRight();
 	
-	GLint GenMarxbotBase();
-	GLint GenMarxbotWheel();
+	Mesh GenMarxbotBase();
+	Mesh GenMarxbotWheel();
 
-	GLint GenThymio2Body();
-	GLint GenThymio2Wheel();
+	Mesh GenThymio2Body();
+	Mesh GenThymio2Wheel();
 }
 
 #endif
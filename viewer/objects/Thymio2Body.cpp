@@ -34,7 +34,7 @@
 
 // Thymio2 body
 
-#include <QtOpenGL>
+#include "Objects.h"
 #include <iostream>
 
 namespace Enki
@@ -475,28 +475,27 @@ namespace Enki
 {0.4964,0.0406},{0.6511,0.9575},{0.4690,0.0277},{0.4692,0.0413},{0.1426,0.9432},{0.3601,0.9582},{0.8198,0.0896},{0.8229,0.0822},{0.8229,0.0971},
 	};
 
-	GLint GenThymio2Body()
+	Mesh GenThymio2Body()
 	{
-		GLint lid=glGenLists(1);
-		glNewList(lid, GL_COMPILE);
+		Mesh mesh;
 
-			glBegin (GL_TRIANGLES);
-			for(unsigned int i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
+		for(unsigned int i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
+		{
+			for(unsigned int j=0;j<3;j++)
 			{
-				for(unsigned int j=0;j<3;j++)
-				{
-					unsigned int vi = face_indicies[i][3*j]   - 1;
-					unsigned int ti = face_indicies[i][3*j+1] - 1;
-					unsigned int ni = face_indicies[i][3*j+2] - 1;
+				unsigned int vi = face_indicies[i][3*j]   - 1;
+				unsigned int ti = face_indicies[i][3*j+1] - 1;
+				unsigned int ni = face_indicies[i][3*j+2] - 1;
 
-					glNormal3f (normals[ni][0],normals[ni][1],normals[ni][2]);
-					glTexCoord2f(textures[ti][0],textures[ti][1]);
-					glVertex3f(vertices[vi][0],vertices[vi][1],vertices[vi][2]);
-				}
+				mesh.addVertex(
+					normals[ni][0],normals[ni][1],normals[ni][2],
+					textures[ti][0],textures[ti][1],
+					vertices[vi][0],vertices[vi][1],vertices[vi][2]
+				);
 			}
-			glEnd ();
+		}
 
-		glEndList();
-		return lid;
+		mesh.upload();
+		return mesh;
 	};
 }
@@ -34,7 +34,7 @@
 
 // Marxbot wheel
 
-#include <QtOpenGL>
+#include "Objects.h"
 
 namespace Enki
 {
@@ -278,28 +278,27 @@ namespace Enki
 {0.5868,0.6682},{0.6303,0.6388},{0.6619,0.5983},{0.6785,0.5507},{0.6785,0.5006},{0.6619,0.4530},{0.6304,0.4125},{0.5870,0.3831},{0.5359,0.3676}
 	};
 
-	GLint GenThymio2Wheel()
+	Mesh GenThymio2Wheel()
 	{
-		GLint lid=glGenLists(1);
-		glNewList(lid, GL_COMPILE);
+		Mesh mesh;
 
-			glBegin (GL_TRIANGLES);
-			for(unsigned int i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
+		for(unsigned int i=0;i<sizeof(face_indicies)/sizeof(face_indicies[0]);i++)
+		{
+			for(unsigned int j=0;j<3;j++)
 			{
-				for(unsigned int j=0;j<3;j++)
-				{
-					unsigned int vi = face_indicies[i][3*j]   - 1;
-					unsigned int ti = face_indicies[i][3*j+1] - 1;
-					unsigned int ni = face_indicies[i][3*j+2] - 1;
+				unsigned int vi = face_indicies[i][3*j]   - 1;
+				unsigned int ti = face_indicies[i][3*j+1] - 1;
+				unsigned int ni = face_indicies[i][3*j+2] - 1;
 
-					glNormal3f (normals[ni][0],normals[ni][1],normals[ni][2]);
-					glTexCoord2f(textures[ti][0],textures[ti][1]);
-					glVertex3f(vertices[vi][0],vertices[vi][1],vertices[vi][2]);
-				}
+				mesh.addVertex(
+					normals[ni][0],normals[ni][1],normals[ni][2],
+					textures[ti][0],textures[ti][1],
+					vertices[vi][0],vertices[vi][1],vertices[vi][2]
+				);
 			}
-			glEnd ();
+		}
 
-		glEndList();
-		return lid;
+		mesh.upload();
+		return mesh;
 	};
 }